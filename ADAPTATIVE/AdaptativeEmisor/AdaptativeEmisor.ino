@@ -4,6 +4,7 @@
 
 #include "AdaptiveTXWSN.h" // Tu librería
 #include "DataPayload.h"   // La estructura de datos que creamos
+#include "ACMeterWSN.h"    // True-RMS sincronizado a cruces por cero
 
 // --- PINES HARDWARE (Según tu esquema) ---
 const int PIN_XBEE_RX = 2;
@@ -19,6 +20,7 @@ SoftwareSerial xbeeSerial(PIN_XBEE_RX, PIN_XBEE_TX); // RX, TX
 RTC_DS3231 rtc;
 AdaptiveTXWSN adaptiveTX;
 DataPayload payload;
+ACMeterWSN medidor;
 
 // --- CONFIGURACIÓN DE TRANSMISIÓN ADAPTATIVA ---
 // ¡Ajústalos a tus necesidades!
@@ -56,6 +58,16 @@ void setup() {
                    PERIODO_ALTO_MS, PERIODO_MEDIO_MS, PERIODO_BAJO_MS);
   
   Serial.println("Configuracion de transmision adaptativa lista.");
+
+  // 3. Medidor AC (ventana de 2 ciclos alineada a cruces por cero)
+  //    ¡¡¡IMPORTANTE: CALIBRA escalaV / escalaI (V y A por cuenta ADC)!!! El offset DC lo sigue la librería.
+  ACMeterWSN::Cfg configAc;
+  configAc.pinV    = PIN_SENSOR_VOLTAJE;
+  configAc.pinI    = PIN_SENSOR_CORRIENTE;
+  configAc.ciclos  = 2;
+  configAc.escalaV = 0.25f;                   // ¡¡AJUSTA ESTE VALOR!!
+  configAc.escalaI = (5.0f / 1024.0f) / 0.185f; // ACS712-05B
+  medidor.begin(configAc);
 }
 
 void loop() {
@@ -80,9 +92,11 @@ void collectSensorData() {
   DateTime now = rtc.now();
   
   payload.unixTime = now.unixtime();
-  payload.voltageAC = readACVoltage();
-  payload.currentAC = readACCurrent();
-  payload.powerApparent = payload.voltageAC * payload.currentAC;
+  ACMeterWSN::Resultado ac = {};
+  medidor.measure(ac);
+  payload.voltageAC = ac.vrms_V;
+  payload.currentAC = ac.irms_A;
+  payload.powerApparent = ac.potenciaAparente_VA;
   payload.batteryVoltage = adaptiveTX.lastVolts(); // La librería ya midió el voltaje
   payload.energyLevel = (uint8_t)adaptiveTX.level();
 }
@@ -92,22 +106,3 @@ void sendData() {
   xbeeSerial.write((uint8_t*)&payload, sizeof(payload));
   Serial.println("Paquete de datos enviado por XBee.");
 }
-
-// =================================================================
-// ===           ¡¡¡IMPORTANTE: NECESITAS CALIBRAR ESTO!!!         ===
-// =================================================================
-float readACVoltage() {
-  // Esta función es un EJEMPLO. Debes calibrarla.
-  int rawValue = analogRead(PIN_SENSOR_VOLTAJE);
-  float factorCalibracion = 0.25; // ¡¡AJUSTA ESTE VALOR!!
-  return rawValue * factorCalibracion;
-}
-
-float readACCurrent() {
-  // Esta función es un EJEMPLO para el ACS712. Debes calibrarla.
-  int rawValue = analogRead(PIN_SENSOR_CORRIENTE);
-  int offset = 512; // ¡¡AJUSTA ESTE VALOR!! (Debería ser la lectura con 0A)
-  float sensitivity = 0.185; // (V/A) para el ACS712-05B.
-  float voltage = (rawValue - offset) * (5.0 / 1024.0);
-  return voltage / sensitivity;
-}
\ No newline at end of file
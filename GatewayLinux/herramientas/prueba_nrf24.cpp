@@ -0,0 +1,143 @@
+/*
+ * Prueba de extremo a extremo de wsn_gateway_nrf24 compilado con GATEWAY_NRF24_SIMULADO:
+ * arranca el gateway con el tráfico del nRF24 simulado (por entorno), espera a que el
+ * aire se calle y el gateway deje de recibir, y compara lo que el modelo entregó al FIFO
+ * con lo que salió por la tubería. Reporta interrupciones, el histograma de paquetes por
+ * vaciado del FIFO y el CPU del gateway.
+ *
+ *   prueba_nrf24 <ruta/wsn_gateway_nrf24> [paquetes_por_s=2000] [segundos=10]
+ *                [rafaga=1] [velocidad=2m] [dir_datos=/tmp/wsn-prueba-nrf24]
+ *
+ * Sale con 0 si cada paquete entregado por el "aire" llegó como frame y se almacenó.
+ */
+#include "ServidorEstadisticas.h"
+
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+double ahora_s() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// "nrf24_vaciados a b c d": valorEstadistica solo da el primero
+void vaciados(const std::string& texto, unsigned long long v[4]) {
+  memset(v, 0, 4 * sizeof(v[0]));
+  const std::string t = "\n" + texto;
+  size_t i = t.find("\nnrf24_vaciados ");
+  if (i == std::string::npos) return;
+  const char* p = t.c_str() + i + strlen("\nnrf24_vaciados ");
+  for (int k = 0; k < 4; ++k) {
+    char* fin;
+    v[k] = strtoull(p, &fin, 10);
+    p = fin;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "uso: %s ruta/wsn_gateway_nrf24 [paquetes_por_s=2000] [segundos=10]"
+                    " [rafaga=1] [velocidad=2m] [dir_datos=/tmp/wsn-prueba-nrf24]\n", argv[0]);
+    return 2;
+  }
+  const char*       gateway   = argv[1];
+  const std::string tasa      = argc > 2 ? argv[2] : "2000";
+  const std::string segundos  = argc > 3 ? argv[3] : "10";
+  const std::string rafaga    = argc > 4 ? argv[4] : "1";
+  const std::string velocidad = argc > 5 ? argv[5] : "2m";
+  const std::string dir       = argc > 6 ? argv[6] : "/tmp/wsn-prueba-nrf24";
+  const std::string sock      = dir + "/gateway.sock";
+  mkdir(dir.c_str(), 0755);
+  signal(SIGPIPE, SIG_IGN);
+
+  setenv("NRF24_SIM_TASA", tasa.c_str(), 1);
+  setenv("NRF24_SIM_SEGUNDOS", segundos.c_str(), 1);
+  setenv("NRF24_SIM_RAFAGA", rafaga.c_str(), 1);
+
+  unlink(sock.c_str());
+  const double inicio = ahora_s();
+  pid_t hijo = fork();
+  if (hijo == 0) {
+    std::vector<std::string> args = { gateway, "-o", dir, "-s", sock, "-v", velocidad };
+    std::vector<char*> argv2;
+    for (size_t i = 0; i < args.size(); ++i) argv2.push_back(&args[i][0]);
+    argv2.push_back(nullptr);
+    execv(gateway, argv2.data());
+    perror(gateway);
+    _exit(127);
+  }
+
+  std::string estado;
+  for (int i = 0; i < 100 && !consultarEstadisticas(sock, estado); ++i) usleep(50000);
+  if (estado.empty()) {
+    fprintf(stderr, "el gateway no abrió %s\n", sock.c_str());
+    kill(hijo, SIGTERM);
+    return 1;
+  }
+  printf("%s paquetes/s durante %s s, ráfagas de %s, %s\n",
+         tasa.c_str(), segundos.c_str(), rafaga.c_str(), velocidad.c_str());
+
+  // Hasta que el aire termine y dos consultas seguidas den el mismo número de frames
+  const double limite = atof(segundos.c_str()) + 10.0;
+  unsigned long long anterior = ~0ULL;
+  while (ahora_s() - inicio < limite) {
+    usleep(200000);
+    if (!consultarEstadisticas(sock, estado)) continue;
+    const unsigned long long frames = valorEstadistica(estado, "nrf24_frames");
+    if (valorEstadistica(estado, "sim_activo") == 0 && frames == anterior) break;
+    anterior = frames;
+  }
+  const double duracion = ahora_s() - inicio;
+
+  kill(hijo, SIGTERM);
+  int st = 0;
+  waitpid(hijo, &st, 0);
+  struct rusage uso;
+  getrusage(RUSAGE_CHILDREN, &uso);
+  const double cpu = uso.ru_utime.tv_sec + uso.ru_utime.tv_usec / 1e6 +
+                     uso.ru_stime.tv_sec + uso.ru_stime.tv_usec / 1e6;
+
+  const unsigned long long generados  = valorEstadistica(estado, "sim_generados");
+  const unsigned long long entregados = valorEstadistica(estado, "sim_entregados");
+  const unsigned long long reintentos = valorEstadistica(estado, "sim_reintentos");
+  const unsigned long long perdidos   = valorEstadistica(estado, "sim_perdidos");
+  const unsigned long long irq        = valorEstadistica(estado, "nrf24_interrupciones");
+  const unsigned long long paquetes   = valorEstadistica(estado, "nrf24_paquetes");
+  const unsigned long long frames     = valorEstadistica(estado, "nrf24_frames");
+  const unsigned long long crc        = valorEstadistica(estado, "nrf24_errores_crc");
+  const unsigned long long invalidas  = valorEstadistica(estado, "nrf24_longitudes_invalidas");
+  const unsigned long long registros  = valorEstadistica(estado, "registros");
+  unsigned long long v[4];
+  vaciados(estado, v);
+
+  printf("aire: generados %llu, entregados %llu, reintentos %llu, perdidos %llu\n",
+         generados, entregados, reintentos, perdidos);
+  printf("gateway: interrupciones %llu, paquetes %llu, frames %llu, errores_crc %llu,"
+         " longitudes_invalidas %llu, registros %llu\n",
+         irq, paquetes, frames, crc, invalidas, registros);
+  printf("paquetes por vaciado: 0=%llu 1=%llu 2=%llu 3+=%llu (%.2f paquetes por interrupción)\n",
+         v[0], v[1], v[2], v[3], irq ? (double)paquetes / irq : 0.0);
+  printf("CPU del gateway: %.2f s (%.1f %% de un núcleo, %.2f us por paquete)\n",
+         cpu, 100.0 * cpu / duracion, paquetes ? cpu * 1e6 / paquetes : 0.0);
+
+  bool ok = entregados > 0 && paquetes == entregados && frames == entregados && crc == 0 &&
+            invalidas == 0 && registros == frames && WIFEXITED(st) && WEXITSTATUS(st) == 0;
+  printf("%s\n", ok ? "OK" : "FALLO");
+  return ok ? 0 : 1;
+}
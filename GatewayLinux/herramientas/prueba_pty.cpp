@@ -0,0 +1,222 @@
+/*
+ * Prueba de extremo a extremo sin radios: crea N pseudo-terminales, arranca wsn_gateway
+ * sobre sus lados esclavos y por el lado maestro inyecta frames WSN como lo haría un
+ * XBee en modo AT (80 % Packet v1, 15 % resúmenes, 5 % armónicos, más una fracción con
+ * un byte alterado). Al final compara lo enviado con el endpoint de estadísticas y con
+ * lo escrito en el almacén, y mide el CPU que gastó el gateway.
+ *
+ *   prueba_pty <ruta/wsn_gateway> [puertos=8] [frames_por_s_por_puerto=1000]
+ *              [segundos=10] [corruptos=0.01] [dir_datos=/tmp/wsn-prueba]
+ *
+ * Sale con 0 si no se perdió ni se inventó ningún frame.
+ */
+#include "ServidorEstadisticas.h"
+
+#include <CodecWSN.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Pty {
+  int         maestro = -1, esclavo = -1;
+  std::string ruta;
+  std::string pendiente;        // lo que el pty no aceptó aún (buffer lleno)
+  uint16_t    idPacket = 0, idResumen = 0;
+  uint64_t    enviados = 0, corruptos = 0, esperas = 0;
+};
+
+double ahora_s() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+bool crearPty(Pty& p) {
+  p.maestro = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (p.maestro < 0 || grantpt(p.maestro) != 0 || unlockpt(p.maestro) != 0) return false;
+  p.ruta = ptsname(p.maestro);
+  // El esclavo queda abierto aquí (crudo) para que el maestro no dé EIO antes de que
+  // el gateway lo abra, y para que la disciplina de línea no toque los bytes
+  p.esclavo = open(p.ruta.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+  if (p.esclavo < 0) return false;
+  struct termios t;
+  tcgetattr(p.esclavo, &t);
+  cfmakeraw(&t);
+  return tcsetattr(p.esclavo, TCSANOW, &t) == 0;
+}
+
+// Un frame con la mezcla de un coordinador real; 'corromper' altera un byte del payload
+size_t siguienteFrame(Pty& p, uint8_t* frame, bool corromper) {
+  size_t n;
+  int r = rand() % 100;
+  if (r < 80) {
+    Packet pk = { ++p.idPacket, (int16_t)(12700 + rand() % 600 - 300), (int16_t)(rand() % 1500),
+                  (uint16_t)(370 + rand() % 40) };
+    n = WSNFrame::encodeFrameFromPacket(frame, pk);
+  } else if (r < 95) {
+    PacketResumen s;
+    memset(&s, 0, sizeof(s));
+    s.id = ++p.idResumen;
+    s.duracion_s = 60;
+    s.muestras = 60;
+    s.vMin = 12500; s.vMax = 12900; s.vMedia = 12700;
+    s.iMin = 100;   s.iMax = 1400;  s.iMedia = 600;
+    s.energia_mWh = 1270;
+    n = WSNFrame::encodeFrameResumen(frame, s);
+  } else {
+    PacketArmonicos a;
+    memset(&a, 0, sizeof(a));
+    n = WSNFrame::encodeFrameArmonicos(frame, a);
+  }
+  if (corromper) frame[WSNFrame::HEADER_SIZE + 2] ^= 0x5A;   // cae en el payload: error de CRC
+  return n;
+}
+
+void vaciarPendiente(Pty& p) {
+  while (!p.pendiente.empty()) {
+    ssize_t k = write(p.maestro, p.pendiente.data(), p.pendiente.size());
+    if (k <= 0) {
+      if (k < 0 && errno == EAGAIN) ++p.esperas;
+      return;
+    }
+    p.pendiente.erase(0, (size_t)k);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "uso: %s ruta/wsn_gateway [puertos=8] [frames_por_s=1000] [segundos=10]"
+                    " [corruptos=0.01] [dir_datos=/tmp/wsn-prueba]\n", argv[0]);
+    return 2;
+  }
+  const char*  gateway   = argv[1];
+  const int    nPuertos  = argc > 2 ? atoi(argv[2]) : 8;
+  const double tasa      = argc > 3 ? atof(argv[3]) : 1000.0;
+  const double segundos  = argc > 4 ? atof(argv[4]) : 10.0;
+  const double corruptos = argc > 5 ? atof(argv[5]) : 0.01;
+  const std::string dir  = argc > 6 ? argv[6] : "/tmp/wsn-prueba";
+  const std::string sock = dir + "/gateway.sock";
+  mkdir(dir.c_str(), 0755);
+  srand(1);
+  signal(SIGPIPE, SIG_IGN);
+
+  std::vector<Pty> ptys((size_t)nPuertos);
+  for (size_t i = 0; i < ptys.size(); ++i) {
+    if (!crearPty(ptys[i])) { perror("pty"); return 1; }
+  }
+
+  // --- Gateway como proceso aparte, sobre los esclavos ---
+  unlink(sock.c_str());
+  pid_t hijo = fork();
+  if (hijo == 0) {
+    std::vector<std::string> args = { gateway, "-o", dir, "-s", sock, "-b", "115200" };
+    for (size_t i = 0; i < ptys.size(); ++i) args.push_back(ptys[i].ruta);
+    std::vector<char*> argv2;
+    for (size_t i = 0; i < args.size(); ++i) argv2.push_back(&args[i][0]);
+    argv2.push_back(nullptr);
+    execv(gateway, argv2.data());
+    perror(gateway);
+    _exit(127);
+  }
+
+  std::string estado;
+  for (int i = 0; i < 100 && !consultarEstadisticas(sock, estado); ++i) usleep(50000);
+  if (estado.empty()) {
+    fprintf(stderr, "el gateway no abrió %s\n", sock.c_str());
+    kill(hijo, SIGTERM);
+    return 1;
+  }
+
+  // --- Inyección a tasa fija por puerto ---
+  printf("%d puertos x %.0f frames/s durante %.0f s (%.1f %% corruptos)\n",
+         nPuertos, tasa, segundos, corruptos * 100);
+  const double inicio = ahora_s();
+  double t;
+  while ((t = ahora_s() - inicio) < segundos) {
+    const uint64_t debidos = (uint64_t)(t * tasa);
+    for (size_t i = 0; i < ptys.size(); ++i) {
+      Pty& p = ptys[i];
+      while (p.enviados < debidos && p.pendiente.size() < 4096) {
+        uint8_t frame[WSNFrame::MAX_FRAME_SIZE];
+        bool malo = (double)rand() / RAND_MAX < corruptos;
+        size_t n = siguienteFrame(p, frame, malo);
+        p.pendiente.append((const char*)frame, n);
+        ++p.enviados;
+        if (malo) ++p.corruptos;
+      }
+      vaciarPendiente(p);
+    }
+    usleep(1000);
+  }
+  for (int intento = 0; intento < 1000; ++intento) {
+    bool quedan = false;
+    for (size_t i = 0; i < ptys.size(); ++i) {
+      vaciarPendiente(ptys[i]);
+      quedan = quedan || !ptys[i].pendiente.empty();
+    }
+    if (!quedan) break;
+    usleep(1000);
+  }
+  const double duracion = ahora_s() - inicio;
+
+  uint64_t enviados = 0, malos = 0, esperas = 0;
+  for (size_t i = 0; i < ptys.size(); ++i) {
+    enviados += ptys[i].enviados;
+    malos    += ptys[i].corruptos;
+    esperas  += ptys[i].esperas;
+  }
+  const uint64_t esperados = enviados - malos;
+
+  // Espera a que el gateway termine de leer lo que queda en los ptys
+  uint64_t recibidos = 0;
+  for (int i = 0; i < 60; ++i) {
+    if (consultarEstadisticas(sock, estado)) recibidos = valorEstadistica(estado, "frames");
+    if (recibidos + valorEstadistica(estado, "errores_crc") >= enviados) break;
+    usleep(50000);
+  }
+
+  // SIGTERM vacía el almacén: registros_escritos se lee de la última consulta previa
+  kill(hijo, SIGTERM);
+  int st = 0;
+  waitpid(hijo, &st, 0);
+  struct rusage uso;
+  getrusage(RUSAGE_CHILDREN, &uso);
+  const double cpu = uso.ru_utime.tv_sec + uso.ru_utime.tv_usec / 1e6 +
+                     uso.ru_stime.tv_sec + uso.ru_stime.tv_usec / 1e6;
+
+  const uint64_t crc = valorEstadistica(estado, "errores_crc");
+  const uint64_t escritos = valorEstadistica(estado, "registros");
+  printf("enviados %" PRIu64 " (corruptos %" PRIu64 "), recibidos %" PRIu64
+         ", errores_crc %" PRIu64 ", registros %" PRIu64 "\n", enviados, malos, recibidos, crc, escritos);
+  printf("%.0f frames/s en total, pty lleno %" PRIu64 " veces\n", enviados / duracion, esperas);
+  printf("CPU del gateway: %.2f s (%.1f %% de un núcleo, %.2f us por frame)\n",
+         cpu, 100.0 * cpu / duracion, recibidos ? cpu * 1e6 / recibidos : 0.0);
+
+  for (size_t i = 0; i < ptys.size(); ++i) {
+    close(ptys[i].maestro);
+    close(ptys[i].esclavo);
+  }
+
+  bool ok = recibidos == esperados && crc == malos && escritos == recibidos &&
+            WIFEXITED(st) && WEXITSTATUS(st) == 0;
+  printf("%s\n", ok ? "OK" : "FALLO");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+/*
+ * Vuelca un archivo del almacén (.wts) como CSV, opcionalmente solo un rango de horas.
+ * El rango se ubica por bisección: los registros son de tamaño fijo y están en orden.
+ *
+ *   wsn_volcar wsn-20261019-06.wts [desde_unix_s [hasta_unix_s]]
+ */
+#include "AlmacenSerie.h"
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+bool leerRegistro(int fd, uint64_t k, Registro& r) {
+  uint8_t d[AlmacenSerie::TAM_REGISTRO];
+  off_t pos = (off_t)(AlmacenSerie::TAM_CABECERA + k * AlmacenSerie::TAM_REGISTRO);
+  return pread(fd, d, sizeof(d), pos) == (ssize_t)sizeof(d) && AlmacenSerie::deserializar(d, r);
+}
+
+// Primer registro con t_us >= t (o 'total' si no hay)
+uint64_t buscar(int fd, uint64_t total, int64_t t) {
+  uint64_t lo = 0, hi = total;
+  while (lo < hi) {
+    uint64_t medio = lo + (hi - lo) / 2;
+    Registro r;
+    if (leerRegistro(fd, medio, r) && r.t_us < t) lo = medio + 1;
+    else hi = medio;
+  }
+  return lo;
+}
+
+void imprimir(const Registro& r) {
+  printf("%" PRId64 ".%06" PRId64 ",%u,0x%02X,", r.t_us / 1000000, r.t_us % 1000000, r.fuente, r.tipo);
+  if (r.tipo == TIPO_PACKET_V1) {
+    Packet p = decodePacketFast(r.datos);
+    printf("id=%u v=%.2f i_mA=%d vbat=%.2f\n", p.id, p.voltaje / 100.0, p.corriente, p.vbat / 100.0);
+    return;
+  }
+  PacketResumen s;
+  if (r.tipo == REG_RESUMEN && decodeResumen(r.datos, r.longitud, s)) {
+    printf("id=%u duracion_s=%u muestras=%u vMedia=%.2f iMedia_mA=%d energia_mWh=%u\n",
+           s.id, s.duracion_s, s.muestras, s.vMedia / 100.0, s.iMedia, (unsigned)s.energia_mWh);
+    return;
+  }
+  for (uint8_t i = 0; i < r.longitud; ++i) printf("%02X", r.datos[i]);
+  printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "uso: %s archivo.wts [desde_unix_s [hasta_unix_s]]\n", argv[0]);
+    return 2;
+  }
+  int fd = open(argv[1], O_RDONLY | O_CLOEXEC);
+  uint8_t cabecera[AlmacenSerie::TAM_CABECERA];
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0 || read(fd, cabecera, sizeof(cabecera)) != (ssize_t)sizeof(cabecera) ||
+      !AlmacenSerie::cabeceraValida(cabecera)) {
+    fprintf(stderr, "%s: no es un archivo del almacén WSN\n", argv[1]);
+    return 1;
+  }
+
+  // Un registro a medias al final (corte de luz durante un write) se ignora
+  const uint64_t total = ((uint64_t)st.st_size - AlmacenSerie::TAM_CABECERA) / AlmacenSerie::TAM_REGISTRO;
+  uint64_t desde = 0, hasta = total;
+  if (argc > 2) desde = buscar(fd, total, strtoll(argv[2], nullptr, 10) * 1000000);
+  if (argc > 3) hasta = buscar(fd, total, strtoll(argv[3], nullptr, 10) * 1000000);
+
+  printf("t_unix,fuente,tipo,datos\n");
+  Registro r;
+  for (uint64_t k = desde; k < hasta && leerRegistro(fd, k, r); ++k) imprimir(r);
+  close(fd);
+  return 0;
+}
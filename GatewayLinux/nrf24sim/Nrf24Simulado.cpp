@@ -0,0 +1,313 @@
+#include "Nrf24Simulado.h"
+
+#include <CodecWSN.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// Registros y bits del datasheet (nRF24L01+ v1.0, sección 9)
+const uint8_t R_CONFIG = 0x00, R_EN_RXADDR = 0x02, R_SETUP_AW = 0x03, R_RF_SETUP = 0x06,
+              R_STATUS = 0x07, R_RX_ADDR_P0 = 0x0A, R_RX_ADDR_P1 = 0x0B, R_TX_ADDR = 0x10,
+              R_FIFO_STATUS = 0x17;
+const uint8_t PRIM_RX = 0x01, PWR_UP = 0x02, BANDERAS = 0x70, RX_DR = 0x40;
+const uint8_t CMD_R_RX_PL_WID = 0x60, CMD_R_RX_PAYLOAD = 0x61, CMD_FLUSH_TX = 0xE1,
+              CMD_FLUSH_RX = 0xE2;
+const size_t  PROFUNDIDAD_FIFO = 3;
+
+struct Paquete {
+  uint8_t pipe, longitud;
+  uint8_t datos[32];
+};
+
+double entorno(const char* nombre, double porDefecto) {
+  const char* v = getenv(nombre);
+  return v ? atof(v) : porDefecto;
+}
+
+}  // namespace
+
+struct Nrf24Simulado::Estado {
+  std::mutex              m;
+  std::condition_variable cvIrq;
+  uint8_t  reg[0x20];
+  uint8_t  direccion[3][5];             // RX_ADDR_P0, RX_ADDR_P1, TX_ADDR
+  std::deque<Paquete> rx;
+  size_t   tx = 0;                      // cargas de TX aceptadas (no se transmiten)
+  bool     ce = false, irqAnterior = false;
+
+  void   (*rutina)(void) = nullptr;
+  std::thread hiloIrq, hiloAire;
+  bool     detener = false;
+  uint32_t flancosPendientes = 0;
+
+  bool     traficoActivo = true;
+  uint64_t generados = 0, entregados = 0, reintentos = 0, perdidos = 0, sinEscucha = 0, flancos = 0;
+
+  Estado() {
+    memset(reg, 0, sizeof(reg));
+    reg[R_CONFIG]      = 0x08;
+    reg[0x01]          = 0x3F;          // EN_AA
+    reg[R_EN_RXADDR]   = 0x03;
+    reg[R_SETUP_AW]    = 0x03;
+    reg[0x04]          = 0x03;          // SETUP_RETR
+    reg[0x05]          = 0x02;          // RF_CH
+    reg[R_RF_SETUP]    = 0x0E;
+    for (int k = 0; k < 5; ++k) {
+      direccion[0][k] = direccion[2][k] = 0xE7;
+      direccion[1][k] = 0xC2;
+    }
+    reg[0x0C] = 0xC3; reg[0x0D] = 0xC4; reg[0x0E] = 0xC5; reg[0x0F] = 0xC6;
+  }
+
+  uint8_t status() const {
+    uint8_t pipe = rx.empty() ? 7 : rx.front().pipe;
+    return (uint8_t)((reg[R_STATUS] & BANDERAS) | (pipe << 1) | (tx >= PROFUNDIDAD_FIFO ? 1 : 0));
+  }
+
+  uint8_t fifoStatus() const {
+    return (uint8_t)((rx.empty() ? 0x01 : 0) | (rx.size() >= PROFUNDIDAD_FIFO ? 0x02 : 0) |
+                     (tx == 0 ? 0x10 : 0) | (tx >= PROFUNDIDAD_FIFO ? 0x20 : 0));
+  }
+
+  bool escuchando() const {
+    return ce && (reg[R_CONFIG] & PWR_UP) && (reg[R_CONFIG] & PRIM_RX);
+  }
+
+  int indiceDireccion(uint8_t r) const {
+    return r == R_RX_ADDR_P0 ? 0 : r == R_RX_ADDR_P1 ? 1 : r == R_TX_ADDR ? 2 : -1;
+  }
+
+  uint8_t leer(uint8_t r, size_t i) const {
+    int d = indiceDireccion(r);
+    if (d >= 0) return i < 5 ? direccion[d][i] : 0;
+    if (i > 0) return 0;
+    if (r == R_STATUS) return status();
+    if (r == R_FIFO_STATUS) return fifoStatus();
+    return reg[r];
+  }
+
+  void escribir(uint8_t r, const uint8_t* v, size_t n) {
+    if (n == 0) return;
+    int d = indiceDireccion(r);
+    if (d >= 0) {
+      for (size_t i = 0; i < n && i < 5; ++i) direccion[d][i] = v[i];
+      return;
+    }
+    if (r == R_STATUS) reg[R_STATUS] = (uint8_t)(reg[R_STATUS] & ~(v[0] & BANDERAS));   // 1 limpia
+    else if (r != R_FIFO_STATUS && r != 0x08 && r != 0x09) reg[r] = v[0];              // OBSERVE_TX, RPD: solo lectura
+  }
+
+  // Pin IRQ: activo si hay una bandera no enmascarada; solo el paso a activo es un flanco
+  void actualizarIrq() {
+    bool activo = (reg[R_STATUS] & BANDERAS & ~reg[R_CONFIG]) != 0;
+    if (activo && !irqAnterior) {
+      ++flancos;
+      ++flancosPendientes;
+      cvIrq.notify_one();
+    }
+    irqAnterior = activo;
+  }
+
+  // Tiempo en aire de un intento con su ACK, como Nrf24Backend::tiempoEnAire_us()
+  uint32_t intento_us(size_t longitud) const {
+    uint32_t bits = (uint32_t)((1 + 5 + 2 + longitud) * 8 + 9) + (1 + 5 + 2) * 8 + 9;
+    uint32_t t = (reg[R_RF_SETUP] & 0x20) ? bits * 4 : (reg[R_RF_SETUP] & 0x08) ? bits / 2 : bits;
+    return t + 2 * 130;                   // dos cambios TX/RX
+  }
+
+  void correrAire();
+};
+
+Nrf24Simulado& nrf24Simulado() {
+  static Nrf24Simulado chip;
+  return chip;
+}
+
+Nrf24Simulado::Nrf24Simulado() : _e(new Estado) {
+  _e->hiloAire = std::thread(&Estado::correrAire, _e);
+}
+
+Nrf24Simulado::~Nrf24Simulado() {
+  soltarIrq();
+  {
+    std::lock_guard<std::mutex> g(_e->m);
+    _e->detener = true;
+  }
+  if (_e->hiloAire.joinable()) _e->hiloAire.join();
+  delete _e;
+}
+
+void Nrf24Simulado::transaccion(const uint8_t* tx, uint8_t* rx, size_t n) {
+  if (n == 0) return;
+  std::lock_guard<std::mutex> g(_e->m);
+  Estado& e = *_e;
+  const uint8_t cmd = tx[0];
+  rx[0] = e.status();
+  for (size_t i = 1; i < n; ++i) rx[i] = 0;
+
+  if (cmd < 0x20) {
+    for (size_t i = 1; i < n; ++i) rx[i] = e.leer(cmd & 0x1F, i - 1);
+  } else if (cmd < 0x40) {
+    e.escribir(cmd & 0x1F, tx + 1, n - 1);
+  } else if (cmd == CMD_R_RX_PL_WID) {
+    if (n > 1) rx[1] = e.rx.empty() ? 0 : e.rx.front().longitud;
+  } else if (cmd == CMD_R_RX_PAYLOAD) {
+    if (!e.rx.empty()) {
+      const Paquete& p = e.rx.front();
+      for (size_t i = 1; i < n && i - 1 < p.longitud; ++i) rx[i] = p.datos[i - 1];
+      e.rx.pop_front();
+    }
+  } else if (cmd == CMD_FLUSH_RX) {
+    e.rx.clear();
+  } else if (cmd == CMD_FLUSH_TX) {
+    e.tx = 0;
+  } else if (cmd == 0xA0 || cmd == 0xB0 || (cmd >= 0xA8 && cmd <= 0xAD)) {
+    if (e.tx < PROFUNDIDAD_FIFO) ++e.tx;  // W_TX_PAYLOAD / W_ACK_PAYLOAD: se aceptan y no salen
+  }
+  e.actualizarIrq();
+}
+
+void Nrf24Simulado::ce(bool nivel) {
+  std::lock_guard<std::mutex> g(_e->m);
+  _e->ce = nivel;
+}
+
+bool Nrf24Simulado::irqActiva() {
+  std::lock_guard<std::mutex> g(_e->m);
+  return _e->irqAnterior;
+}
+
+void Nrf24Simulado::engancharIrq(void (*rutina)(void)) {
+  soltarIrq();
+  std::lock_guard<std::mutex> g(_e->m);
+  Estado& e = *_e;
+  e.rutina = rutina;
+  e.flancosPendientes = 0;               // como el gpiochip: los flancos anteriores no cuentan
+  e.hiloIrq = std::thread([&e]() {
+    std::unique_lock<std::mutex> l(e.m);
+    for (;;) {
+      e.cvIrq.wait(l, [&e] { return e.flancosPendientes > 0 || e.rutina == nullptr || e.detener; });
+      if (e.rutina == nullptr || e.detener) return;
+      --e.flancosPendientes;
+      void (*r)(void) = e.rutina;
+      l.unlock();
+      r();                               // la rutina hace SPI: sin el candado tomado
+      l.lock();
+    }
+  });
+}
+
+void Nrf24Simulado::soltarIrq() {
+  std::thread hilo;
+  {
+    std::lock_guard<std::mutex> g(_e->m);
+    _e->rutina = nullptr;
+    _e->cvIrq.notify_all();
+    hilo.swap(_e->hiloIrq);
+  }
+  if (hilo.joinable()) hilo.join();
+}
+
+void Nrf24Simulado::Estado::correrAire() {
+  const double   tasa     = entorno("NRF24_SIM_TASA", 200);
+  const double   segundos = entorno("NRF24_SIM_SEGUNDOS", 0);
+  const double   rafaga   = entorno("NRF24_SIM_RAFAGA", 1) >= 1 ? (uint32_t)entorno("NRF24_SIM_RAFAGA", 1) : 1;
+
+  typedef std::chrono::steady_clock Reloj;
+  Reloj::time_point inicio, proximo;
+  uint16_t idPacket[6] = { 0 }, idResumen[6] = { 0 };
+  uint8_t  siguientePipe = 0;
+  bool     enMarcha = false;
+  srand(7);
+
+  std::unique_lock<std::mutex> l(m);
+  while (!detener) {
+    // El tráfico arranca cuando el gateway empieza a escuchar
+    if (!enMarcha) {
+      if (!escuchando()) {
+        l.unlock();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        l.lock();
+        continue;
+      }
+      enMarcha = true;
+      inicio = proximo = Reloj::now();
+    }
+    if (segundos > 0 && Reloj::now() - inicio >= std::chrono::duration<double>(segundos)) break;
+
+    // Siguiente pipe habilitado (round-robin) y su frame
+    const uint8_t habilitados = reg[R_EN_RXADDR] & 0x3F;
+    if (!habilitados) { l.unlock(); std::this_thread::sleep_for(std::chrono::milliseconds(5)); l.lock(); continue; }
+    while (!(habilitados & (1 << siguientePipe))) siguientePipe = (uint8_t)((siguientePipe + 1) % 6);
+    Paquete p;
+    p.pipe = siguientePipe;
+    siguientePipe = (uint8_t)((siguientePipe + 1) % 6);
+    if (rand() % 100 < 85) {
+      Packet pk = { ++idPacket[p.pipe], (int16_t)(12700 + rand() % 600 - 300), (int16_t)(rand() % 1500),
+                    (uint16_t)(370 + rand() % 40) };
+      p.longitud = (uint8_t)WSNFrame::encodeFrameFromPacket(p.datos, pk);
+    } else {
+      PacketResumen s;
+      memset(&s, 0, sizeof(s));
+      s.id = ++idResumen[p.pipe];
+      s.duracion_s = 60;
+      s.muestras = 60;
+      s.vMedia = 12700;
+      s.iMedia = 600;
+      s.energia_mWh = 1270;
+      p.longitud = (uint8_t)WSNFrame::encodeFrameResumen(p.datos, s);
+    }
+    ++generados;
+
+    // Intentos con auto-ACK: el receptor no da ACK con el FIFO lleno
+    const uint32_t aire = intento_us(p.longitud);
+    bool entregado = false;
+    for (int intento = 0; intento <= 15 && !entregado && !detener; ++intento) {
+      if (!escuchando()) { ++sinEscucha; break; }
+      if (rx.size() < PROFUNDIDAD_FIFO) {
+        rx.push_back(p);
+        reg[R_STATUS] |= RX_DR;
+        actualizarIrq();
+        entregado = true;
+      } else {
+        ++reintentos;
+        l.unlock();
+        std::this_thread::sleep_for(std::chrono::microseconds(aire + 1500));   // ARD de setRetries(5, 15)
+        l.lock();
+      }
+    }
+    if (entregado) ++entregados;
+    else           ++perdidos;
+
+    // Espaciado: dentro de la ráfaga, seguidos; entre ráfagas, lo que pida la tasa media
+    const double periodo = (generados % (uint64_t)rafaga) ? aire / 1e6 : rafaga / tasa - (rafaga - 1) * aire / 1e6;
+    proximo += std::chrono::duration_cast<Reloj::duration>(
+        std::chrono::duration<double>(periodo > aire / 1e6 ? periodo : aire / 1e6));
+    l.unlock();
+    std::this_thread::sleep_until(proximo);
+    l.lock();
+  }
+  traficoActivo = false;
+}
+
+void Nrf24Simulado::reporte(std::string& salida) {
+  std::lock_guard<std::mutex> g(_e->m);
+  const Estado& e = *_e;
+  char linea[384];
+  snprintf(linea, sizeof(linea),
+           "sim_activo %d\nsim_generados %" PRIu64 "\nsim_entregados %" PRIu64 "\nsim_reintentos %" PRIu64
+           "\nsim_perdidos %" PRIu64 "\nsim_sin_escucha %" PRIu64 "\nsim_flancos %" PRIu64 "\n",
+           e.traficoActivo ? 1 : 0, e.generados, e.entregados, e.reintentos, e.perdidos,
+           e.sinEscucha, e.flancos);
+  salida += linea;
+}
@@ -0,0 +1,53 @@
+#ifndef GATEWAY_NRF24_SIMULADO_H
+#define GATEWAY_NRF24_SIMULADO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+/**
+ * nRF24L01+ simulado a nivel de registros, para correr wsn_gateway_nrf24 sin radio
+ * (cmake -DGATEWAY_NRF24_SIMULADO=ON). SpidevSimulado.cpp reemplaza spi.cpp, gpio.cpp e
+ * interrupt.cpp de RF24/utility/SPIDEV y manda cada transacción SPI, el pin CE y el pin
+ * IRQ a este modelo; RF24.cpp se compila sin cambios.
+ *
+ * Lo que se modela es lo que importa al gateway: mapa de registros con sus valores de
+ * reset, STATUS en el primer byte de cada transacción (RX_P_NO incluido), FIFO de RX de
+ * 3 entradas con carga dinámica, banderas que se limpian escribiendo 1, MASK_* de CONFIG
+ * y el pin IRQ con semántica de flanco: solo hay interrupción nueva cuando el pin pasa de
+ * inactivo a activo. No hay TX real ni ACK con carga (se aceptan y se descartan).
+ *
+ * Un hilo "aire" genera frames WSN (Packet v1 y resúmenes) en los pipes habilitados, con
+ * el tiempo en aire de la tasa configurada en RF_SETUP. Si el FIFO está lleno el nodo
+ * reintenta como el auto-ACK (hasta 15 veces) y después pierde el paquete. Se configura
+ * por entorno:
+ *   NRF24_SIM_TASA      paquetes/s en total (200)
+ *   NRF24_SIM_SEGUNDOS  duración del tráfico, 0 = sin fin (0)
+ *   NRF24_SIM_RAFAGA    paquetes seguidos por ráfaga, para llenar el FIFO (1)
+ */
+class Nrf24Simulado {
+public:
+  /* Lado SPI/GPIO */
+  void transaccion(const uint8_t* tx, uint8_t* rx, size_t n);
+  void ce(bool nivel);
+  bool irqActiva();                       // true = pin abajo
+
+  /* Lado interrupción: un hilo llama a la rutina en cada flanco de bajada */
+  void engancharIrq(void (*rutina)(void));
+  void soltarIrq();
+
+  void reporte(std::string& salida);
+
+  ~Nrf24Simulado();
+
+private:
+  friend Nrf24Simulado& nrf24Simulado();
+  Nrf24Simulado();
+
+  struct Estado;
+  Estado* _e;
+};
+
+Nrf24Simulado& nrf24Simulado();
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * Reemplazo de RF24/utility/SPIDEV/{spi,gpio,interrupt}.cpp con las mismas clases y
+ * funciones, pero contra Nrf24Simulado en vez de /dev/spidev y /dev/gpiochip.
+ * En Linux RF24 solo escribe el pin CE (CSN lo maneja spidev), así que GPIO::write es CE.
+ */
+#include "Nrf24Simulado.h"
+
+#include <spi.h>
+#include <gpio.h>
+#include <interrupt.h>
+
+#include <string.h>
+
+// ------------------------------------ SPI ------------------------------------
+
+SPI::SPI() : fd(-1), _spi_speed(RF24_SPI_SPEED) {}
+
+SPI::~SPI() {}
+
+void SPI::begin(int busNo, uint32_t spi_speed) {
+  static_cast<void>(busNo);
+  _spi_speed = spi_speed;
+  spiIsInitialized = true;
+}
+
+uint8_t SPI::transfer(uint8_t tx) {
+  uint8_t rx = 0;
+  nrf24Simulado().transaccion(&tx, &rx, 1);
+  return rx;
+}
+
+void SPI::transfernb(char* txBuf, char* rxBuf, uint32_t len) {
+  nrf24Simulado().transaccion(reinterpret_cast<const uint8_t*>(txBuf), reinterpret_cast<uint8_t*>(rxBuf), len);
+}
+
+void SPI::transfern(char* buf, uint32_t len) {
+  uint8_t rx[64];
+  if (len > sizeof(rx)) len = sizeof(rx);
+  nrf24Simulado().transaccion(reinterpret_cast<const uint8_t*>(buf), rx, len);
+  memcpy(buf, rx, len);
+}
+
+// ----------------------------------- GPIO ------------------------------------
+
+GPIO::GPIO() {}
+
+GPIO::~GPIO() {}
+
+void GPIO::open(rf24_gpio_pin_t port, int DDR) {
+  static_cast<void>(port);
+  static_cast<void>(DDR);
+}
+
+void GPIO::close(rf24_gpio_pin_t port) { static_cast<void>(port); }
+
+int GPIO::read(rf24_gpio_pin_t port) {
+  static_cast<void>(port);
+  return nrf24Simulado().irqActiva() ? 0 : 1;   // el único pin que se lee es IRQ, activo en bajo
+}
+
+void GPIO::write(rf24_gpio_pin_t port, int value) {
+  static_cast<void>(port);
+  nrf24Simulado().ce(value != 0);
+}
+
+// -------------------------------- Interrupción --------------------------------
+
+int attachInterrupt(rf24_gpio_pin_t pin, int mode, void (*function)(void)) {
+  static_cast<void>(pin);
+  static_cast<void>(mode);               // el modelo solo da flancos de bajada
+  nrf24Simulado().engancharIrq(function);
+  return 1;
+}
+
+int detachInterrupt(rf24_gpio_pin_t pin) {
+  static_cast<void>(pin);
+  nrf24Simulado().soltarIrq();
+  return 1;
+}
+
+void rfNoInterrupts() {}
+
+void rfInterrupts() {}
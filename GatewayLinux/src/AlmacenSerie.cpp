@@ -0,0 +1,117 @@
+#include "AlmacenSerie.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+const uint8_t MAGICO[5] = { 'W', 'S', 'N', 'T', 'S' };
+const uint8_t VERSION_ALMACEN = 1;
+const int64_t US_POR_HORA = 3600LL * 1000000LL;
+
+bool escribirTodo(int fd, const uint8_t* datos, size_t n) {
+  while (n > 0) {
+    ssize_t k = ::write(fd, datos, n);
+    if (k < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    datos += k;
+    n -= (size_t)k;
+  }
+  return true;
+}
+
+}  // namespace
+
+AlmacenSerie::AlmacenSerie(const std::string& directorio, size_t buffer)
+    : _directorio(directorio), _buffer(buffer < TAM_REGISTRO ? TAM_REGISTRO : buffer) {}
+
+AlmacenSerie::~AlmacenSerie() {
+  vaciar();
+  if (_fd >= 0) ::close(_fd);
+}
+
+void AlmacenSerie::serializar(const Registro& r, uint8_t* d) {
+  uint64_t t = (uint64_t)r.t_us;
+  for (int i = 0; i < 8; ++i) d[i] = (uint8_t)(t >> (8 * i));
+  d[8]  = (uint8_t)r.fuente;
+  d[9]  = (uint8_t)(r.fuente >> 8);
+  d[10] = r.tipo;
+  d[11] = r.longitud;
+  memcpy(d + 12, r.datos, MAX_DATOS_REGISTRO);
+}
+
+bool AlmacenSerie::deserializar(const uint8_t* d, Registro& r) {
+  uint64_t t = 0;
+  for (int i = 7; i >= 0; --i) t = (t << 8) | d[i];
+  r.t_us     = (int64_t)t;
+  r.fuente   = (uint16_t)(d[8] | (d[9] << 8));
+  r.tipo     = d[10];
+  r.longitud = d[11];
+  memcpy(r.datos, d + 12, MAX_DATOS_REGISTRO);
+  return r.longitud <= MAX_DATOS_REGISTRO;
+}
+
+bool AlmacenSerie::cabeceraValida(const uint8_t* c) {
+  return memcmp(c, MAGICO, sizeof(MAGICO)) == 0 && c[5] == VERSION_ALMACEN &&
+         (size_t)(c[6] | (c[7] << 8)) == TAM_REGISTRO;
+}
+
+bool AlmacenSerie::abrirPara(int64_t t_us) {
+  int64_t hora = t_us / US_POR_HORA;
+  if (_fd >= 0 && hora == _hora) return true;
+  if (!vaciar()) return false;
+  if (_fd >= 0) { ::close(_fd); _fd = -1; }
+
+  time_t seg = (time_t)(hora * 3600);
+  struct tm utc;
+  gmtime_r(&seg, &utc);
+  char nombre[32];
+  strftime(nombre, sizeof(nombre), "wsn-%Y%m%d-%H.wts", &utc);
+  _ruta = _directorio + "/" + nombre;
+
+  _fd = ::open(_ruta.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (_fd < 0) {
+    perror(_ruta.c_str());
+    ++_errores;
+    return false;
+  }
+  _hora = hora;
+
+  // Archivo nuevo: cabecera. Uno existente (reinicio dentro de la misma hora) se continúa
+  if (::lseek(_fd, 0, SEEK_END) == 0) {
+    uint8_t c[TAM_CABECERA];
+    memcpy(c, MAGICO, sizeof(MAGICO));
+    c[5] = VERSION_ALMACEN;
+    c[6] = (uint8_t)TAM_REGISTRO;
+    c[7] = (uint8_t)(TAM_REGISTRO >> 8);
+    if (!escribirTodo(_fd, c, sizeof(c))) { ++_errores; return false; }
+    _bytes += sizeof(c);
+  }
+  return true;
+}
+
+bool AlmacenSerie::escribir(const Registro& r) {
+  if (!abrirPara(r.t_us)) return false;
+  if (_usado + TAM_REGISTRO > _buffer.size() && !vaciar()) return false;
+  serializar(r, &_buffer[_usado]);
+  _usado += TAM_REGISTRO;
+  ++_escritos;
+  return true;
+}
+
+bool AlmacenSerie::vaciar() {
+  if (_usado == 0) return true;
+  if (_fd < 0 || !escribirTodo(_fd, &_buffer[0], _usado)) {
+    ++_errores;
+    _usado = 0;          // no se reintenta: el disco lleno no debe frenar la ingesta
+    return false;
+  }
+  _bytes += _usado;
+  _usado = 0;
+  return true;
+}
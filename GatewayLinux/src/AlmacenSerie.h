@@ -0,0 +1,52 @@
+#ifndef GATEWAY_ALMACEN_SERIE_H
+#define GATEWAY_ALMACEN_SERIE_H
+
+#include "Registro.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Almacén binario de series de tiempo: un archivo por hora (UTC),
+ *   <dir>/wsn-AAAAMMDD-HH.wts
+ * con una cabecera de 8 B ("WSNTS", versión 1, tamaño de registro u16 LE) y después
+ * registros fijos de 40 B en little-endian, en orden de llegada:
+ *
+ *   t_us i64 | fuente u16 | tipo u8 | longitud u8 | datos[28] (ceros tras 'longitud')
+ *
+ * Tamaño fijo: el registro k está en 8 + 40·k y se busca por hora con bisección.
+ * Escribe por bloques (un write() cada 64 KB o en cada vaciar()); lo que quede en el
+ * buffer al caer el proceso se pierde, el resto del archivo sigue siendo legible.
+ */
+class AlmacenSerie {
+public:
+  static const size_t TAM_CABECERA = 8;
+  static const size_t TAM_REGISTRO = 40;
+
+  explicit AlmacenSerie(const std::string& directorio, size_t buffer = 64 * 1024);
+  ~AlmacenSerie();
+
+  bool escribir(const Registro& r);
+  bool vaciar();                            // manda el buffer al archivo
+
+  uint64_t escritos() const       { return _escritos; }
+  uint64_t bytes() const          { return _bytes; }
+  uint64_t errores() const        { return _errores; }
+  const std::string& archivo() const { return _ruta; }
+
+  static void serializar(const Registro& r, uint8_t* destino);
+  static bool deserializar(const uint8_t* origen, Registro& r);
+  static bool cabeceraValida(const uint8_t* cabecera);
+
+private:
+  std::string          _directorio, _ruta;
+  std::vector<uint8_t> _buffer;
+  size_t   _usado = 0;
+  int      _fd = -1;
+  int64_t  _hora = -1;                      // hora UTC (µs / 3600 s) del archivo abierto
+  uint64_t _escritos = 0, _bytes = 0, _errores = 0;
+
+  bool abrirPara(int64_t t_us);
+};
+
+#endif
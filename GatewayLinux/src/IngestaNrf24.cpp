@@ -0,0 +1,47 @@
+#include "IngestaNrf24.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#if defined(GATEWAY_NRF24_SIMULADO)
+#include "Nrf24Simulado.h"
+#endif
+
+bool IngestaNrf24::iniciar(const RadioNrf24Linux::Cfg& cfg) {
+  return _radio.iniciar(cfg, &IngestaNrf24::recibir, this);
+}
+
+void IngestaNrf24::recibir(void* contexto, uint8_t pipe, const uint8_t* datos, uint8_t longitud) {
+  IngestaNrf24& yo = *static_cast<IngestaNrf24*>(contexto);
+  WSNFrame::Parser& p = yo._parsers[pipe];
+  const int64_t llegada = ahoraUtc_us();
+  yo._bytes += longitud;
+  for (uint8_t k = 0; k < longitud; ++k) {
+    const WSNFrame::Parser::State antes = p.st;
+    if (WSNFrame::feedFrame(p, datos[k])) {
+      ++yo._frames;
+      yo._tuberia.entregar(p, (uint16_t)(FUENTE_NRF24 + pipe), llegada);
+    } else if (antes == WSNFrame::Parser::READ_CRC_L) {
+      ++yo._erroresCrc;
+    } else if (antes == WSNFrame::Parser::FIND_SOF0 && datos[k] != WSNFrame::MARCADOR_INICIO_0) {
+      ++yo._descartados;                         // texto plano de un nodo viejo, relleno
+    }
+  }
+}
+
+void IngestaNrf24::reporte(std::string& salida) const {
+  char linea[512];
+  snprintf(linea, sizeof(linea),
+           "nrf24_interrupciones %" PRIu64 "\nnrf24_paquetes %" PRIu64 "\nnrf24_frames %" PRIu64
+           "\nnrf24_bytes %" PRIu64 "\nnrf24_errores_crc %" PRIu64 "\nnrf24_descartados %" PRIu64
+           "\nnrf24_longitudes_invalidas %" PRIu64
+           "\nnrf24_vaciados %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+           _radio.interrupciones.load(), _radio.paquetes.load(), _frames.load(), _bytes.load(),
+           _erroresCrc.load(), _descartados.load(), _radio.longitudesInvalidas.load(),
+           _radio.porVaciado[0].load(), _radio.porVaciado[1].load(),
+           _radio.porVaciado[2].load(), _radio.porVaciado[3].load());
+  salida += linea;
+#if defined(GATEWAY_NRF24_SIMULADO)
+  nrf24Simulado().reporte(salida);
+#endif
+}
@@ -0,0 +1,35 @@
+#ifndef GATEWAY_INGESTA_NRF24_H
+#define GATEWAY_INGESTA_NRF24_H
+
+#include "RadioNrf24Linux.h"
+#include "Tuberia.h"
+
+#include <atomic>
+#include <string>
+
+/**
+ * Ingesta del coordinador nRF24: cada paquete que saca RadioNrf24Linux pasa por el
+ * WSNFrame::Parser de su pipe (un frame de hasta 32 B cabe en un paquete, pero el parser
+ * por pipe también recompone uno partido en dos) y los frames válidos van a la misma
+ * Tuberia que los puertos serie, con fuente FUENTE_NRF24 + pipe.
+ * Todo corre en el hilo de la interrupción; los contadores se leen desde el bucle principal.
+ */
+class IngestaNrf24 {
+public:
+  explicit IngestaNrf24(Tuberia& tuberia) : _tuberia(tuberia) {}
+
+  bool iniciar(const RadioNrf24Linux::Cfg& cfg);
+  void detener() { _radio.detener(); }
+
+  void reporte(std::string& salida) const;
+
+private:
+  Tuberia&         _tuberia;
+  RadioNrf24Linux  _radio;
+  WSNFrame::Parser _parsers[6];
+  std::atomic<uint64_t> _bytes{0}, _frames{0}, _erroresCrc{0}, _descartados{0};
+
+  static void recibir(void* contexto, uint8_t pipe, const uint8_t* datos, uint8_t longitud);
+};
+
+#endif
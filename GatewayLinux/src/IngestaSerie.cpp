@@ -0,0 +1,204 @@
+#include "IngestaSerie.h"
+#include "PuertoSerie.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace {
+
+const uint64_t ID_TEMPORIZADOR   = ~0ULL;
+const uint64_t ID_SENALES        = ~0ULL - 1;
+const uint64_t ID_ESTADISTICAS   = ~0ULL - 2;
+const int64_t  REINTENTO_US      = 2000000;
+const size_t   TAM_LECTURA       = 16 * 1024;
+
+bool vigilar(int epoll, int fd, uint32_t eventos, uint64_t id) {
+  struct epoll_event ev;
+  ev.events   = eventos;
+  ev.data.u64 = id;
+  return epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+}  // namespace
+
+IngestaSerie::~IngestaSerie() {
+  for (size_t i = 0; i < _puertos.size(); ++i)
+    if (_puertos[i].fd >= 0) ::close(_puertos[i].fd);
+  if (_temporizador >= 0) ::close(_temporizador);
+  if (_senales >= 0) ::close(_senales);
+  if (_epoll >= 0) ::close(_epoll);
+}
+
+void IngestaSerie::agregarPuerto(const std::string& ruta, uint32_t baudios) {
+  Puerto p;
+  p.ruta    = ruta;
+  p.baudios = baudios;
+  _puertos.push_back(p);
+}
+
+bool IngestaSerie::abrir(size_t i, int64_t ahora_us) {
+  Puerto& p = _puertos[i];
+  p.fd = abrirPuertoSerie(p.ruta.c_str(), p.baudios);
+  if (p.fd < 0 || !vigilar(_epoll, p.fd, EPOLLIN | EPOLLET | EPOLLRDHUP, i)) {
+    if (p.reintento_us == 0) perror(p.ruta.c_str());   // solo el primer fallo, no cada 2 s
+    if (p.fd >= 0) { ::close(p.fd); p.fd = -1; }
+    p.reintento_us = ahora_us + REINTENTO_US;
+    return false;
+  }
+  p.parser.reset();
+  p.reintento_us = 0;
+  ++p.aperturas;
+  return true;
+}
+
+void IngestaSerie::cerrar(size_t i, int64_t ahora_us) {
+  Puerto& p = _puertos[i];
+  if (p.fd < 0) return;
+  epoll_ctl(_epoll, EPOLL_CTL_DEL, p.fd, nullptr);
+  ::close(p.fd);
+  p.fd = -1;
+  p.reintento_us = ahora_us + REINTENTO_US;
+  fprintf(stderr, "%s: cerrado, se reintenta\n", p.ruta.c_str());
+}
+
+void IngestaSerie::leer(size_t i) {
+  Puerto& p = _puertos[i];
+  uint8_t buf[TAM_LECTURA];
+  for (;;) {
+    ssize_t n = ::read(p.fd, buf, sizeof(buf));
+    if (n > 0) {
+      const int64_t llegada = ahoraUtc_us();     // una hora por bloque: bloques de < 2 ms
+      p.bytes += (uint64_t)n;
+      for (ssize_t k = 0; k < n; ++k) {
+        const WSNFrame::Parser::State antes = p.parser.st;
+        if (WSNFrame::feedFrame(p.parser, buf[k])) {
+          ++p.frames;
+          _tuberia.entregar(p.parser, (uint16_t)i, llegada);
+        } else if (antes == WSNFrame::Parser::READ_CRC_L) {
+          ++p.erroresCrc;
+        } else if (antes == WSNFrame::Parser::FIND_SOF0 && buf[k] != WSNFrame::MARCADOR_INICIO_0) {
+          ++p.descartados;                       // ruido o texto entre frames
+        }
+      }
+      continue;
+    }
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0 && errno == EAGAIN) return;
+    cerrar(i, ahoraUtc_us());                    // 0 = EOF; EIO = el otro extremo se fue
+    return;
+  }
+}
+
+void IngestaSerie::tic(int64_t ahora_us) {
+  uint64_t frames = 0;
+  for (size_t i = 0; i < _puertos.size(); ++i) {
+    Puerto& p = _puertos[i];
+    frames += p.frames;
+    if (p.fd < 0 && p.reintento_us != 0 && ahora_us >= p.reintento_us) abrir(i, ahora_us);
+  }
+  _tasa          = frames - _framesSegundo;
+  _framesSegundo = frames;
+  _tuberia.periodico();
+}
+
+void IngestaSerie::bloquearSenales() {
+  sigset_t mascara;
+  sigemptyset(&mascara);
+  sigaddset(&mascara, SIGINT);
+  sigaddset(&mascara, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &mascara, nullptr);
+  signal(SIGPIPE, SIG_IGN);
+}
+
+bool IngestaSerie::correr(ServidorEstadisticas& estadisticas) {
+  _epoll = epoll_create1(EPOLL_CLOEXEC);
+  if (_epoll < 0) { perror("epoll_create1"); return false; }
+
+  bloquearSenales();
+  sigset_t mascara;
+  sigemptyset(&mascara);
+  sigaddset(&mascara, SIGINT);
+  sigaddset(&mascara, SIGTERM);
+  _senales = signalfd(-1, &mascara, SFD_NONBLOCK | SFD_CLOEXEC);
+
+  _temporizador = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  struct itimerspec periodo = { { 1, 0 }, { 1, 0 } };
+  timerfd_settime(_temporizador, 0, &periodo, nullptr);
+
+  if (_senales < 0 || _temporizador < 0 ||
+      !vigilar(_epoll, _senales, EPOLLIN, ID_SENALES) ||
+      !vigilar(_epoll, _temporizador, EPOLLIN, ID_TEMPORIZADOR)) {
+    perror("epoll");
+    return false;
+  }
+
+  _inicio_us = ahoraUtc_us();
+  for (size_t i = 0; i < _puertos.size(); ++i) abrir(i, _inicio_us);
+
+  // El socket se abre al final: quien lo ve existir ya puede mandar datos a los puertos
+  if (!estadisticas.abrir() || !vigilar(_epoll, estadisticas.fd(), EPOLLIN, ID_ESTADISTICAS))
+    return false;
+
+  struct epoll_event eventos[64];
+  bool corriendo = true;
+  while (corriendo) {
+    int n = epoll_wait(_epoll, eventos, 64, -1);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      perror("epoll_wait");
+      break;
+    }
+    for (int k = 0; k < n; ++k) {
+      const uint64_t id = eventos[k].data.u64;
+      if (id == ID_TEMPORIZADOR) {
+        uint64_t vencidos;
+        if (::read(_temporizador, &vencidos, sizeof(vencidos)) > 0) tic(ahoraUtc_us());
+      } else if (id == ID_SENALES) {
+        struct signalfd_siginfo info;
+        if (::read(_senales, &info, sizeof(info)) > 0) corriendo = false;
+      } else if (id == ID_ESTADISTICAS) {
+        estadisticas.atender();
+      } else if (id < _puertos.size() && _puertos[id].fd >= 0) {
+        // Primero se drena (pueden quedar bytes antes del cuelgue), luego se cierra
+        leer((size_t)id);
+        if ((eventos[k].events & (EPOLLHUP | EPOLLRDHUP | EPOLLERR)) && _puertos[id].fd >= 0)
+          cerrar((size_t)id, ahoraUtc_us());
+      }
+    }
+  }
+
+  tic(ahoraUtc_us());
+  return true;
+}
+
+void IngestaSerie::reporte(std::string& salida, int64_t ahora_us) const {
+  uint64_t frames = 0, bytes = 0, crc = 0, descartados = 0;
+  for (size_t i = 0; i < _puertos.size(); ++i) {
+    frames      += _puertos[i].frames;
+    bytes       += _puertos[i].bytes;
+    crc         += _puertos[i].erroresCrc;
+    descartados += _puertos[i].descartados;
+  }
+  char linea[512];
+  snprintf(linea, sizeof(linea),
+           "tiempo_s %.1f\nframes %" PRIu64 "\nframes_por_s %" PRIu64 "\nbytes %" PRIu64
+           "\nerrores_crc %" PRIu64 "\nbytes_descartados %" PRIu64 "\npuertos %zu\n",
+           (ahora_us - _inicio_us) / 1e6, frames, _tasa, bytes, crc, descartados, _puertos.size());
+  salida += linea;
+  for (size_t i = 0; i < _puertos.size(); ++i) {
+    const Puerto& p = _puertos[i];
+    snprintf(linea, sizeof(linea),
+             "puerto %zu %s %s frames %" PRIu64 " bytes %" PRIu64 " errores_crc %" PRIu64
+             " descartados %" PRIu64 " aperturas %u\n",
+             i, p.ruta.c_str(), p.fd >= 0 ? "abierto" : "cerrado", p.frames, p.bytes,
+             p.erroresCrc, p.descartados, p.aperturas);
+    salida += linea;
+  }
+}
@@ -0,0 +1,61 @@
+#ifndef GATEWAY_INGESTA_SERIE_H
+#define GATEWAY_INGESTA_SERIE_H
+
+#include "ServidorEstadisticas.h"
+#include "Tuberia.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Bucle de eventos del gateway: un solo hilo con epoll sobre
+ *   - los puertos serie (edge-triggered: se lee cada uno hasta EAGAIN, en bloques de 16 KB),
+ *   - un timerfd de 1 s (vacía el almacén, calcula la tasa, reabre puertos caídos),
+ *   - un signalfd (SIGINT/SIGTERM: vacía y sale limpio),
+ *   - el socket de estadísticas.
+ * Cada puerto tiene su propio WSNFrame::Parser, así que los streams no se mezclan aunque
+ * un read() corte un frame a la mitad. Un puerto que da EOF/EIO (USB desconectado, pty
+ * cerrado) se cierra y se reintenta cada 2 s sin afectar a los demás.
+ */
+class IngestaSerie {
+public:
+  explicit IngestaSerie(Tuberia& tuberia) : _tuberia(tuberia) {}
+  ~IngestaSerie();
+
+  /* Registra un puerto; se abre en correr(). La fuente de sus registros es su índice. */
+  void agregarPuerto(const std::string& ruta, uint32_t baudios);
+
+  /* Corre hasta SIGINT/SIGTERM; false si no pudo armar el epoll o el socket */
+  bool correr(ServidorEstadisticas& estadisticas);
+
+  /* Bloquea SIGINT/SIGTERM (los atiende el signalfd). Quien cree hilos antes de correr()
+   * debe llamarla primero: los hilos heredan la máscara y así ninguno recibe la señal. */
+  static void bloquearSenales();
+
+  /* Totales y una línea "puerto ..." por puerto */
+  void reporte(std::string& salida, int64_t ahora_us) const;
+
+private:
+  struct Puerto {
+    std::string      ruta;
+    uint32_t         baudios;
+    int              fd = -1;
+    WSNFrame::Parser parser;
+    uint64_t bytes = 0, frames = 0, erroresCrc = 0, descartados = 0;
+    uint32_t aperturas = 0;
+    int64_t  reintento_us = 0;
+  };
+
+  Tuberia&            _tuberia;
+  std::vector<Puerto> _puertos;
+  int      _epoll = -1, _temporizador = -1, _senales = -1;
+  int64_t  _inicio_us = 0;
+  uint64_t _framesSegundo = 0, _tasa = 0;      // frames al último tic y frames del último segundo
+
+  bool abrir(size_t i, int64_t ahora_us);
+  void cerrar(size_t i, int64_t ahora_us);
+  void leer(size_t i);
+  void tic(int64_t ahora_us);
+};
+
+#endif
@@ -0,0 +1,50 @@
+#include "PuertoSerie.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+speed_t velocidad(uint32_t baudios) {
+  switch (baudios) {
+    case 9600:   return B9600;
+    case 19200:  return B19200;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default:     return B0;
+  }
+}
+
+}  // namespace
+
+bool baudiosValidos(uint32_t baudios) { return velocidad(baudios) != B0; }
+
+int abrirPuertoSerie(const char* ruta, uint32_t baudios) {
+  int fd = ::open(ruta, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) return -1;
+
+  struct termios t;
+  if (tcgetattr(fd, &t) == 0) {
+    cfmakeraw(&t);                     // sin eco ni traducción de CR/LF: el stream es binario
+    t.c_cflag |= CLOCAL | CREAD;
+    t.c_cflag &= ~(CSTOPB | CRTSCTS);
+    t.c_cc[VMIN]  = 1;                 // con O_NONBLOCK: sin datos da EAGAIN, y 0 solo es cuelgue
+    t.c_cc[VTIME] = 0;
+    cfsetispeed(&t, velocidad(baudios));
+    cfsetospeed(&t, velocidad(baudios));
+    if (tcsetattr(fd, TCSANOW, &t) != 0) {
+      int e = errno;
+      ::close(fd);
+      errno = e;
+      return -1;
+    }
+    tcflush(fd, TCIFLUSH);             // lo acumulado antes de abrir es de otra sesión
+  }
+  return fd;
+}
@@ -0,0 +1,16 @@
+#ifndef GATEWAY_PUERTO_SERIE_H
+#define GATEWAY_PUERTO_SERIE_H
+
+#include <stdint.h>
+
+/**
+ * Abre un puerto serie (USB-serie del XBee/coordinador o un pty de prueba) en modo
+ * crudo 8N1, sin control de flujo y no bloqueante. Devuelve el fd o -1 (con errno).
+ * Un pty ignora la velocidad; en un tty real debe ser una de las estándar.
+ */
+int abrirPuertoSerie(const char* ruta, uint32_t baudios);
+
+/* Velocidad válida para termios (9600 ... 921600) */
+bool baudiosValidos(uint32_t baudios);
+
+#endif
@@ -0,0 +1,99 @@
+#include "RadioNrf24Linux.h"
+
+#include <RF24.h>
+
+#include <stdio.h>
+#include <stdexcept>
+
+namespace {
+
+// attachInterrupt() de RF24 solo acepta void(*)(void): una instancia por proceso
+RadioNrf24Linux* activa = nullptr;
+
+}  // namespace
+
+void RadioNrf24Linux::rutinaInterrupcion() {
+  if (activa) activa->atender();
+}
+
+bool RadioNrf24Linux::iniciar(const Cfg& cfg, Receptor receptor, void* contexto) {
+  if (activa) return false;
+  _cfg      = cfg;
+  _receptor = receptor;
+  _contexto = contexto;
+
+  try {
+    _rf24 = new RF24(cfg.cePin, cfg.csn);
+    if (!_rf24->begin()) {
+      fprintf(stderr, "nRF24: no responde por SPI (csn %u, ce %u)\n", cfg.csn, cfg.cePin);
+      delete _rf24;
+      _rf24 = nullptr;
+      return false;
+    }
+    _rf24->setChannel(cfg.canal);
+    _rf24->setDataRate((rf24_datarate_e)(cfg.velocidad == 0 ? RF24_250KBPS
+                                         : cfg.velocidad == 1 ? RF24_1MBPS : RF24_2MBPS));
+    _rf24->setAutoAck(true);
+    _rf24->enableDynamicPayloads();
+    uint8_t direccion[5];
+    for (uint8_t p = 0; p < 6; ++p) {
+      for (uint8_t k = 0; k < 5; ++k) direccion[k] = cfg.direccionBase[k];
+      direccion[0] = (uint8_t)(cfg.direccionBase[0] + p);
+      _rf24->openReadingPipe(p, direccion);
+    }
+    _rf24->maskIRQ(true, true, false);      // al pin IRQ solo llega RX_DR
+    _rf24->startListening();
+
+    activa  = this;
+    _activo = true;
+    pinMode(cfg.irqPin, INPUT);
+    attachInterrupt(cfg.irqPin, INT_EDGE_FALLING, &RadioNrf24Linux::rutinaInterrupcion);
+  } catch (const std::exception& e) {
+    fprintf(stderr, "nRF24: %s\n", e.what());
+    delete _rf24;
+    _rf24   = nullptr;
+    activa  = nullptr;
+    _activo = false;
+    return false;
+  }
+
+  // Lo que llegó entre startListening() y attachInterrupt() ya tiene el pin abajo: sin
+  // flanco nuevo nunca se atendería. El candado lo ordena con una interrupción simultánea
+  atender();
+  return true;
+}
+
+void RadioNrf24Linux::detener() {
+  if (!_activo) return;
+  detachInterrupt(_cfg.irqPin);
+  _activo = false;
+  activa  = nullptr;
+  _rf24->stopListening();
+  _rf24->powerDown();
+  delete _rf24;
+  _rf24 = nullptr;
+}
+
+void RadioNrf24Linux::atender() {
+  std::lock_guard<std::mutex> g(_spi);
+  ++interrupciones;
+  uint8_t buf[32];
+  uint8_t leidos = 0;
+
+  // STATUS previo a la limpieza: RX_P_NO ya dice de qué pipe es el primero del FIFO (7 = vacío)
+  uint8_t pipe = (_rf24->clearStatusFlags(RF24_RX_DR) >> RX_P_NO) & 0x07;
+  while (pipe < 6) {
+    uint8_t n = _rf24->getDynamicPayloadSize();
+    if (n == 0) {                              // longitud corrupta: RF24 ya vació el FIFO
+      ++longitudesInvalidas;
+      pipe = (_rf24->update() >> RX_P_NO) & 0x07;
+      continue;
+    }
+    _rf24->read(buf, n);                       // también limpia RX_DR
+    ++paquetes;
+    ++leidos;
+    _receptor(_contexto, pipe, buf, n);
+    pipe = (_rf24->getStatusFlags() >> RX_P_NO) & 0x07;   // STATUS tras sacar el paquete
+  }
+  ++porVaciado[leidos < 3 ? leidos : 3];
+}
@@ -0,0 +1,62 @@
+#ifndef GATEWAY_RADIO_NRF24_LINUX_H
+#define GATEWAY_RADIO_NRF24_LINUX_H
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+class RF24;
+
+/**
+ * Coordinador nRF24L01 sobre la librería RF24 (driver SPIDEV: /dev/spidevB.C y el pin IRQ
+ * por /dev/gpiochipN). Misma configuración que Nrf24Config con esCoordinador = true:
+ * los seis pipes abiertos en direccionBase + pipe, carga dinámica y auto-ACK.
+ *
+ * Nada de sondear available(): solo RX_DR llega al pin IRQ y la rutina de interrupción
+ * (hilo de las utilidades de interrupción de RF24) primero limpia RX_DR y después vacía
+ * el FIFO completo (hasta 3 paquetes) siguiendo RX_P_NO del STATUS, que cada transacción
+ * SPI devuelve gratis: 3 transacciones por paquete en vez de las 5 de available(&pipe).
+ * Un paquete que llegue durante el vaciado vuelve a bajar el pin y genera otro flanco.
+ *
+ * Este archivo es el único que incluye RF24.h: su RF24_arch_config.h define HIGH, delay,
+ * millis()... y no puede convivir con el <Arduino.h> que usa CodecWSN.
+ */
+class RadioNrf24Linux {
+public:
+  struct Cfg {
+    uint16_t cePin     = 22;    // GPIO (numeración del gpiochip)
+    uint16_t csn       = 0;     // bus·10 + CS: 0 = /dev/spidev0.0, 11 = /dev/spidev1.1
+    uint16_t irqPin    = 24;
+    uint8_t  canal     = 108;
+    uint8_t  velocidad = 0;     // 0 = 250 kbps, 1 = 1 Mbps, 2 = 2 Mbps (rf24_datarate_e)
+    uint8_t  direccionBase[5] = { 0x00, 'N', 'S', 'W', 0xC3 };   // byte 0 = pipe (LSB primero)
+  };
+
+  /* Se llama desde el hilo de la interrupción, una vez por paquete leído del FIFO */
+  typedef void (*Receptor)(void* contexto, uint8_t pipe, const uint8_t* datos, uint8_t longitud);
+
+  RadioNrf24Linux() { for (int i = 0; i < 4; ++i) porVaciado[i] = 0; }
+  ~RadioNrf24Linux() { detener(); }
+
+  /* Configura el radio y engancha la interrupción; false (con el motivo en stderr) si falla */
+  bool iniciar(const Cfg& cfg, Receptor receptor, void* contexto);
+  void detener();
+
+  std::atomic<uint64_t> interrupciones{0};
+  std::atomic<uint64_t> paquetes{0};
+  std::atomic<uint64_t> longitudesInvalidas{0};   // R_RX_PL_WID > 32: el FIFO se vació
+  std::atomic<uint64_t> porVaciado[4];            // interrupciones que sacaron 0, 1, 2 y 3+ paquetes
+
+private:
+  Cfg      _cfg;
+  RF24*    _rf24 = nullptr;
+  Receptor _receptor = nullptr;
+  void*    _contexto = nullptr;
+  bool     _activo = false;
+  std::mutex _spi;                  // el vaciado inicial corre en el hilo principal
+
+  void atender();
+  static void rutinaInterrupcion();
+};
+
+#endif
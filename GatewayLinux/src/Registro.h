@@ -0,0 +1,44 @@
+#ifndef GATEWAY_REGISTRO_H
+#define GATEWAY_REGISTRO_H
+
+#include <CodecWSN.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Unidad que viaja por la tubería del gateway: un frame WSN válido ya sin SOF/CRC,
+ * con la hora de llegada y la fuente por la que entró. La fuente es el enlace, no el
+ * nodo: un puerto serie (0..N-1) o un pipe del nRF24 (FUENTE_NRF24 + pipe). Con XBee
+ * en modo AT el frame no trae dirección de origen, así que un nodo = un enlace.
+ */
+const uint8_t  TIPO_PACKET_V1  = 0x01;    // Packet de 8 B (frame v1); los v2 usan su TipoRegistro
+const uint16_t FUENTE_NRF24    = 0x100;   // fuentes 0x100..0x105: pipes 0..5 del nRF24
+const size_t   MAX_DATOS_REGISTRO = 28;   // cabe cualquier payload v2 sin su byte de TIPO
+
+struct Registro {
+  int64_t  t_us;        // hora de llegada, UTC en µs
+  uint16_t fuente;
+  uint8_t  tipo;        // TIPO_PACKET_V1 o TipoRegistro
+  uint8_t  longitud;    // bytes válidos en datos
+  uint8_t  datos[MAX_DATOS_REGISTRO];
+
+  /* Arma el registro con el último frame válido del parser (tras feedFrame() == true) */
+  static Registro deFrame(const WSNFrame::Parser& p, uint16_t fuente, int64_t t_us) {
+    Registro r;
+    r.t_us   = t_us;
+    r.fuente = fuente;
+    if (p.ver == WSNFrame::VERSION_PROTOCOLO) {
+      r.tipo     = TIPO_PACKET_V1;
+      r.longitud = (uint8_t)PACKET_SIZE;
+      memcpy(r.datos, p.pay, PACKET_SIZE);
+    } else {
+      r.tipo     = p.tipo();
+      r.longitud = (uint8_t)p.longitudDatos();
+      memcpy(r.datos, p.datos(), r.longitud);
+    }
+    memset(r.datos + r.longitud, 0, sizeof(r.datos) - r.longitud);
+    return r;
+  }
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "ServidorEstadisticas.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+bool direccion(const std::string& ruta, struct sockaddr_un& dir) {
+  memset(&dir, 0, sizeof(dir));
+  dir.sun_family = AF_UNIX;
+  if (ruta.size() >= sizeof(dir.sun_path)) return false;
+  memcpy(dir.sun_path, ruta.c_str(), ruta.size() + 1);
+  return true;
+}
+
+}  // namespace
+
+ServidorEstadisticas::~ServidorEstadisticas() {
+  if (_fd >= 0) {
+    ::close(_fd);
+    ::unlink(_ruta.c_str());
+  }
+}
+
+bool ServidorEstadisticas::abrir() {
+  struct sockaddr_un dir;
+  if (!direccion(_ruta, dir)) {
+    fprintf(stderr, "%s: ruta de socket demasiado larga\n", _ruta.c_str());
+    return false;
+  }
+  _fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (_fd < 0) { perror("socket"); return false; }
+  ::unlink(_ruta.c_str());                          // el de una ejecución anterior
+  if (::bind(_fd, (struct sockaddr*)&dir, sizeof(dir)) != 0 || ::listen(_fd, 8) != 0) {
+    perror(_ruta.c_str());
+    ::close(_fd);
+    _fd = -1;
+    return false;
+  }
+  return true;
+}
+
+void ServidorEstadisticas::atender() {
+  for (;;) {
+    int cliente = ::accept4(_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (cliente < 0) {
+      if (errno == EINTR) continue;
+      return;                                       // EAGAIN: no hay más pendientes
+    }
+    std::string texto;
+    _generador(texto);
+    // Sin esperar al cliente: la instantánea cabe holgada en el buffer del socket
+    ::send(cliente, texto.data(), texto.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+    ::close(cliente);
+    ++_consultas;
+  }
+}
+
+bool consultarEstadisticas(const std::string& ruta, std::string& salida) {
+  struct sockaddr_un dir;
+  if (!direccion(ruta, dir)) return false;
+  int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return false;
+  if (::connect(fd, (struct sockaddr*)&dir, sizeof(dir)) != 0) {
+    ::close(fd);
+    return false;
+  }
+  salida.clear();
+  char buf[4096];
+  for (;;) {
+    ssize_t n = ::read(fd, buf, sizeof(buf));
+    if (n > 0) { salida.append(buf, (size_t)n); continue; }
+    if (n < 0 && errno == EINTR) continue;
+    break;
+  }
+  ::close(fd);
+  return !salida.empty();
+}
+
+unsigned long long valorEstadistica(const std::string& texto, const char* clave) {
+  const std::string buscado = std::string("\n") + clave + " ";
+  const std::string t = "\n" + texto;
+  size_t i = t.find(buscado);
+  return i == std::string::npos ? 0 : strtoull(t.c_str() + i + buscado.size(), nullptr, 10);
+}
@@ -0,0 +1,40 @@
+#ifndef GATEWAY_SERVIDOR_ESTADISTICAS_H
+#define GATEWAY_SERVIDOR_ESTADISTICAS_H
+
+#include <functional>
+#include <string>
+
+/**
+ * Endpoint de estadísticas en un socket Unix (SOCK_STREAM): cada conexión recibe una
+ * instantánea en texto, una línea "clave valor" por dato, y se cierra.
+ *   socat - UNIX-CONNECT:/tmp/wsn-gateway.sock      o      nc -U /tmp/wsn-gateway.sock
+ * El fd se registra en el bucle de eventos y atender() se llama cuando está legible.
+ */
+class ServidorEstadisticas {
+public:
+  typedef std::function<void(std::string&)> Generador;
+
+  ServidorEstadisticas(const std::string& ruta, Generador generador)
+      : _ruta(ruta), _generador(generador) {}
+  ~ServidorEstadisticas();
+
+  bool abrir();
+  int  fd() const { return _fd; }
+  void atender();
+
+  unsigned long consultas() const { return _consultas; }
+
+private:
+  std::string   _ruta;
+  Generador     _generador;
+  int           _fd = -1;
+  unsigned long _consultas = 0;
+};
+
+/* Cliente: lee la instantánea completa del socket (para las pruebas y scripts) */
+bool consultarEstadisticas(const std::string& ruta, std::string& salida);
+
+/* Primer número tras "clave " al inicio de una línea de la instantánea (0 si no está) */
+unsigned long long valorEstadistica(const std::string& texto, const char* clave);
+
+#endif
@@ -0,0 +1,65 @@
+#include "TablaNodos.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+void TablaNodos::actualizar(const Registro& r) {
+  EstadoNodo& n = _nodos[r.fuente];
+  if (n.registros++ == 0) n.primero_us = r.t_us;
+  n.ultimo_us = r.t_us;
+
+  switch (r.tipo) {
+    case TIPO_PACKET_V1: {
+      Packet p = decodePacketFast(r.datos);
+      if (n.conPacket) {
+        uint16_t salto = (uint16_t)(p.id - n.ultimoPacket.id);
+        if (salto == 0)        ++n.duplicados;
+        else if (salto < 1000) n.perdidos += salto - 1;
+        else                   ++n.reinicios;     // el contador volvió a empezar
+      }
+      n.ultimoPacket = p;
+      n.conPacket = true;
+      ++n.packets;
+      break;
+    }
+    case REG_RESUMEN:
+      if (decodeResumen(r.datos, r.longitud, n.ultimoResumen)) {
+        n.conResumen = true;
+        n.energia_mWh += n.ultimoResumen.energia_mWh;
+      }
+      ++n.resumenes;
+      break;
+    case REG_ARMONICOS:
+      ++n.armonicos;
+      break;
+    default:
+      ++n.otros;
+      break;
+  }
+}
+
+const EstadoNodo* TablaNodos::nodo(uint16_t fuente) const {
+  std::map<uint16_t, EstadoNodo>::const_iterator it = _nodos.find(fuente);
+  return it == _nodos.end() ? nullptr : &it->second;
+}
+
+void TablaNodos::reporte(std::string& salida, int64_t ahora_us) const {
+  char linea[320];
+  for (std::map<uint16_t, EstadoNodo>::const_iterator it = _nodos.begin(); it != _nodos.end(); ++it) {
+    const EstadoNodo& n = it->second;
+    int k = snprintf(linea, sizeof(linea),
+                     "nodo %u registros %" PRIu64 " packets %" PRIu64 " resumenes %" PRIu64
+                     " armonicos %" PRIu64 " otros %" PRIu64 " perdidos %" PRIu64
+                     " duplicados %" PRIu64 " reinicios %" PRIu64 " hace_ms %" PRId64,
+                     it->first, n.registros, n.packets, n.resumenes, n.armonicos, n.otros,
+                     n.perdidos, n.duplicados, n.reinicios, (ahora_us - n.ultimo_us) / 1000);
+    if (n.conPacket)
+      k += snprintf(linea + k, sizeof(linea) - k, " id %u v %.2f i_mA %d vbat %.2f",
+                    n.ultimoPacket.id, n.ultimoPacket.voltaje / 100.0,
+                    n.ultimoPacket.corriente, n.ultimoPacket.vbat / 100.0);
+    if (n.conResumen)
+      k += snprintf(linea + k, sizeof(linea) - k, " energia_mWh %" PRIu64, n.energia_mWh);
+    salida.append(linea, (size_t)k < sizeof(linea) ? (size_t)k : sizeof(linea) - 1);
+    salida += '\n';
+  }
+}
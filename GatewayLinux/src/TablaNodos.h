@@ -0,0 +1,39 @@
+#ifndef GATEWAY_TABLA_NODOS_H
+#define GATEWAY_TABLA_NODOS_H
+
+#include "Registro.h"
+
+#include <map>
+#include <string>
+
+/**
+ * Estado por nodo (por fuente): último dato visto, conteo por tipo de registro y
+ * paquetes perdidos según los huecos del id de los Packet v1 (contador del nodo).
+ */
+struct EstadoNodo {
+  uint64_t registros = 0;
+  uint64_t packets = 0, armonicos = 0, resumenes = 0, otros = 0;
+  uint64_t perdidos = 0, duplicados = 0, reinicios = 0;
+  int64_t  primero_us = 0, ultimo_us = 0;
+  bool     conPacket = false;
+  Packet   ultimoPacket;
+  PacketResumen ultimoResumen;
+  bool     conResumen = false;
+  uint64_t energia_mWh = 0;          // suma de los resúmenes recibidos
+};
+
+class TablaNodos {
+public:
+  void actualizar(const Registro& r);
+
+  const EstadoNodo* nodo(uint16_t fuente) const;
+  size_t tamano() const { return _nodos.size(); }
+
+  /* Una línea "nodo ..." por fuente, en el formato del endpoint de estadísticas */
+  void reporte(std::string& salida, int64_t ahora_us) const;
+
+private:
+  std::map<uint16_t, EstadoNodo> _nodos;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#include "Tuberia.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+int64_t ahoraUtc_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void Tuberia::entregar(const Registro& r) {
+  std::lock_guard<std::mutex> g(_candado);
+  _nodos.actualizar(r);
+  _almacen.escribir(r);
+  ++_registros;
+}
+
+void Tuberia::periodico() {
+  std::lock_guard<std::mutex> g(_candado);
+  _almacen.vaciar();
+}
+
+uint64_t Tuberia::registros() const {
+  std::lock_guard<std::mutex> g(_candado);
+  return _registros;
+}
+
+void Tuberia::reporte(std::string& salida, int64_t ahora_us) const {
+  std::lock_guard<std::mutex> g(_candado);
+  char linea[512];
+  snprintf(linea, sizeof(linea),
+           "registros %" PRIu64 "\nregistros_escritos %" PRIu64 "\nbytes_almacen %" PRIu64
+           "\nerrores_almacen %" PRIu64 "\narchivo %s\nnodos %zu\n",
+           _registros, _almacen.escritos(), _almacen.bytes(), _almacen.errores(),
+           _almacen.archivo().c_str(), _nodos.tamano());
+  salida += linea;
+  _nodos.reporte(salida, ahora_us);
+}
@@ -0,0 +1,40 @@
+#ifndef GATEWAY_TUBERIA_H
+#define GATEWAY_TUBERIA_H
+
+#include "AlmacenSerie.h"
+#include "TablaNodos.h"
+
+#include <mutex>
+#include <string>
+
+/**
+ * Destino común de todo lo que entra al gateway (puertos serie, nRF24 por SPI):
+ * actualiza la tabla de nodos y escribe el registro en el almacén. El candado permite
+ * entregar desde el hilo de interrupciones del nRF24; en el bucle epoll nunca compite.
+ */
+class Tuberia {
+public:
+  explicit Tuberia(AlmacenSerie& almacen) : _almacen(almacen) {}
+
+  void entregar(const Registro& r);
+  void entregar(const WSNFrame::Parser& p, uint16_t fuente, int64_t t_us) {
+    entregar(Registro::deFrame(p, fuente, t_us));
+  }
+
+  /* Cada segundo: baja el buffer del almacén al archivo */
+  void periodico();
+
+  uint64_t registros() const;
+  void reporte(std::string& salida, int64_t ahora_us) const;
+
+private:
+  AlmacenSerie&      _almacen;
+  TablaNodos         _nodos;
+  uint64_t           _registros = 0;
+  mutable std::mutex _candado;
+};
+
+/* Hora UTC en µs (la de los registros) */
+int64_t ahoraUtc_us();
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Gateway WSN para Linux: junta los frames WSNFrame (v1 y v2) de varios coordinadores
+ * o XBee en modo AT conectados por USB-serie, lleva una tabla de estado por nodo y
+ * guarda cada registro en el almacén binario de series de tiempo.
+ *
+ *   wsn_gateway [-o dir_datos] [-s socket] [-b baudios] puerto[:baudios] ...
+ *   wsn_gateway -o /var/lib/wsn /dev/ttyUSB0 /dev/ttyUSB1:115200
+ *
+ * Estadísticas en vivo:   socat - UNIX-CONNECT:/tmp/wsn-gateway.sock
+ */
+#include "IngestaSerie.h"
+#include "PuertoSerie.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace {
+
+void uso(const char* programa) {
+  fprintf(stderr,
+          "uso: %s [-o dir_datos=.] [-s socket=/tmp/wsn-gateway.sock] [-b baudios=9600]"
+          " puerto[:baudios] ...\n", programa);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string directorio = ".", socket = "/tmp/wsn-gateway.sock";
+  uint32_t baudios = 9600;
+
+  int op;
+  while ((op = getopt(argc, argv, "o:s:b:h")) != -1) {
+    switch (op) {
+      case 'o': directorio = optarg; break;
+      case 's': socket = optarg; break;
+      case 'b': baudios = (uint32_t)strtoul(optarg, nullptr, 10); break;
+      default:  uso(argv[0]); return 2;
+    }
+  }
+  if (optind >= argc) { uso(argv[0]); return 2; }
+
+  AlmacenSerie almacen(directorio);
+  Tuberia      tuberia(almacen);
+  IngestaSerie ingesta(tuberia);
+
+  for (int i = optind; i < argc; ++i) {
+    std::string ruta = argv[i];
+    uint32_t b = baudios;
+    size_t dos = ruta.rfind(':');
+    if (dos != std::string::npos) {
+      b = (uint32_t)strtoul(ruta.c_str() + dos + 1, nullptr, 10);
+      ruta.erase(dos);
+    }
+    if (!baudiosValidos(b)) {
+      fprintf(stderr, "%s: velocidad %u no soportada\n", ruta.c_str(), b);
+      return 2;
+    }
+    ingesta.agregarPuerto(ruta, b);
+  }
+
+  ServidorEstadisticas estadisticas(socket, [&](std::string& salida) {
+    const int64_t ahora = ahoraUtc_us();
+    ingesta.reporte(salida, ahora);
+    tuberia.reporte(salida, ahora);
+  });
+
+  if (!ingesta.correr(estadisticas)) return 1;
+  almacen.vaciar();
+  return 0;
+}
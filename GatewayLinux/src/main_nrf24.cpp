@@ -0,0 +1,90 @@
+/*
+ * Gateway WSN con un nRF24L01 conectado por SPI a la Raspberry Pi (o cualquier Linux con
+ * spidev y gpiochip): recibe los frames WSN de hasta seis nodos nRF24 por interrupción y
+ * los manda a la misma tubería que wsn_gateway (tabla de nodos + almacén .wts). Opcionalmente
+ * también atiende puertos serie, en el mismo proceso y el mismo almacén.
+ *
+ *   wsn_gateway_nrf24 [-o dir_datos] [-s socket] [-c canal] [-v 250k|1m|2m]
+ *                     [-e pin_ce] [-i pin_irq] [-d csn] [puerto[:baudios] ...]
+ *   wsn_gateway_nrf24 -o /var/lib/wsn -e 22 -i 24 -d 0
+ *
+ * Cableado por defecto (como los ejemplos de RF24 en Linux): CE en GPIO22, CSN en CE0
+ * (/dev/spidev0.0), IRQ en GPIO24. El gpiochip se elige al compilar (GATEWAY_GPIO_CHIP).
+ */
+#include "IngestaNrf24.h"
+#include "IngestaSerie.h"
+#include "PuertoSerie.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace {
+
+void uso(const char* programa) {
+  fprintf(stderr,
+          "uso: %s [-o dir_datos=.] [-s socket=/tmp/wsn-gateway.sock] [-c canal=108]"
+          " [-v 250k|1m|2m] [-e pin_ce=22] [-i pin_irq=24] [-d csn=0] [puerto[:baudios] ...]\n",
+          programa);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string directorio = ".", socket = "/tmp/wsn-gateway.sock";
+  RadioNrf24Linux::Cfg cfg;
+
+  int op;
+  while ((op = getopt(argc, argv, "o:s:c:v:e:i:d:h")) != -1) {
+    switch (op) {
+      case 'o': directorio = optarg; break;
+      case 's': socket = optarg; break;
+      case 'c': cfg.canal  = (uint8_t)atoi(optarg); break;
+      case 'e': cfg.cePin  = (uint16_t)atoi(optarg); break;
+      case 'i': cfg.irqPin = (uint16_t)atoi(optarg); break;
+      case 'd': cfg.csn    = (uint16_t)atoi(optarg); break;
+      case 'v':
+        if      (strcmp(optarg, "250k") == 0) cfg.velocidad = 0;
+        else if (strcmp(optarg, "1m") == 0)   cfg.velocidad = 1;
+        else if (strcmp(optarg, "2m") == 0)   cfg.velocidad = 2;
+        else { uso(argv[0]); return 2; }
+        break;
+      default: uso(argv[0]); return 2;
+    }
+  }
+
+  AlmacenSerie almacen(directorio);
+  Tuberia      tuberia(almacen);
+  IngestaSerie serie(tuberia);          // sin puertos solo lleva el reloj, las señales y el socket
+  IngestaNrf24 nrf24(tuberia);
+
+  for (int i = optind; i < argc; ++i) {
+    std::string ruta = argv[i];
+    uint32_t b = 9600;
+    size_t dos = ruta.rfind(':');
+    if (dos != std::string::npos) {
+      b = (uint32_t)strtoul(ruta.c_str() + dos + 1, nullptr, 10);
+      ruta.erase(dos);
+    }
+    if (!baudiosValidos(b)) {
+      fprintf(stderr, "%s: velocidad %u no soportada\n", ruta.c_str(), b);
+      return 2;
+    }
+    serie.agregarPuerto(ruta, b);
+  }
+
+  ServidorEstadisticas estadisticas(socket, [&](std::string& salida) {
+    const int64_t ahora = ahoraUtc_us();
+    serie.reporte(salida, ahora);
+    nrf24.reporte(salida);
+    tuberia.reporte(salida, ahora);
+  });
+
+  IngestaSerie::bloquearSenales();      // antes de que RF24 cree el hilo de la interrupción
+  if (!nrf24.iniciar(cfg)) return 1;
+  bool ok = serie.correr(estadisticas);
+  nrf24.detener();
+  almacen.vaciar();
+  return ok ? 0 : 1;
+}
@@ -13,6 +13,7 @@
 #include <UniversalRadioWSN.h>
 #include <SoftwareSerial.h>
 #include "AdaptiveTXWSN.h" // --> CAMBIO: Se incluye la nueva librería.
+#include "ACMeterWSN.h"    // True-RMS sincronizado a cruces por cero
 
 // ======================= 1. SELECCIÓN DEL MÓDULO DE RADIO =======================
 // Descomenta solo UNA de las siguientes dos líneas.
@@ -33,8 +34,8 @@
 #define VBAT_PIN  A2
 
 // ======================= OBJETOS Y VARIABLES GLOBALES =======================
-RadioInterface* radio;
 AdaptiveTXWSN txManager; // --> CAMBIO: Se crea el objeto para gestionar la energía.
+ACMeterWSN medidor;
 uint32_t paquetesEnviados = 0;
 
 // --> CAMBIO: Se eliminan las variables del temporizador manual.
@@ -46,6 +47,24 @@ uint32_t paquetesEnviados = 0;
   SoftwareSerial xbeeSerial(2, 3); // RX Pin = 2, TX Pin = 3
 #endif
 
+// --- Radio elegido en compilación: sin new, sin vtable, llamadas directas ---
+#if defined(USE_LORA)
+  const LoRaConfig configLora = {
+    410000000L, // frequency
+    20,         // txPower
+    7,          // spreadingFactor
+    125000L,    // signalBandwidth
+    5,          // codingRate
+    0xF3,       // syncWord
+    10,         // csPin
+    9,          // resetPin
+    2           // irqPin
+  };
+  UniversalRadio<LoraRadio> radio(configLora);
+#elif defined(USE_XBEE)
+  UniversalRadio<XBeeRadio> radio(xbeeSerial, 9600, -1, -1);
+#endif
+
 // ======================= SETUP =======================
 void setup() {
   pinMode(RELAY_PIN, OUTPUT);
@@ -81,32 +100,24 @@ void setup() {
 
   txManager.begin(configEnergia); // Se inicializa la librería con la configuración.
 
+  ACMeterWSN::Cfg configAc;
+  configAc.pinV   = ZMPT_PIN;
+  configAc.pinI   = ACS_PIN;
+  configAc.ciclos = 2;
+  medidor.begin(configAc);
+
   // --- INYECCIÓN DE DEPENDENCIA DEL RADIO (Sin cambios) ---
   Serial.print("Configurando radio: ");
   
   #if defined(USE_LORA)
     Serial.println("LoRa");
 
-    LoRaConfig configLora;
-    configLora.frequency        = 410E6;
-    configLora.spreadingFactor  = 7;
-    configLora.signalBandwidth  = 125E3;
-    configLora.codingRate       = 5;
-    configLora.syncWord         = 0xF3;
-    configLora.txPower          = 20;
-    configLora.csPin            = 10;
-    configLora.resetPin         = 9;
-    configLora.irqPin           = 2;
-
-    radio = new LoraRadio(configLora);
-
   #elif defined(USE_XBEE)
     Serial.println("XBee");
     xbeeSerial.begin(9600);
-    radio = new XBeeRadio(xbeeSerial, 9600, -1, -1);
   #endif
   
-  if (!radio->iniciar()) {
+  if (!radio.iniciar()) {
     Serial.println("¡¡¡ERROR: Fallo al iniciar el módulo de radio!!!");
     while (true);
   }
@@ -117,8 +128,10 @@ void setup() {
 void loop() {
   //txManager decide cuándo enviar
   if (txManager.tick()) {
-    float voltage   = leerVoltajeZMPT();
-    float corriente = leerCorrienteACS();
+    ACMeterWSN::Resultado ac;
+    medirRed(ac);
+    float voltage   = ac.vrms_V;
+    float corriente = ac.irms_A;
 
     // Obtenemos el voltaje de la batería usando la librería.
     float vbat      = txManager.lastVolts();
@@ -127,17 +140,18 @@ void loop() {
     String dataPayload = "N:" + String(paquetesEnviados) +
                          " V:" + String(voltage, 2) +
                          " I:" + String(corriente, 2) +
-                         " B:" + String(vbat, 2);
+                         " B:" + String(vbat, 2) +
+                         " F:" + String(ac.frecuencia_mHz / 1000.0f, 3);
 
-    radio->enviar(dataPayload);
+    radio.enviar(dataPayload);
     
     Serial.print("Enviado (Nivel Bateria: " + String(txManager.level()) + "): ");
     Serial.println(dataPayload);
   }
 
   // --- Recepción de comandos (sin cambios) ---
-  if (radio->hayDatosDisponibles()) {
-    String comando = radio->leerComoString();
+  if (radio.hayDatosDisponibles()) {
+    String comando = radio.leerComoString();
     comando.trim();
 
     Serial.print("Comando recibido: ");
@@ -152,13 +166,8 @@ void loop() {
 }
 
 // ======================= FUNCIONES DE LECTURA DE SENSORES =======================
-float leerVoltajeZMPT() {
-  int lectura = analogRead(ZMPT_PIN);
-  return ((lectura * 5.0) / 1023.0) * 50.0; // Asume Arduino 5V 10-bit
-}
-
-float leerCorrienteACS() {
-  int lectura = analogRead(ACS_PIN);
-  float volt = (lectura * 5.0) / 1023.0; // Asume Arduino 5V 10-bit
-  return (volt - 2.5) / 0.066;
+// Ventana sincronizada a cruces por cero: 2 ciclos bastan para una lectura estable
+bool medirRed(ACMeterWSN::Resultado& ac) {
+  ac = ACMeterWSN::Resultado();
+  return medidor.measure(ac);
 }
@@ -6,14 +6,21 @@
  * necesario para cambiar a XBee con solo modificar una línea.
  */
 
+// ======================= 1. SELECCIÓN DEL MÓDULO DE RADIO =======================
+// Va antes de las librerías: Nrf24Radio.h (y con él RF24) solo se incluye con USE_NRF24
+//#define USE_LORA
+#define USE_XBEE // <-- Descomenta esta línea para usar XBee
+//#define USE_NRF24 // <-- nRF24L01 (CE=D9, CSN=D10); NODO_NRF24 = pipe 0..5 en el coordinador
+#define NODO_NRF24 0
+
 // --- LIBRERÍAS DE LA APLICACIÓN ---
 #include <SPI.h>
 #include <UniversalRadioWSN.h>
+#if defined(USE_NRF24)
+  #include <Nrf24Radio.h>       // nRF24L01: estrella multiceiver, carga dinámica
+#endif
 #include <SoftwareSerial.h> // Se incluye para la compatibilidad con XBee
-
-// ======================= 1. SELECCIÓN DEL MÓDULO DE RADIO =======================
-//#define USE_LORA
-#define USE_XBEE // <-- Descomenta esta línea para usar XBee
+#include "ACMeterWSN.h"     // True-RMS sincronizado a cruces por cero
 
 // ======================= CONFIGURACIÓN GENERAL DE PINES =======================
 #define RELAY_PIN 4
@@ -22,7 +29,7 @@
 #define VBAT_PIN  A2
 
 // ======================= OBJETOS Y VARIABLES GLOBALES =======================
-RadioInterface* radio;
+ACMeterWSN medidor;
 
 unsigned long previousMillis = 0;
 const unsigned long INTERVAL_MS = 3000;
@@ -33,6 +40,31 @@ uint32_t paquetesEnviados = 0;
   SoftwareSerial xbeeSerial(2, 3); // RX Pin = 2, TX Pin = 3
 #endif
 
+// --- Radio elegido en compilación: sin new, sin vtable, llamadas directas ---
+#if defined(USE_LORA)
+  const LoRaConfig configLora = {
+    410000000L, // frequency
+    20,         // txPower
+    7,          // spreadingFactor
+    125000L,    // signalBandwidth
+    5,          // codingRate
+    0xF3,       // syncWord
+    10,         // csPin
+    -1,         // resetPin
+    2           // irqPin
+  };
+  UniversalRadio<LoraRadio> radio(configLora);
+#elif defined(USE_XBEE)
+  UniversalRadio<XBeeRadio> radio(xbeeSerial, 9600, -1, -1);
+#elif defined(USE_NRF24)
+  Nrf24Config configurarNrf24() {
+    Nrf24Config config(9, 10);   // CE, CSN
+    config.nodo = NODO_NRF24;
+    return config;
+  }
+  UniversalRadio<Nrf24Radio> radio(configurarNrf24());
+#endif
+
 // ======================= SETUP =======================
 void setup() {
   pinMode(RELAY_PIN, OUTPUT);
@@ -42,36 +74,27 @@ void setup() {
   while(!Serial);
   Serial.println("\n--- INICIANDO EMISOR UNIVERSAL ---");
 
+  ACMeterWSN::Cfg configAc;
+  configAc.pinV   = ZMPT_PIN;
+  configAc.pinI   = ACS_PIN;
+  configAc.ciclos = 2;
+  medidor.begin(configAc);
+
   // --- INYECCIÓN DE DEPENDENCIA DEL RADIO ---
   Serial.print("Configurando radio: ");
   
   #if defined(USE_LORA)
     Serial.println("LoRa");
 
-    LoRaConfig configLora;
-    configLora.frequency        = 410E6;
-    configLora.spreadingFactor  = 7;
-    configLora.signalBandwidth  = 125E3;
-    configLora.codingRate       = 5;
-    configLora.syncWord         = 0xF3;
-    configLora.txPower          = 20;
-
-    configLora.csPin            = 10;
-    configLora.resetPin         = -1;
-    configLora.irqPin           = 2;
-
-    radio = new LoraRadio(configLora);
-
   #elif defined(USE_XBEE)
     // --- ESTE BLOQUE ESTÁ LISTO PERO INACTIVO ---
     Serial.println("XBee");
     xbeeSerial.begin(9600); // Inicia el puerto serial para el XBee
-    // Crea la instancia de radio para XBee
-    radio = new XBeeRadio(xbeeSerial, 9600, -1, -1);
-
+  #elif defined(USE_NRF24)
+    Serial.println("nRF24L01");
   #endif
   
-  if (!radio->iniciar()) {
+  if (!radio.iniciar()) {
     Serial.println("¡¡¡ERROR: Fallo al iniciar el módulo de radio!!!");
     while (true);
   }
@@ -85,47 +108,92 @@ void loop() {
   if (currentMillis - previousMillis >= INTERVAL_MS) {
     previousMillis = currentMillis;
 
-    float voltage = leerVoltajeZMPT();
-    float corriente = leerCorrienteACS();
+    ACMeterWSN::Resultado ac;
+    medirRed(ac);
+    float voltage = ac.vrms_V;
+    float corriente = ac.irms_A;
     float vbat = leerVoltajeBateria();
     paquetesEnviados++;
 
-    String dataPayload = "N:" + String(paquetesEnviados) +
-                         " V:" + String(voltage, 2) +
-                         " I:" + String(corriente, 2) +
-                         " B:" + String(vbat, 2);
+    // La línea se arma en un buffer fijo: sin concatenar String (ni heap) por paquete
+    char linea[64] = "N:";
+    size_t n = strlen(ultoa(paquetesEnviados, linea + 2, 10)) + 2;
+    #if defined(USE_NRF24)
+      // 32 bytes por paquete: sin F: y con V y B a un decimal, "N:999999 V:250.0 I:30.00 B:15.0\n"
+      // ocupa 32; con N de 7 dígitos o más (o lecturas fuera de rango) ya no cabe
+      n = agregarCampo(linea, n, " V:", voltage, 1);
+      n = agregarCampo(linea, n, " I:", corriente, 2);
+      n = agregarCampo(linea, n, " B:", vbat, 1);
+    #else
+      n = agregarCampo(linea, n, " V:", voltage, 2);
+      n = agregarCampo(linea, n, " I:", corriente, 2);
+      n = agregarCampo(linea, n, " B:", vbat, 2);
+      n = agregarCampo(linea, n, " F:", ac.frecuencia_mHz / 1000.0f, 3);
+    #endif
+    linea[n++] = '\n';
+
+    #if defined(USE_NRF24)
+      if (n > Nrf24Backend::MAX_CARGA) {
+        Serial.print("Línea de ");
+        Serial.print(n);
+        Serial.println(" bytes: no cabe en un paquete nRF24, no se envía");
+        n = 0;
+      }
+    #endif
+    if (n > 0) {
+      radio.enviar(reinterpret_cast<const uint8_t*>(linea), n);
+      Serial.print("Enviado: ");
+      Serial.write(linea, n);
+    }
 
-    radio->enviar(dataPayload + "\n");
-    
-    Serial.print("Enviado: ");
-    Serial.println(dataPayload);
+    if (paquetesEnviados % 20 == 0) imprimirEnlace(radio.estadisticasEnlace());
   }
 
-  if (radio->hayDatosDisponibles()) {
-    String comando = radio->leerComoString();
-    comando.trim();
-
+  uint8_t comando[16];
+  BufferRx rx(comando);
+  size_t n = radio.recibirEn(rx);
+  while (n > 0 && (comando[n - 1] == '\n' || comando[n - 1] == '\r' || comando[n - 1] == ' ')) n--;
+  if (n > 0) {
     Serial.print("Comando recibido: ");
-    Serial.println(comando);
+    Serial.write(comando, n);
+    Serial.println();
 
-    if (comando == "ON") {
+    if (n == 2 && memcmp(comando, "ON", 2) == 0) {
       digitalWrite(RELAY_PIN, HIGH);
-    } else if (comando == "OFF") {
+    } else if (n == 3 && memcmp(comando, "OFF", 3) == 0) {
       digitalWrite(RELAY_PIN, LOW);
     }
   }
 }
 
-// ======================= FUNCIONES DE LECTURA DE SENSORES =======================
-float leerVoltajeZMPT() {
-  int lectura = analogRead(ZMPT_PIN);
-  return ((lectura * 5.0) / 1023.0) * 50.0;
+// Agrega "clave" + valor con los decimales pedidos; devuelve la nueva longitud
+size_t agregarCampo(char* linea, size_t n, const char* clave, float valor, uint8_t decimales) {
+  strcpy(linea + n, clave);
+  n += strlen(clave);
+  dtostrf(valor, 1, decimales, linea + n);
+  return n + strlen(linea + n);
 }
 
-float leerCorrienteACS() {
-  int lectura = analogRead(ACS_PIN);
-  float volt = (lectura * 5.0) / 1023.0;
-  return (volt - 2.5) / 0.066;
+// Resumen del enlace cada 20 paquetes (lo que el radio reporta; lo demás sale en 0)
+void imprimirEnlace(const LinkStats& enlace) {
+  Serial.print("Enlace: TX ");
+  Serial.print(enlace.enviados);
+  Serial.print(" ok / ");
+  Serial.print(enlace.fallosTx);
+  Serial.print(" fallos, aire ");
+  Serial.print(enlace.aireTx_ms);
+  Serial.print(" ms, RX ");
+  Serial.print(enlace.recibidos);
+  Serial.print(" (RSSI prom ");
+  Serial.print(enlace.rssiPromedio_dBm);
+  Serial.println(" dBm)");
+}
+
+// ======================= FUNCIONES DE LECTURA DE SENSORES =======================
+// Ventana sincronizada a cruces por cero: 2 ciclos bastan para una lectura estable
+bool medirRed(ACMeterWSN::Resultado& ac) {
+  ac = ACMeterWSN::Resultado();
+  return medidor.measure(ac);
 }
 
 float leerVoltajeBateria() {
@@ -9,13 +9,18 @@
  * en la sección "SELECCIÓN DEL MÓDULO DE RADIO".
  */
 
-// --- 1. LIBRERÍAS ---
-#include <SPI.h> // Incluimos SPI porque es necesario para LoRa
-#include "UniversalRadioWSN.h" // Nuestra librería principal
-
-// --- 2. SELECCIÓN DEL MÓDULO DE RADIO ---
+// --- 1. SELECCIÓN DEL MÓDULO DE RADIO ---
+// Va antes de las librerías: Nrf24Radio.h (y con él RF24) solo se incluye con USE_NRF24
 #define USE_XBEE // <-- MODO ACTUAL
 //#define USE_LORA // <-- Descomenta esta línea para usar LoRa
+//#define USE_NRF24 // <-- nRF24L01 (CE=4, CSN=5), escucha los 6 pipes
+
+// --- 2. LIBRERÍAS ---
+#include <SPI.h> // Incluimos SPI porque es necesario para LoRa
+#include "UniversalRadioWSN.h" // Nuestra librería principal
+#if defined(USE_NRF24)
+  #include "Nrf24Radio.h"      // nRF24L01 como coordinador de hasta 6 nodos
+#endif
 
 // --- 3. CONFIGURACIÓN DE PINES ---
 // Pines para XBee (usando Serial2 en ESP32)
@@ -24,6 +29,16 @@
 
 // --- 4. OBJETOS GLOBALES ---
 RadioInterface* radio; // Puntero a la interfaz. No le importa si es XBee o LoRa.
+uint8_t  bufferRx[128];   // El radio escribe aquí directamente (sin String ni heap por paquete)
+BufferRx rx(bufferRx);
+
+#if defined(USE_LORA)
+  // RX continuo por interrupción: la ISR guarda cada paquete (con RSSI/SNR) aunque
+  // loop() esté ocupado imprimiendo; loop() los saca completos del anillo
+  const int LORA_CS_PIN = 5;
+  LoraRxAnillo<8, 128> anillo;
+  LoraTxAsincrono<2, 16> colaTx;   // las respuestas no pueden usar el envío bloqueante con RX por IRQ
+#endif
 
 // ======================= SETUP =======================
 void setup() {
@@ -60,12 +75,18 @@ void setup() {
     configLora.txPower         = 20; 
 
     // --- PINES ACTUALIZADOS SEGÚN TU HARDWARE ---
-    configLora.csPin           = 5;   // Tu pin NSS va aquí
+    configLora.csPin           = LORA_CS_PIN;   // Tu pin NSS va aquí
     configLora.irqPin          = 2;   // Tu pin DIO0 va aquí
     configLora.resetPin        = -1;   // ¡IMPORTANTE! No especificaste un pin de RESET. 
                                       // Usualmente es el pin 9 o 4. Verifica tu cableado.
     // Creamos el objeto LoraRadio con su configuración
     radio = new LoraRadio(configLora);
+
+  #elif defined(USE_NRF24)
+    Serial.println("nRF24L01");
+    Nrf24Config configNrf(4, 5);   // CE, CSN
+    configNrf.esCoordinador = true;
+    radio = new Nrf24Radio(configNrf);
   #endif
   
   // Este código es común para AMBOS módulos.
@@ -74,6 +95,10 @@ void setup() {
     Serial.println("¡ERROR! Fallo al iniciar el módulo de radio.");
     while (true); // Detiene la ejecución
   }
+  #if defined(USE_LORA)
+    anillo.begin(LORA_CS_PIN);
+    colaTx.begin(configLora, 1000, true);   // al terminar cada TX vuelve a RX continuo
+  #endif
   
   Serial.println("Módulo de radio inicializado. Esperando datos...");
 }
@@ -82,17 +107,36 @@ void setup() {
 // ¡OBSERVA! El loop no necesita ningún cambio.
 // Funciona exactamente igual para XBee y para LoRa.
 void loop() {
-  if (radio->hayDatosDisponibles()) {
-    
-    String datosRecibidos = radio->leerComoString();
-    datosRecibidos.trim();
+  #if defined(USE_LORA)
+    colaTx.atender();
+    size_t n = anillo.recibirEn(rx);
+  #else
+    size_t n = radio->recibirEn(rx);
+  #endif
+  while (n > 0 && (bufferRx[n - 1] == '\n' || bufferRx[n - 1] == '\r')) n--;   // trim del final
 
-    if (datosRecibidos.length() > 0) {
-      Serial.print("Línea recibida: --> ");
-      Serial.println(datosRecibidos);
+  if (n > 0) {
+    Serial.print("Línea recibida: --> ");
+    Serial.write(bufferRx, n);
+    Serial.print("  (RSSI ");
+    Serial.print(rx.meta.rssi_dBm);
+    Serial.print(" dBm, origen ");
+    Serial.print(rx.meta.origen);   // MY del XBee API / pipe del nRF24
+    Serial.print(")");
+    #if defined(USE_LORA)
+      Serial.print("  SNR ");
+      Serial.print(rx.meta.snr_cuartos_dB / 4.0f, 2);
+      Serial.print("  descartados ");
+      Serial.print(anillo.descartados());
+    #endif
+    Serial.println();
 
-      // Usamos la interfaz para enviar una respuesta
-      radio->enviar("ON\n");
-    }
+    // Usamos la interfaz para enviar una respuesta
+    static const uint8_t RESPUESTA[] = { 'O', 'N', '\n' };
+    #if defined(USE_LORA)
+      colaTx.encolar(RESPUESTA, sizeof(RESPUESTA));
+    #else
+      radio->enviar(RESPUESTA, sizeof(RESPUESTA));
+    #endif
   }
 }
\ No newline at end of file
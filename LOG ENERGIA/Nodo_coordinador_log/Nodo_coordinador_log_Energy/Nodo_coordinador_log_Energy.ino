@@ -1,47 +1,190 @@
 #define RXD2 16  // Conectado al TX del XBee
 #define TXD2 17  // Conectado al RX del XBee
 
-float voltaje = 0.0;
-float corriente = 0.0;
+#include <ReglasWSN.h>
+
+// Reglas de control (antes: if (V < 190 || V > 250 || I < 0.1) OFF else ON, en cada trama).
+// nodo variable<|>umbral [h histéresis] [t segundos que debe sostenerse] acción
+// Ver ReglasWSN.h.
+// Entrega de comandos: el XBee va en modo AT (difusión) y el sensor solo escucha un momento
+// justo después de transmitir, así que el comando va dirigido ("Nodo1|OFF"; cada sensor
+// descarta los que no llevan su nombre) y se manda como respuesta a cada trama del nodo
+// mientras el estado del relé que reporta (campo R:) no coincida con la salida de sus reglas.
+const char* const VARIABLES[] = { "V", "I", "B", "P", "FP" };
+const uint8_t N_VARIABLES = sizeof(VARIABLES) / sizeof(VARIABLES[0]);
+const char* REGLAS =
+    "defecto ON\n"
+    "*  V<190  h2     t3  OFF\n"
+    "*  V>250  h2     t3  OFF\n"
+    "*  I<0.1  h0.02  t3  OFF\n";
+const uint32_t REVISION_MS = 1000;  // latidos y permanencias vencidas, sin bloquear el loop
+
+// Los nodos reportan por excepción: el silencio dentro del latido (campo H:) significa
+// "sin cambios" y los últimos valores siguen vigentes. Un nodo solo se declara caído
+// cuando pasan TOLERANCIA_LATIDOS latidos sin oír nada de él.
+const uint8_t  MAX_NODOS          = 8;
+const uint8_t  TOLERANCIA_LATIDOS = 2;    // admite perder un latido antes de alarmar
+const uint32_t LATIDO_DEFECTO_MS  = 3000; // nodos sin campo H: (envío periódico clásico)
+
+struct EstadoNodo {
+  String   nombre;
+  bool     usado    = false;
+  bool     vivo     = false;
+  long     ultimoN  = -1;
+  uint32_t ultimoMs = 0;
+  uint32_t latidoMs = LATIDO_DEFECTO_MS;
+  int8_t   rele     = -1;           // R: de su última trama (-1 = no lo reporta)
+};
+EstadoNodo nodos[MAX_NODOS];
+ReglasWSN<8, MAX_NODOS> reglas;     // mismo índice de nodo que la tabla de arriba
+
+char     lineaRx[96];
+uint8_t  largoRx = 0;
+uint32_t ultimaRevision = 0;
+
+EstadoNodo* buscarNodo(const String& nombre) {
+  for (uint8_t k = 0; k < MAX_NODOS; ++k)
+    if (nodos[k].usado && nodos[k].nombre == nombre) return &nodos[k];
+  for (uint8_t k = 0; k < MAX_NODOS; ++k)
+    if (!nodos[k].usado) {
+      nodos[k].usado = true;
+      nodos[k].nombre = nombre;
+      reglas.asignarNodo(k, nombre.c_str());
+      return &nodos[k];
+    }
+  return nullptr;   // tabla llena
+}
+
+// Valor entero de un campo "CLAVE:valor" (toInt() se detiene en el siguiente espacio)
+long campoEntero(const String& data, const char* clave, long defecto) {
+  int idx = data.indexOf(clave);
+  if (idx < 0) return defecto;
+  return data.substring(idx + strlen(clave)).toInt();
+}
+
+// Campo "CLAVE:valor" en milésimas (como lo usa ReglasWSN). La clave debe ir al inicio o
+// tras ' ' o '|', para que "P:" no se confunda con el final de "FP:".
+bool campoMilesimas(const char* data, const char* clave, int32_t& out) {
+  const size_t largo = strlen(clave);
+  for (const char* p = strstr(data, clave); p; p = strstr(p + 1, clave)) {
+    if ((p != data && p[-1] != ' ' && p[-1] != '|') || p[largo] != ':') continue;
+    const char* v = p + largo + 1;
+    return ReglasWSN<>::milesimas(v, v + strlen(v), out);
+  }
+  return false;
+}
+
+// Registra el paquete en la tabla de nodos; devuelve el índice del nodo o -1 si no cabe
+int8_t registrarPaquete(const String& data) {
+  int sep = data.indexOf('|');
+  EstadoNodo* nodo = buscarNodo(sep > 0 ? data.substring(0, sep) : String("?"));
+  if (!nodo) return -1;
+  const int8_t indice = (int8_t)(nodo - nodos);
+
+  long latido_s = campoEntero(data, " H:", 0);
+  nodo->latidoMs = (latido_s > 0) ? (uint32_t)latido_s * 1000UL : LATIDO_DEFECTO_MS;
+
+  // N solo avanza con envíos reales: un hueco es pérdida en el enlace, no supresión
+  long n = campoEntero(data, "N:", -1);
+  if (nodo->ultimoN >= 0 && n > nodo->ultimoN + 1)
+    Serial.println("[PERDIDA] " + nodo->nombre + " " + String(n - nodo->ultimoN - 1) + " paquete(s)");
+  if (nodo->ultimoN >= 0 && !nodo->vivo) {
+    Serial.println("[VIVO] " + nodo->nombre + " volvió a reportar");
+    reglas.olvidarSalida(indice);   // pudo reiniciarse: se le repite el estado del relé
+  }
+  nodo->ultimoN  = n;
+  nodo->rele     = (int8_t)campoEntero(data, " R:", -1);
+  nodo->ultimoMs = millis();
+  nodo->vivo     = true;
+  return indice;
+}
+
+// La salida de las reglas cambió: se anota; sale en la ventana tras la próxima trama del nodo
+void anotarCambio(int8_t indice, int8_t salida) {
+  if (salida == ReglasWSN<>::SIN_CAMBIO) return;
+  Serial.println(">>  Reglas: " + nodos[indice].nombre + " -> " + (salida == ReglasWSN<>::ON ? "ON" : "OFF"));
+}
+
+// Respuesta a una trama del nodo: repite el comando hasta que su R: lo confirme
+void enviarComando(int8_t indice) {
+  const int8_t salida = reglas.salida(indice);
+  if (salida == ReglasWSN<>::SIN_CAMBIO || nodos[indice].rele == salida) return;
+  const char* cmd = salida == ReglasWSN<>::ON ? "ON" : "OFF";
+  Serial2.print(nodos[indice].nombre);
+  Serial2.print('|');
+  Serial2.println(cmd);
+  Serial.println(">>  Enviando comando: " + nodos[indice].nombre + "|" + cmd);
+}
+
+void procesarLinea(const String& data) {
+  // Validar que sea un paquete válido tipo: V:xx.xx I:yy.yy
+  if (data.indexOf('V') == -1 || data.indexOf('I') == -1) return;   // formato no válido: se ignora
+
+  Serial.println(" Datos recibidos: " + data);
+  const int8_t indice = registrarPaquete(data);
+  if (indice < 0) return;
+
+  int32_t  valores[N_VARIABLES];
+  uint32_t presentes = 0;
+  for (uint8_t k = 0; k < N_VARIABLES; ++k)
+    if (campoMilesimas(data.c_str(), VARIABLES[k], valores[k])) presentes |= 1UL << k;
+
+  anotarCambio(indice, reglas.evaluar(indice, valores, presentes, millis()));
+  enviarComando(indice);            // el sensor escucha justo después de transmitir
+}
+
+// Permanencias que vencen entre tramas (los nodos callan mientras nada cambia)
+void revisarReglas() {
+  for (uint8_t k = 0; k < MAX_NODOS; ++k)
+    if (nodos[k].usado) anotarCambio(k, reglas.revisar(k, millis()));
+}
+
+void revisarLatidos() {
+  uint32_t ahora = millis();
+  for (uint8_t k = 0; k < MAX_NODOS; ++k) {
+    EstadoNodo& nodo = nodos[k];
+    if (!nodo.vivo) continue;
+    if (ahora - nodo.ultimoMs > TOLERANCIA_LATIDOS * nodo.latidoMs) {
+      nodo.vivo = false;
+      Serial.println("[CAIDO] " + nodo.nombre + " sin latido desde hace " +
+                     String((ahora - nodo.ultimoMs) / 1000UL) + " s");
+    }
+  }
+}
 
 void setup() {
   Serial.begin(115200); // Comunicación con PC
   Serial2.begin(9600, SERIAL_8N1, RXD2, TXD2); // UART2 para XBee
   Serial.println("Nodo Coordinador ESP32 iniciado");
   Serial.println("encendido  Nodo Coordinador Energy\n");
+  if (!reglas.cargar(REGLAS, VARIABLES, N_VARIABLES)) {
+    Serial.print("[REGLAS] error en la línea ");
+    Serial.println(reglas.lineaError());
+  } else {
+    Serial.print("[REGLAS] ");
+    Serial.print(reglas.reglas());
+    Serial.println(" regla(s) cargadas");
+  }
 }
 
 void loop() {
-  if (Serial2.available()) {
-    String data = Serial2.readStringUntil('\n');
-    data.trim(); // Limpia espacios y saltos
-
-    // Validar que sea un paquete válido tipo: V:xx.xx I:yy.yy
-    if (data.indexOf('V') != -1 && data.indexOf('I') != -1) {
-      Serial.println(" Datos recibidos: " + data);
-
-      int idxV = data.indexOf('V');
-      int idxI = data.indexOf('I');
-
-      float v = data.substring(idxV + 2, idxI - 1).toFloat();
-      float i = data.substring(idxI + 2).toFloat();
-
-      voltaje = v;
-      corriente = i;
-
-      // Lógica de decisión
-      if (voltaje < 190 || voltaje > 250 || corriente < 0.1) {
-        Serial2.println("OFF");
-        Serial.println(">>  Enviando comando: OFF");
-      } else {
-        Serial2.println("ON");
-        Serial.println(">>  Enviando comando: ON");
-      }
-    } else {
-      // Si no es un dato con formato válido, lo ignoramos
+  // Sin readStringUntil ni delay: se junta la línea byte a byte y el loop nunca espera
+  while (Serial2.available()) {
+    char c = (char)Serial2.read();
+    if (c == '\n') {
+      lineaRx[largoRx] = '\0';
+      String data(lineaRx);
+      data.trim(); // Limpia espacios y saltos
+      procesarLinea(data);
+      largoRx = 0;
+    } else if (largoRx < sizeof(lineaRx) - 1) {
+      lineaRx[largoRx++] = c;
     }
   }
 
-  delay(1000); // Espera para evitar saturar la UART
+  if (millis() - ultimaRevision >= REVISION_MS) {
+    ultimaRevision = millis();
+    revisarLatidos();
+    revisarReglas();
+  }
 }
-
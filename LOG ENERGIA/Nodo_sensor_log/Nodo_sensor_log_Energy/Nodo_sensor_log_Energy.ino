@@ -3,6 +3,9 @@
 #include <SoftwareSerial.h>
 #include <LowPower.h>
 #include "EnergyWSN.h"   // Tu librería de ahorro energético
+#include "SchedulerWSN.h" // Planificador sin tick (duerme hasta el próximo plazo)
+#include "ACMeterWSN.h"   // True-RMS por Timer1 + ADC (ZMPT/ACS)
+#include "ReportByExceptionWSN.h" // Solo transmite si algo cambió o vence el latido
 
 // ---------------- UART hacia XBee ----------------
 SoftwareSerial xbeeSerial(2, 3);   // D2=RX, D3=TX
@@ -21,11 +24,21 @@ const uint8_t PIN_PWR_SENS = 7;   // → MOSFET/load-switch de sensores (HIGH=ON
 
 // ---------------- Instancia de EnergyWSN ----------
 EnergyWSN energy;
+SchedulerWSN<4> sched;
+ACMeterWSN medidor;
+
+// Canales del reporte por excepción (enteros): V en centésimas, I en mA, B en centésimas, P en W
+enum { CANAL_V, CANAL_I, CANAL_B, CANAL_P, N_CANALES };
+ReportByExceptionWSN<N_CANALES> reporte;
 
 // ---------------- Variables ----------------------
 File logFile;
 int paquetesEnviados = 0;
 const unsigned long INTERVAL_MS = 2000;   
+const unsigned long LATIDO_MS   = 60000;  // silencio máximo; el coordinador lo recibe en el campo H:
+const char     NOMBRE_NODO[] = "Nodo1";   // va en cada trama; el coordinador lo usa para dirigir comandos
+const uint16_t ESCUCHA_MS    = 150;       // ventana tras cada TX: el coordinador responde a esa trama
+bool releEncendido = false;               // se reporta en R: hasta que el coordinador lo ve
 
 // ---------------- SETUP --------------------------
 void setup() {
@@ -45,78 +58,149 @@ void setup() {
   cfg.pins = { PIN_SLEEP_RQ, PIN_ON_SLEEP, PIN_PWR_SENS, -1 }; // no usamos VBAT interno aún
   cfg.invertPwr = true;   // pon true si tu MOSFET se activa en LOW
   cfg.bootSleep = false;    // arranca dormido
+  cfg.settle_us = 2000;     // ZMPT/ACS estables ~2 ms tras energizar
   energy.begin(cfg);
 
+  // Medidor AC: 4 ciclos de 60 Hz (~67 ms)
+  ACMeterWSN::Cfg cfgAc;
+  cfgAc.pinV   = ZMPT_PIN;
+  cfgAc.pinI   = ACS_PIN;
+  cfgAc.ciclos = 4;
+  medidor.begin(cfgAc);
+
+  // Banda muerta: ±2 V, ±50 mA, ±0.10 V de batería, ±10 W
+  ReportByExceptionWSN<N_CANALES>::Cfg cfgRbe;
+  cfgRbe.bandaMuerta[CANAL_V] = 200;
+  cfgRbe.bandaMuerta[CANAL_I] = 50;
+  cfgRbe.bandaMuerta[CANAL_B] = 10;
+  cfgRbe.bandaMuerta[CANAL_P] = 10;
+  cfgRbe.latido_ms = LATIDO_MS;
+  reporte.begin(cfgRbe);
+
+  // Lista de tareas: el micro duerme entre plazos con EnergyWSN
+  sched.begin(dormirNodo);
+  sched.every(INTERVAL_MS, cicloMedicion);
+
   Serial.println("Nodo Esclavo optimizado (AT + EnergyWSN)");
 }
 
 // ---------------- LOOP ---------------------------
 void loop() {
-  digitalWrite(5, HIGH);
-  // 1) Despertar XBee + Sensores
- 
-  if (!energy.wakeRadio(20)) {
-  Serial.println("[WARN] XBee no confirmó awake");
-} else {
-  Serial.println("Xbee on");
+  sched.run();
 }
 
-  energy.powerSensors(true);
+// ---------------- TAREAS -------------------------
+uint32_t dormirNodo(uint32_t ms) {
+  Serial.flush();               // vaciar la consola antes de apagar el reloj
+  return energy.sleepFor_ms(ms);
+}
 
-  //delay(30);
-  
+void cicloMedicion(void*) {
+  digitalWrite(5, HIGH);
+  // 1) Si el envío es seguro (primer reporte o latido vencido) el XBee despierta en
+  //    paralelo y se mide mientras tanto; si no, solo los sensores: el XBee sigue
+  //    dormido hasta saber si hay que enviar
+  bool envioSeguro = reporte.mustReport(sched.now());
+  if (envioSeguro) energy.startWake();
+  else             energy.startSensors();
+  energy.awaitSensors();
 
   // 2) Medir
-  float voltage   = leerVoltajeZMPT();
-  float corriente = leerCorrienteACS();
+  ACMeterWSN::Resultado ac = {};
+  if (!medidor.measure(ac)) Serial.println(F("[WARN] Ventana AC incompleta"));
+  float voltage   = ac.vrms_V;
+  float corriente = ac.irms_A;
   float vbat      = leerVoltajeBateria();
-  
+  energy.mark(EnergyWSN::PH_MEASURED);
   energy.powerSensors(false);
-  Serial.println("Leímos");
 
-  // 3) Enviar datos al coordinador (AT, delimitador '|')
+  // 3) Reporte por excepción: dentro de la banda muerta y antes del latido no se despierta el radio
+  int32_t valores[N_CANALES];
+  valores[CANAL_V] = lroundf(voltage * 100.0f);
+  valores[CANAL_I] = lroundf(corriente * 1000.0f);
+  valores[CANAL_B] = lroundf(vbat * 100.0f);
+  valores[CANAL_P] = lroundf(ac.potenciaReal_W);
+  if (!reporte.check(valores, sched.now())) {
+    digitalWrite(5, LOW);
+    return;
+  }
+
+  // 4) Transmitir (AT, delimitador '|'); N solo avanza con envíos reales, así un hueco es pérdida
+  if (!envioSeguro) energy.wakeRadio(200);          // SLEEP_RQ recién ahora
+  if (!energy.awaitRadio(200)) Serial.println(F("[WARN] XBee no confirmó awake"));
   paquetesEnviados++;
-  xbeeSerial.print(F("Nodo1|"));
+  xbeeSerial.print(NOMBRE_NODO); xbeeSerial.print('|');
   xbeeSerial.print(F("N:")); xbeeSerial.print(paquetesEnviados);
   xbeeSerial.print(F(" V:")); xbeeSerial.print(voltage, 2);
   xbeeSerial.print(F(" I:")); xbeeSerial.print(corriente, 2);
-  xbeeSerial.print(F(" B:")); xbeeSerial.println(vbat, 2);
+  xbeeSerial.print(F(" B:")); xbeeSerial.print(vbat, 2);
+  xbeeSerial.print(F(" P:")); xbeeSerial.print(ac.potenciaReal_W, 1);
+  xbeeSerial.print(F(" FP:")); xbeeSerial.print(ac.factorPotencia, 2);
+  xbeeSerial.print(F(" R:")); xbeeSerial.print(releEncendido ? 1 : 0);
+  xbeeSerial.print(F(" H:")); xbeeSerial.println(LATIDO_MS / 1000UL);
+  energy.mark(EnergyWSN::PH_TX);
+  reporte.commit(valores, sched.now());
+
+  // Único momento con el XBee despierto: aquí llegan los comandos del coordinador
+  escucharComandos(ESCUCHA_MS);
+
+  // 5) Dormir XBee
+  if (!energy.sleepRadio(200)) Serial.println(F("[WARN] XBee no confirmó sleep"));
+  energy.mark(EnergyWSN::PH_SLEEP);
 
-  // Log en SD
-  String fecha_hora = obtenerFechaHora();
-  
+  // Consola fuera de la ruta crítica: el radio ya está dormido
   Serial.print("Paquete "); Serial.print(paquetesEnviados);
+  Serial.print(reporte.reason() == ReportByExceptionWSN<N_CANALES>::REASON_HEARTBEAT ? F(" (latido)") : F(" (cambio)"));
   Serial.print(" -> V="); Serial.print(voltage, 2);
   Serial.print(F(" I=")); Serial.print(corriente, 2);
-  Serial.print(F(" B=")); Serial.println(vbat, 2);
-
-  // 4) Apagar sensores + dormir XBee
-  //delay(5000);
-  
-  
-  //energy.powerSensors(false); PROBAR
-  if (!energy.sleepRadio(200)) Serial.println(F("[WARN] XBee no confirmó sleep"));
-
-  // 5) Dormir el micro hasta el siguiente ciclo
-  
+  Serial.print(F(" B=")); Serial.print(vbat, 2);
+  Serial.print(F(" P=")); Serial.print(ac.potenciaReal_W, 1);
+  Serial.print(F(" S=")); Serial.print(ac.potenciaAparente_VA, 1);
+  Serial.print(F(" FP=")); Serial.print(ac.factorPotencia, 2);
+  Serial.print(F(" suprimidos=")); Serial.println(reporte.suppressed());
+  energy.printTiming(Serial);
+
+  // 6) El planificador duerme el micro hasta el siguiente ciclo
   digitalWrite(5, LOW);
-  energy.sleepFor_ms(INTERVAL_MS);
-  
 }
 
-// ---------------- FUNCIONES DE MEDICIÓN ----------------
-float leerVoltajeZMPT() {
-  int lectura = analogRead(ZMPT_PIN);
-  float voltaje = lectura * 5.0 / 1023.0;
-  return voltaje * 50.0; // calibra según tu módulo
+// ---------------- COMANDOS DEL COORDINADOR ---------------
+// El coordinador difunde "Nodo|ON" / "Nodo|OFF" (XBee AT); se aplican solo los de este nodo
+void escucharComandos(uint16_t ventana_ms) {
+  char linea[24];
+  uint8_t n = 0;
+  uint32_t t0 = millis();
+  while (millis() - t0 < ventana_ms) {
+    if (!xbeeSerial.available()) continue;
+    char c = (char)xbeeSerial.read();
+    if (c == '\r') continue;
+    if (c != '\n') {
+      if (n < sizeof(linea) - 1) linea[n++] = c;
+      continue;
+    }
+    linea[n] = '\0';
+    n = 0;
+    aplicarComando(linea);
+  }
 }
 
-float leerCorrienteACS() {
-  int lectura = analogRead(ACS_PIN);
-  float v = lectura * 5.0 / 1023.0;
-  return (v - 2.5) / 0.066; // ACS712 30A
+void aplicarComando(const char* linea) {
+  const size_t largo = strlen(NOMBRE_NODO);
+  if (strncmp(linea, NOMBRE_NODO, largo) != 0 || linea[largo] != '|') return;   // es para otro nodo
+  const char* cmd = linea + largo + 1;
+  bool encender;
+  if      (strcmp(cmd, "ON") == 0)  encender = true;
+  else if (strcmp(cmd, "OFF") == 0) encender = false;
+  else return;
+  if (encender != releEncendido) {
+    releEncendido = encender;
+    digitalWrite(RELAY_PIN, encender ? HIGH : LOW);
+  }
+  reporte.invalidate();   // el próximo ciclo manda el R: nuevo y el coordinador deja de repetir
+  Serial.print(F("Comando: ")); Serial.println(cmd);
 }
 
+// ---------------- FUNCIONES DE MEDICIÓN ----------------
 float leerVoltajeBateria() {
   int lectura = analogRead(VBAT_PIN);
   float v = lectura * 5.0 / 1023.0;
@@ -1,5 +1,6 @@
 #include <SPI.h>
 #include <SD.h>
+#include <EtapasWSN.h>   // ColaSPSC, HistogramaLatencia, EtapaWSN
 
 // UART para XBee (ESP32)
 #define RXD2 16
@@ -9,59 +10,76 @@
 const uint8_t SD_CS = 5;
 
 File logFile;
-unsigned long lastFlush = 0;
 const unsigned long FLUSH_MS = 30000;
-uint32_t paquetesRecibidos = 0;
+const unsigned long ESTADISTICAS_MS = 60000;
+
+// ---- Tubería por etapas ----
+// Antes todo corría en loop(): mientras la SD escribía o la consola imprimía, el UART
+// se llenaba y se perdían tramas. Ahora cada etapa es una tarea y se pasan registros
+// por colas SPSC; si una etapa lenta llena su cola se descartan registros (contados),
+// pero la recepción nunca espera.
+//   núcleo 0: rx (UART -> líneas)          control (respuesta al sensor)
+//   núcleo 1: decod (línea -> registro)    registro (consola + SD)
+struct Linea {
+  uint32_t recibido_us;      // sello del '\n': de aquí se mide la latencia de cada etapa
+  uint32_t recibido_ms;
+  char     texto[60];
+};
+
+struct Registro {
+  uint32_t      recibido_us;
+  uint32_t      recibido_ms;
+  unsigned long id;
+  float         vred, iamp, vbat;
+  bool          ok;
+};
+
+ColaSPSC<Linea, 16>    colaLineas;      // rx -> decod
+ColaSPSC<Registro, 64> colaRegistro;    // decod -> registro (la SD puede tardar cientos de ms)
+ColaSPSC<Registro, 16> colaControl;     // decod -> control
+
+EtapaWSN etapaRx("rx"), etapaDecod("decod"), etapaRegistro("registro"), etapaControl("control");
+uint32_t lineasTruncadas = 0;          // solo la escribe rx
 
 // ---- Utilidades ----
-String obtenerFechaHora() {
-  unsigned long segundos = millis() / 1000;
+// Fecha del momento de recepción (no del momento en que se imprime)
+void obtenerFechaHora(uint32_t ms, char* buf, size_t n) {
+  unsigned long segundos = ms / 1000;
   int hh = 12 + (segundos / 3600) % 12;
   int mm = (segundos / 60) % 60;
   int ss = segundos % 60;
-  char buf[20];
-  sprintf(buf, "2025-06-03 %02d:%02d:%02d", hh, mm, ss);
-  return String(buf);
+  snprintf(buf, n, "2025-06-03 %02d:%02d:%02d", hh, mm, ss);
 }
 
-// Busca "clave:" y obtiene el valor hasta el siguiente espacio o fin de línea.
-// Devuelve true si encontró y pudo convertir a float (o a unsigned long si isInt=true).
-bool extraerValor(const String& data, const char* clave, float& outVal) {
-  int k = data.indexOf(clave);
-  if (k < 0) return false;
+// Busca "clave:" y convierte lo que sigue (saltando espacios) a float.
+bool extraerValor(const char* data, const char* clave, float& outVal) {
+  const char* k = strstr(data, clave);
+  if (!k) return false;
   k += strlen(clave);
-  // saltar espacios
-  while (k < (int)data.length() && data[k] == ' ') k++;
-  int end = data.indexOf(' ', k);
-  if (end < 0) end = data.length();
-  String token = data.substring(k, end);
-  token.trim();
-  if (token.length() == 0) return false;
-  outVal = token.toFloat();
+  while (*k == ' ') k++;
+  char* fin;
+  float v = strtof(k, &fin);
+  if (fin == k) return false;
+  outVal = v;
   return true;
 }
 
-bool extraerIdPaquete(const String& data, unsigned long& outId) {
-  int k = data.indexOf("N:");
-  if (k < 0) return false;
+bool extraerIdPaquete(const char* data, unsigned long& outId) {
+  const char* k = strstr(data, "N:");
+  if (!k) return false;
   k += 2;
-  while (k < (int)data.length() && data[k] == ' ') k++;
-  int end = data.indexOf(' ', k);
-  if (end < 0) end = data.length();
-  String token = data.substring(k, end);
-  token.trim();
-  if (token.length() == 0) return false;
-
-  // toInt() retorna long con base 10
-  long v = token.toInt();
-  if (v < 0) return false;
-  outId = (unsigned long)v;
+  while (*k == ' ') k++;
+  if (*k == '-') return false;
+  char* fin;
+  unsigned long v = strtoul(k, &fin, 10);
+  if (fin == k) return false;
+  outId = v;
   return true;
 }
 
 // Parseo robusto del frame "N: V: I: B:" en cualquier orden.
 // Devuelve true si pudo extraer todos.
-bool parseFrame(const String& data, unsigned long& id, float& vred, float& iamp, float& vbat) {
+bool parseFrame(const char* data, unsigned long& id, float& vred, float& iamp, float& vbat) {
   bool ok = true;
   ok &= extraerIdPaquete(data, id);
   ok &= extraerValor(data, "V:", vred);
@@ -70,45 +88,94 @@ bool parseFrame(const String& data, unsigned long& id, float& vred, float& iamp,
   return ok;
 }
 
-void setup() {
-  Serial.begin(115200);
-  Serial2.begin(9600, SERIAL_8N1, RXD2, TXD2);
-
-  Serial.println("Nodo coordinador Log iniciado");
-  if (!SD.begin(SD_CS)) {
-    Serial.println("[SD] SD no inicializada");
-  } else {
-    logFile = SD.open("/clog.txt", FILE_WRITE);
-    if (logFile) {
-      // Mantengo tu encabezado original (usa la batería del sensor recibida en B:)
-      logFile.println("fecha_hora,id_paquete,id_nodo,RSSI,estado,voltaje_bateria");
-      logFile.flush();
+// ---- Etapa rx (núcleo 0, la de mayor prioridad): solo junta líneas ----
+void tareaRx(void*) {
+  static Linea actual;
+  uint8_t n = 0;
+  for (;;) {
+    int disponibles = Serial2.available();
+    if (disponibles <= 0) { vTaskDelay(1); continue; }   // 1 ms: a 9600 baud llegan ~1 byte/ms
+    while (disponibles-- > 0) {
+      char c = (char)Serial2.read();
+      if (c == '\r') continue;
+      if (c != '\n') {
+        if (n < sizeof(actual.texto) - 1) actual.texto[n++] = c;
+        else if (n == sizeof(actual.texto) - 1) { ++lineasTruncadas; ++n; }
+        continue;
+      }
+      // trim
+      uint8_t fin = n < sizeof(actual.texto) ? n : sizeof(actual.texto) - 1;
+      while (fin > 0 && actual.texto[fin - 1] == ' ') --fin;
+      actual.texto[fin] = '\0';
+      n = 0;
+      if (fin == 0) continue;
+      actual.recibido_us = micros();
+      actual.recibido_ms = millis();
+      if (colaLineas.poner(actual)) etapaDecod.despertar();
+      etapaRx.procesado(actual.recibido_us);
     }
   }
+}
 
-  // Encabezado bonito para la consola
-  Serial.println();
-  Serial.println(F("==== COORDINADOR ESP32 (XBee) ===="));
-  Serial.println(F("Esperando tramas del sensor (formato: N:<id> V:<Vr> I:<I> B:<Vbat>)"));
-  Serial.println();
-  Serial.println(F("Fecha/Hora            Nodo      pkt     Vred[V]   I[A]    Vbat[V]   RSSI  Estado"));
-  Serial.println(F("--------------------  --------  ------  --------  ------  --------  ----  --------"));
+// ---- Etapa decod (núcleo 1): texto -> registro, y reparte a registro y control ----
+void tareaDecod(void*) {
+  Linea l;
+  for (;;) {
+    etapaDecod.esperar(1000);
+    while (colaLineas.sacar(l)) {
+      const char* texto = l.texto;
+      while (*texto == ' ') ++texto;
+      Registro r;
+      r.recibido_us = l.recibido_us;
+      r.recibido_ms = l.recibido_ms;
+      r.id = 0;
+      r.vred = r.iamp = r.vbat = NAN;
+      r.ok = parseFrame(texto, r.id, r.vred, r.iamp, r.vbat);
+      if (colaRegistro.poner(r)) etapaRegistro.despertar();
+      if (colaControl.poner(r))  etapaControl.despertar();
+      etapaDecod.procesado(l.recibido_us);
+    }
+  }
 }
 
-void loop() {
-  if (Serial2.available()) {
-    String data = Serial2.readStringUntil('\n');
-    data.trim();
-    if (data.length() > 0) {
-      paquetesRecibidos++;
+// ---- Etapa control (núcleo 0): respuesta al sensor ----
+void tareaControl(void*) {
+  Registro r;
+  for (;;) {
+    etapaControl.esperar(1000);
+    while (colaControl.sacar(r)) {
+      // Si no quieres encender siempre el relé, comenta la siguiente línea.
+      Serial2.println("ON");
+      etapaControl.procesado(r.recibido_us);
+    }
+  }
+}
 
-      unsigned long id = 0;
-      float vred = NAN, iamp = NAN, vbat = NAN;
+void imprimirEstadisticas() {
+  Serial.println(F("---- etapas (latencia desde la recepción) ----"));
+  etapaRx.imprimir(Serial);
+  etapaDecod.imprimir(Serial);
+  etapaRegistro.imprimir(Serial);
+  etapaControl.imprimir(Serial);
+  imprimirCola(Serial, "lineas", colaLineas);
+  imprimirCola(Serial, "registro", colaRegistro);
+  imprimirCola(Serial, "control", colaControl);
+  Serial.print(F("lineas truncadas: "));
+  Serial.println(lineasTruncadas);
+}
 
-      bool ok = parseFrame(data, id, vred, iamp, vbat);
+// ---- Etapa registro (núcleo 1, la de menor prioridad): consola y SD ----
+// Es la única que escribe en Serial y en la SD después de setup().
+void tareaRegistro(void*) {
+  Registro r;
+  unsigned long lastFlush = millis(), ultimasEstadisticas = millis();
+  for (;;) {
+    etapaRegistro.esperar(500);
+    while (colaRegistro.sacar(r)) {
       int rssi = -1;             // XBee en modo transparente no entrega RSSI por UART
-      const char* estado = ok ? "OK" : "PARSE_ERR";
-      String fecha_hora = obtenerFechaHora();
+      const char* estado = r.ok ? "OK" : "PARSE_ERR";
+      char fecha_hora[24];
+      obtenerFechaHora(r.recibido_ms, fecha_hora, sizeof(fecha_hora));
 
       // ---- Impresión bonita en consola ----
       // Alinear columnas manualmente
@@ -116,12 +183,12 @@ void loop() {
       // %-20s fecha fija, %-8s nodo, %6lu pkt, %8.2f, %6.2f, %8.2f, %4d RSSI, %-8s estado
       snprintf(lineaBonita, sizeof(lineaBonita),
                "%-20s  %-8s  %6lu  %8.2f  %6.2f  %8.2f  %4d  %-8s",
-               fecha_hora.c_str(),
+               fecha_hora,
                "SENSOR1",
-               id,
-               ok ? vred : 0.0,
-               ok ? iamp : 0.0,
-               ok ? vbat : 0.0,
+               r.id,
+               r.ok ? r.vred : 0.0,
+               r.ok ? r.iamp : 0.0,
+               r.ok ? r.vbat : 0.0,
                rssi,
                estado);
       Serial.println(lineaBonita);
@@ -129,19 +196,57 @@ void loop() {
       // ---- Registro a SD (mantengo tu CSV original) ----
       // Usamos la batería del sensor (B:) para el campo "voltaje_bateria"
       if (logFile) {
-        String lineaCSV = fecha_hora + "," + String(id) + ",SENSOR1," +
-                          String(rssi) + "," + estado + "," + String(ok ? vbat : 0.0, 2);
+        char lineaCSV[96];
+        snprintf(lineaCSV, sizeof(lineaCSV), "%s,%lu,SENSOR1,%d,%s,%.2f",
+                 fecha_hora, r.id, rssi, estado, r.ok ? r.vbat : 0.0);
         logFile.println(lineaCSV);
       }
+      etapaRegistro.procesado(r.recibido_us);
+    }
 
-      // ---- Comando al sensor (opcional) ----
-      // Si no quieres encender siempre el relé, comenta la siguiente línea.
-      Serial2.println("ON");
+    if (logFile && millis() - lastFlush >= FLUSH_MS) {
+      logFile.flush();
+      lastFlush = millis();
+    }
+    if (millis() - ultimasEstadisticas >= ESTADISTICAS_MS) {
+      ultimasEstadisticas = millis();
+      imprimirEstadisticas();
     }
   }
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial2.setRxBufferSize(1024);        // margen por si rx se retrasa un tick
+  Serial2.begin(9600, SERIAL_8N1, RXD2, TXD2);
 
-  if (logFile && millis() - lastFlush >= FLUSH_MS) {
-    logFile.flush();
-    lastFlush = millis();
+  Serial.println("Nodo coordinador Log iniciado");
+  if (!SD.begin(SD_CS)) {
+    Serial.println("[SD] SD no inicializada");
+  } else {
+    logFile = SD.open("/clog.txt", FILE_WRITE);
+    if (logFile) {
+      // Mantengo tu encabezado original (usa la batería del sensor recibida en B:)
+      logFile.println("fecha_hora,id_paquete,id_nodo,RSSI,estado,voltaje_bateria");
+      logFile.flush();
+    }
   }
+
+  // Encabezado bonito para la consola
+  Serial.println();
+  Serial.println(F("==== COORDINADOR ESP32 (XBee) ===="));
+  Serial.println(F("Esperando tramas del sensor (formato: N:<id> V:<Vr> I:<I> B:<Vbat>)"));
+  Serial.println();
+  Serial.println(F("Fecha/Hora            Nodo      pkt     Vred[V]   I[A]    Vbat[V]   RSSI  Estado"));
+  Serial.println(F("--------------------  --------  ------  --------  ------  --------  ----  --------"));
+
+  // Consumidores primero, para que los productores ya tengan a quién despertar
+  etapaRegistro.lanzar(tareaRegistro, nullptr, 1, 1, 6144);   // SD + snprintf con float
+  etapaControl.lanzar(tareaControl, nullptr, 0, 4);
+  etapaDecod.lanzar(tareaDecod, nullptr, 1, 3);
+  etapaRx.lanzar(tareaRx, nullptr, 0, 5);
+}
+
+void loop() {
+  vTaskDelete(nullptr);   // el trabajo lo hacen las etapas
 }
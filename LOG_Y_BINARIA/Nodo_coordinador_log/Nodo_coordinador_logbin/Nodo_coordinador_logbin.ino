@@ -1,6 +1,7 @@
 #include <SPI.h>
 #include <SD.h>
 #include "CodecWSN.h"  // Packet, decodePacketFast, WSNFrame::{Parser, feed, FRAME_SIZE}
+#include "ColaBajadaWSN.h" // comandos por nodo dentro del ACK binario
 
 // UART para XBee (ESP32)
 #define RXD2 16
@@ -14,6 +15,12 @@ File logFile;
 unsigned long lastFlush = 0;
 const unsigned long FLUSH_MS = 30000;
 
+// XBee AT no trae la dirección de origen: un nodo sensor por coordinador
+const uint8_t NODO_SENSOR = 1;
+const unsigned long SYNC_HORA_MS = 3600000UL;
+ColaBajadaWSN<4> bajada;
+unsigned long ultimaSyncHora = 0;
+
 String obtenerFechaHora() {
   unsigned long s = millis() / 1000;
   int hh = 12 + (s / 3600) % 12;
@@ -50,6 +57,10 @@ void setup() {
     }
   }
   Serial.print("encendido  Nodo Coordinador binario\n");
+
+  // Mismo estado inicial que el "ON" de antes, pero se manda una vez y no en cada trama
+  bajada.encolar(NODO_SENSOR, CMD_RELE, 1);
+  bajada.encolar(NODO_SENSOR, CMD_HORA, millis() / 1000, 1);
 }
 
 void loop() {
@@ -57,11 +68,40 @@ void loop() {
   while (Serial2.available()) {
     uint8_t b = uint8_t(Serial2.read());
 
-    Packet rx;
-    const bool ok = WSNFrame::feed(gParser, b, rx);
+    const bool ok = WSNFrame::feedFrame(gParser, b);
     if (!ok) continue;  // aún no se completó un frame válido
 
-    // Si ok == true, rx ya contiene el Packet decodificado y verificado por CRC
+    // Registro tipado (v2): resumen de armónicos calculado en el nodo
+    if (gParser.ver == WSNFrame::VERSION_REGISTROS) {
+      PacketArmonicos a;
+      if (gParser.tipo() == REG_ARMONICOS &&
+          decodeArmonicos(gParser.datos(), gParser.longitudDatos(), a)) {
+        String linea = obtenerFechaHora() + ",armonicos," + String(a.id) + "," +
+                       String(a.thdV / 10.0f, 1) + "," + String(a.thdI / 10.0f, 1);
+        for (uint8_t k = 0; k < 4; ++k) linea += "," + String(a.armI[k] / 2.0f, 1);
+        Serial.println(linea);
+        if (logFile) logFile.println(linea);
+      }
+      // Resumen de ventana: un registro reemplaza a todas las muestras del período
+      PacketResumen r;
+      if (gParser.tipo() == REG_RESUMEN &&
+          decodeResumen(gParser.datos(), gParser.longitudDatos(), r)) {
+        String linea = obtenerFechaHora() + ",resumen," + String(r.id) + "," +
+                       String(r.duracion_s) + "," + String(r.muestras) + "," +
+                       String(r.vMin / 100.0f, 2) + "," + String(r.vMedia / 100.0f, 2) + "," +
+                       String(r.vMax / 100.0f, 2) + "," +
+                       String(r.iMin / 1000.0f, 3) + "," + String(r.iMedia / 1000.0f, 3) + "," +
+                       String(r.iMax / 1000.0f, 3) + "," + String(r.energia_mWh) + "," +
+                       String(r.eventosSag) + "," + String(r.eventosSwell) + "," +
+                       String(r.eventosSobreI);
+        Serial.println(linea);
+        if (logFile) logFile.println(linea);
+      }
+      continue;
+    }
+
+    // Packet v1 ya verificado por CRC
+    Packet rx = decodePacketFast(gParser.pay);
     const float voltaje = rx.voltaje / 100.0f;       // V
     const float corriente = rx.corriente / 1000.0f;  // A
     const float vbat = rx.vbat / 100.0f;             // V
@@ -72,8 +112,15 @@ void loop() {
     Serial.println(linea);
     if (logFile) logFile.println(linea);
 
-    // (Opcional) responder comando de control (texto)
-    Serial2.println("ON");
+    // ACK binario con lo pendiente para el nodo (relé, período, hora)
+    uint8_t ack[WSNFrame::MAX_FRAME_SIZE];
+    Serial2.write(ack, bajada.armarAck(NODO_SENSOR, rx.id, ack));
+  }
+
+  leerConsola();
+  if (millis() - ultimaSyncHora >= SYNC_HORA_MS) {
+    ultimaSyncHora = millis();
+    bajada.encolar(NODO_SENSOR, CMD_HORA, millis() / 1000, 1);   // una sola vez: la hora envejece
   }
 
   // Flush periódico de SD
@@ -82,3 +129,21 @@ void loop() {
     lastFlush = millis();
   }
 }
+
+// Comandos por consola: "ON", "OFF" o "P <ms>"; se encolan y bajan en el próximo ACK
+void leerConsola() {
+  static char linea[16];
+  static uint8_t n = 0;
+  while (Serial.available()) {
+    char c = (char)Serial.read();
+    if (c != '\n' && c != '\r') {
+      if (n < sizeof(linea) - 1) linea[n++] = c;
+      continue;
+    }
+    linea[n] = '\0';
+    if      (strcmp(linea, "ON") == 0)   bajada.encolar(NODO_SENSOR, CMD_RELE, 1);
+    else if (strcmp(linea, "OFF") == 0)  bajada.encolar(NODO_SENSOR, CMD_RELE, 0);
+    else if (strncmp(linea, "P ", 2) == 0) bajada.encolar(NODO_SENSOR, CMD_PERIODO_MS, strtoul(linea + 2, nullptr, 10));
+    n = 0;
+  }
+}
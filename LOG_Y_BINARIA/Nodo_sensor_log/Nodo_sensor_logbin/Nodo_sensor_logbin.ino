@@ -2,6 +2,8 @@
 #include <SD.h>
 #include <SoftwareSerial.h>
 #include "CodecWSN.h"  // Packet, PACKET_SIZE, WSNFrame::encodeFrameFromPacket, FRAME_SIZE
+#include "ACMeterWSN.h"           // True-RMS sincronizado + captura de la forma de onda
+#include "HarmonicAnalyzerWSN.h"  // Goertzel Q14: THD y armónicos impares
 
 // XBee en pines digitales (SoftwareSerial)
 SoftwareSerial xbeeSerial(2, 3); // RX=D2, TX=D3
@@ -16,27 +18,34 @@ const uint8_t SD_CS = 10;
 
 // Temporización y SD
 unsigned long previousMillis = 0;
-const unsigned long INTERVAL_MS = 3000;
+unsigned long intervalo_ms = 3000;        // el coordinador puede cambiarlo (CMD_PERIODO_MS)
 unsigned long lastFlush = 0;
 const unsigned long FLUSH_MS = 30000;
 uint32_t paquetesEnviados = 0;
 File logFile;
 
-// === Lecturas de ejemplo (ajusta a tu hardware real) ===
-float leerVoltajeZMPT() {
-  int lectura = analogRead(ZMPT_PIN);
-  return ((lectura * 5.0f) / 1023.0f) * 50.0f;}
-float leerCorrienteACS() {
-  int lectura = analogRead(ACS_PIN);
-  float v = (lectura * 5.0f) / 1023.0f;
-  return (v - 2.5f) / 0.066f; }
+// Bajada binaria del coordinador: ACK con comandos (CodecWSN REG_ACK)
+const uint8_t NODO_ID = 1;
+WSNFrame::Parser gBajada;
+uint32_t horaRed_s = 0;            // hora de la red en la última sincronía
+unsigned long horaSync_ms = 0;     // millis() en ese momento
+
+// Medición AC: 2 ciclos de 60 Hz a 2.5 kHz por canal ≈ 84 muestras
+ACMeterWSN medidor;
+const uint16_t MUESTRAS_CAPTURA = 84;
+int16_t capturaV[MUESTRAS_CAPTURA];
+int16_t capturaI[MUESTRAS_CAPTURA];
+const uint8_t ENVIOS_POR_ARMONICOS = 10;   // un resumen de armónicos cada 10 paquetes
+ACMeterWSN::Resultado ultimaAC = {};
+
+// === Lecturas (ajusta escalas a tu hardware real) ===
 float leerVoltajeBateria() {
   int lectura = analogRead(VBAT_PIN);
   float vEsc = (lectura * 5.0f) / 1023.0f;
   return vEsc * 3.0f; }
 
 String obtenerFechaHora() {
-  unsigned long s = millis() / 1000;
+  unsigned long s = horaRed_s + (millis() - horaSync_ms) / 1000;
   int hh = 12 + (s / 3600) % 12;
   int mm = (s / 60) % 60;
   int ss = s % 60;
@@ -51,6 +60,13 @@ void setup() {
   Serial.begin(9600);      // Consola local
   xbeeSerial.begin(9600);  // Enlace XBee
   
+  ACMeterWSN::Cfg cfgAc;
+  cfgAc.pinV   = ZMPT_PIN;
+  cfgAc.pinI   = ACS_PIN;
+  cfgAc.ciclos = 2;
+  medidor.begin(cfgAc);
+  medidor.setCapture(capturaV, capturaI, MUESTRAS_CAPTURA);
+
   Serial.print("encendido  Nodo Sensor binario\n");
   // SD para almacenar y verificar pérdidas
   if (!SD.begin(SD_CS)) {
@@ -68,11 +84,13 @@ void loop() {
   unsigned long now = millis();
 
   // Cada INTERVAL_MS, medimos → paquetizamos → enviamos FRAME BINARIO (con SOF/CRC)
-  if (now - previousMillis >= INTERVAL_MS) {
+  if (now - previousMillis >= intervalo_ms) {
     previousMillis = now;
 
-    const float v_red = leerVoltajeZMPT();  
-    const float i     = leerCorrienteACS(); 
+    ultimaAC = ACMeterWSN::Resultado();
+    medidor.measure(ultimaAC);
+    const float v_red = ultimaAC.vrms_V;
+    const float i     = ultimaAC.irms_A;
     const float vbat  = leerVoltajeBateria();
     paquetesEnviados++;
 
@@ -88,6 +106,9 @@ void loop() {
     WSNFrame::encodeFrameFromPacket(frame, p);
     xbeeSerial.write(frame, WSNFrame::FRAME_SIZE);
 
+    // Cada ENVIOS_POR_ARMONICOS: análisis en el nodo y solo el resumen al aire (17 B)
+    if (paquetesEnviados % ENVIOS_POR_ARMONICOS == 0) enviarArmonicos(p.id);
+
     // (Opcional) Log humano local en el Nano (Serial/SD)
     String linea = obtenerFechaHora() + "," + String(p.id) + "," +
                    String(v_red, 2) + "," + String(i, 3) + "," + String(vbat, 2);
@@ -95,12 +116,14 @@ void loop() {
     if (logFile) logFile.println(linea);
   }
 
-  // Recibir comandos de texto desde el coordinador (ej. "ON"/"OFF")
-  if (xbeeSerial.available()) {
-    String comando = xbeeSerial.readStringUntil('\n');
-    comando.trim();
-    if (comando == "ON")  digitalWrite(RELAY_PIN, HIGH);
-    if (comando == "OFF") digitalWrite(RELAY_PIN, LOW);
+  // ACK binario del coordinador: se consume byte a byte, sin bloquear esperando '\n'
+  while (xbeeSerial.available()) {
+    if (!WSNFrame::feedFrame(gBajada, uint8_t(xbeeSerial.read()))) continue;
+    PacketAck ack;
+    if (gBajada.tipo() == REG_ACK && decodeAck(gBajada.datos(), gBajada.longitudDatos(), ack) &&
+        ack.nodo == NODO_ID) {
+      aplicarComandos(ack);
+    }
   }
 
   // Flush periódico de SD
@@ -109,3 +132,49 @@ void loop() {
     lastFlush = millis();
   }
 }
+
+// Comandos absolutos: llegan repetidos en dos ACK seguidos y aplicarlos otra vez no cambia nada
+void aplicarComandos(const PacketAck& ack) {
+  for (uint8_t k = 0; k < ack.nComandos; ++k) {
+    const ComandoWSN& c = ack.comandos[k];
+    switch (c.tipo) {
+      case CMD_RELE:
+        digitalWrite(RELAY_PIN, c.valor ? HIGH : LOW);
+        break;
+      case CMD_PERIODO_MS:
+        if (c.valor >= 500) intervalo_ms = c.valor;
+        break;
+      case CMD_HORA:
+        horaRed_s   = c.valor;
+        horaSync_ms = millis();
+        break;
+    }
+  }
+}
+
+// Analiza la forma de onda capturada en la última ventana y envía THD + h3..h9 de corriente
+void enviarArmonicos(uint16_t id) {
+  const uint16_t n = medidor.capturedSamples();
+  const float f_red = ultimaAC.sincronizado ? ultimaAC.frecuencia_mHz / 1000.0f : 60.0f;
+  const float ciclosPorMuestra = f_red / medidor.channelRate();
+
+  HarmonicAnalyzerWSN<5>::Resultado hv, hi;
+  if (!HarmonicAnalyzerWSN<5>::analyze(capturaV, n, ciclosPorMuestra, hv)) return;
+  if (!HarmonicAnalyzerWSN<5>::analyze(capturaI, n, ciclosPorMuestra, hi)) return;
+
+  PacketArmonicos a;
+  a.id   = id;
+  a.thdV = (uint16_t)min(hv.thd_pm, 65535UL);
+  a.thdI = (uint16_t)min(hi.thd_pm, 65535UL);
+  for (uint8_t k = 0; k < 4; ++k) {
+    uint16_t medioPct = hi.relativa_pm[k + 1] / 5;          // por mil → medios por ciento
+    a.armI[k] = (uint8_t)min(medioPct, (uint16_t)255);
+  }
+
+  uint8_t frame[WSNFrame::MAX_FRAME_SIZE];
+  size_t n_frame = WSNFrame::encodeFrameArmonicos(frame, a);
+  xbeeSerial.write(frame, n_frame);
+
+  Serial.print(F("THD V=")); Serial.print(a.thdV / 10.0f, 1);
+  Serial.print(F("% I="));   Serial.print(a.thdI / 10.0f, 1); Serial.println('%');
+}
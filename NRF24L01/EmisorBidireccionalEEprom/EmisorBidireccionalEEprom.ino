@@ -68,10 +68,11 @@ void loop() {
   DateTime now = rtc.now();
   char mensaje[EEPROM_SIZE];
   // Formatear la fecha y hora en un string
-  sprintf(mensaje, "%02d/%02d/%04d %02d:%02d:%02d", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second());
+  int n = snprintf(mensaje, sizeof(mensaje), "%02d/%02d/%04d %02d:%02d:%02d", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second());
 
-  // Enviar el mensaje
-  if (radio.write(&mensaje, sizeof(mensaje))) {
+  // Enviar el mensaje: solo el texto y su '\0' (20 B), no los EEPROM_SIZE del buffer;
+  // el nRF24 lleva como mucho 32 bytes
+  if (radio.write(mensaje, n + 1)) {
     Serial.print("Enviado: ");
     Serial.println(mensaje);
     
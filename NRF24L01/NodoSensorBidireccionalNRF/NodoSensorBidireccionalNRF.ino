@@ -47,11 +47,11 @@ void loop() {
 
   // Formatear la hora
   DateTime now = rtc.now();
-  char mensaje[50];
-  sprintf(mensaje, "%02d/%02d/%04d %02d:%02d:%02d", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second());
+  char mensaje[32];   // el nRF24 lleva como mucho 32 bytes por paquete
+  int n = snprintf(mensaje, sizeof(mensaje), "%02d/%02d/%04d %02d:%02d:%02d", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second());
 
   // Enviar el mensaje
-  if (radio.write(&mensaje, sizeof(mensaje))) {
+  if (radio.write(mensaje, n + 1)) {
     Serial.print("Enviado: ");
     Serial.println(mensaje);
   } else {
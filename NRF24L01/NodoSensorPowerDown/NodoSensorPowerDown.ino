@@ -3,6 +3,8 @@
 #include <RF24.h>
 #include <Wire.h>
 #include "RTClib.h"
+#include "EnergyWSN.h"    // sleepFor_ms: power-down por WDT
+#include "SchedulerWSN.h" // Planificador sin tick
 
 // --- Configuración de la Radio (SPI) ---
 RF24 radio(9, 10); // CE, CSN
@@ -11,6 +13,11 @@ const byte address[6] = "00001";
 // --- Configuración del Reloj (I2C) ---
 RTC_DS3231 rtc;
 
+// --- Ahorro de energía ---
+EnergyWSN energy;         // solo se usa sleepFor_ms (no hay XBee ni gate de sensores)
+SchedulerWSN<2> sched;
+const uint32_t PERIODO_ENVIO_MS = 5000;
+
 void setup() {
   Serial.begin(9600);
   
@@ -35,10 +42,22 @@ void setup() {
   radio.setPALevel(RF24_PA_MIN);
   radio.stopListening();
   
+  sched.begin(dormirNodo);
+  sched.every(PERIODO_ENVIO_MS, enviarHora);
+
   Serial.println("Emisor listo para enviar la hora.");
 }
 
 void loop() {
+  sched.run();
+}
+
+uint32_t dormirNodo(uint32_t ms) {
+  Serial.flush();
+  return energy.sleepFor_ms(ms);
+}
+
+void enviarHora(void*) {
   Serial.println("Radio encendida");
   radio.powerUp();
   delay(5);
@@ -46,11 +65,11 @@ void loop() {
   // 1. Leer la hora actual del RTC
   DateTime now = rtc.now();
   // 2. Formatear la hora en un texto para enviarla
-  char mensaje[50];
-  sprintf(mensaje, "%02d/%02d/%04d %02d:%02d:%02d", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second());
+  char mensaje[32];   // el nRF24 lleva como mucho 32 bytes por paquete
+  int n = snprintf(mensaje, sizeof(mensaje), "%02d/%02d/%04d %02d:%02d:%02d", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second());
 
   // 3. Enviar el mensaje a través de la radio
-  bool ok = radio.write(&mensaje, sizeof(mensaje));
+  bool ok = radio.write(mensaje, n + 1);
 
   if (ok) {
     Serial.print("Enviado: ");
@@ -60,6 +79,5 @@ void loop() {
   }
   Serial.println("Radio apagada");
   radio.powerDown();
-  
-  delay(5000); // Enviar la hora cada 5 segundos
+  // El planificador duerme el micro hasta el siguiente envío (cada 5 segundos)
 }
\ No newline at end of file
@@ -65,10 +65,11 @@ void loop() {
   DateTime now = rtc.now();
   // 2. Formatear la hora en un texto para enviarla
   char mensaje[EEPROM_SIZE];
-  sprintf(mensaje, "%02d/%02d/%04d %02d:%02d:%02d", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second());
+  int n = snprintf(mensaje, sizeof(mensaje), "%02d/%02d/%04d %02d:%02d:%02d", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second());
 
-  // 3. Enviar el mensaje a través de la radio
-  bool ok = radio.write(&mensaje, sizeof(mensaje));
+  // 3. Enviar el mensaje a través de la radio: solo el texto y su '\0' (20 B),
+  //    no los EEPROM_SIZE del buffer; el nRF24 lleva como mucho 32 bytes
+  bool ok = radio.write(mensaje, n + 1);
 
   if (ok) {
     Serial.print("Enviado: ");
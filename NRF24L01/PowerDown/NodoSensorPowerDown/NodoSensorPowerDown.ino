@@ -46,11 +46,11 @@ void loop() {
   // 1. Leer la hora actual del RTC
   DateTime now = rtc.now();
   // 2. Formatear la hora en un texto para enviarla
-  char mensaje[50];
-  sprintf(mensaje, "%02d/%02d/%04d %02d:%02d:%02d", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second());
+  char mensaje[32];   // el nRF24 lleva como mucho 32 bytes por paquete
+  int n = snprintf(mensaje, sizeof(mensaje), "%02d/%02d/%04d %02d:%02d:%02d", now.day(), now.month(), now.year(), now.hour(), now.minute(), now.second());
 
   // 3. Enviar el mensaje a través de la radio
-  bool ok = radio.write(&mensaje, sizeof(mensaje));
+  bool ok = radio.write(mensaje, n + 1);
 
   if (ok) {
     Serial.print("Enviado: ");
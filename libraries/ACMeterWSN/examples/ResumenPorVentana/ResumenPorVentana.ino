@@ -0,0 +1,90 @@
+/*
+ * Nodo que mide seguido pero reporta poco.
+ *  - medir: cada 5 s enciende los sensores, mide 2 ciclos de red y agrega el resultado
+ *  - reportar: cada 5 min despierta el XBee y envía un solo frame REG_RESUMEN
+ *    (min/max/media de V e I, energía en mWh, sags/swells/sobrecorrientes)
+ * El radio solo se enciende una vez por ventana; entre mediciones el micro duerme.
+ */
+#include <SoftwareSerial.h>
+#include <LowPower.h>
+#include "EnergyWSN.h"
+#include "SchedulerWSN.h"
+#include "CodecWSN.h"
+#include "ACMeterWSN.h"
+#include "WindowAggregatorWSN.h"
+
+SoftwareSerial xbeeSerial(2, 3);   // D2=RX, D3=TX
+
+#define ACS_PIN   A0
+#define ZMPT_PIN  A1
+
+const uint8_t  PIN_SLEEP_RQ  = 8;
+const uint8_t  PIN_ON_SLEEP  = 9;
+const uint8_t  PIN_PWR_SENS  = 7;
+const uint32_t MEDIR_MS      = 5000;
+const uint32_t REPORTE_MS    = 300000;
+
+EnergyWSN           energy;
+SchedulerWSN<2>     sched;
+ACMeterWSN          medidor;
+WindowAggregatorWSN ventana;
+uint16_t            resumenesEnviados = 0;
+
+void setup() {
+  Serial.begin(9600);
+  xbeeSerial.begin(9600);
+
+  EnergyWSN::Cfg cfg;
+  cfg.pins = { PIN_SLEEP_RQ, PIN_ON_SLEEP, PIN_PWR_SENS, -1 };
+  cfg.invertPwr = true;
+  cfg.bootSleep = true;
+  energy.begin(cfg);
+
+  ACMeterWSN::Cfg cfgAc;
+  cfgAc.pinV   = ZMPT_PIN;
+  cfgAc.pinI   = ACS_PIN;
+  cfgAc.ciclos = 2;
+  medidor.begin(cfgAc);
+
+  WindowAggregatorWSN::Cfg cfgVentana;   // sag < 190 V, swell > 250 V, sobrecorriente > 20 A
+  sched.begin(dormirNodo);
+  ventana.begin(cfgVentana, sched.now());
+
+  sched.every(MEDIR_MS, medir);
+  sched.every(REPORTE_MS, reportar, nullptr, REPORTE_MS);
+}
+
+void loop() {
+  sched.run();
+}
+
+uint32_t dormirNodo(uint32_t ms) {
+  Serial.flush();
+  return energy.sleepFor_ms(ms);
+}
+
+void medir(void*) {
+  energy.powerSensors(true);
+  delay(2);                              // asentamiento del ZMPT/ACS
+  ACMeterWSN::Resultado r = ACMeterWSN::Resultado();
+  bool ok = medidor.measure(r);
+  energy.powerSensors(false);
+  if (ok) ventana.add(r, sched.now());
+}
+
+void reportar(void*) {
+  PacketResumen resumen;
+  if (!ventana.close(resumen, ++resumenesEnviados, sched.now())) return;
+
+  uint8_t frame[WSNFrame::MAX_FRAME_SIZE];
+  size_t n = WSNFrame::encodeFrameResumen(frame, resumen);
+  energy.wakeRadio();
+  xbeeSerial.write(frame, n);
+  xbeeSerial.flush();
+  energy.sleepRadio();
+
+  Serial.print(F("Ventana ")); Serial.print(resumen.id);
+  Serial.print(F(": ")); Serial.print(resumen.muestras);
+  Serial.print(F(" mediciones, E=")); Serial.print(resumen.energia_mWh);
+  Serial.println(F(" mWh"));
+}
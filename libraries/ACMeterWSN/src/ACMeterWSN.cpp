@@ -0,0 +1,7 @@
+#include "ACMeterWSN.h"
+
+// Única definición del vector del ADC: reparte cada conversión al medidor activo
+ISR(ADC_vect) {
+  ACMeterWSN* m = ACMeterWSN::instancia();
+  if (m) m->onAdc();
+}
@@ -0,0 +1,318 @@
+#pragma once
+#include <Arduino.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+/** Medidor AC true-RMS para nodos con ZMPT101B (voltaje) y ACS712 (corriente).
+  *  El Timer1 en modo CTC dispara cada conversión del ADC por hardware (compare match B)
+  *  y la ISR del ADC alterna los canales V/I y acumula, en enteros, sumas, sumas de
+  *  cuadrados y el producto V·I sobre N ciclos completos de red. Al cerrar la ventana
+  *  se obtienen Vrms, Irms, potencia real, potencia aparente y factor de potencia.
+  *  Con sincronizarCruces la ventana se abre y se cierra en cruces por cero ascendentes
+  *  del ZMPT (con histéresis alrededor del offset DC seguido), así contiene un número
+  *  exacto de ciclos; los instantes de cruce interpolados dan la frecuencia de red en mHz.
+  *  La ISR dura unos pocos microsegundos; entre muestras el CPU queda libre (radio, SD).
+  *  Usa Timer1 y ADC_vect: no combinar con Servo ni analogWrite en D9/D10 durante la ventana.
+  *  Autores: Francisco Rosales, Omar Tox, 2025-09.
+**/
+
+class ACMeterWSN {
+public:
+  /* Estructura de configuración */
+  struct Cfg {
+    uint8_t  pinV           = A1;     // ZMPT101B
+    uint8_t  pinI           = A0;     // ACS712
+    uint16_t muestreo_Hz    = 5000;   // conversiones/s totales (V e I alternadas → mitad por canal)
+    uint8_t  frecuenciaRed  = 60;     // Hz nominales de la red
+    uint8_t  ciclos         = 10;     // ciclos de red por ventana
+    float    escalaV        = 0.2444f;  // V de red por cuenta ADC (5.0/1023*50, calibrar)
+    float    escalaI        = 0.0740f;  // A por cuenta ADC (5.0/1023/0.066 para ACS712-30A)
+    bool     sincronizarCruces = true;  // ventana alineada a cruces por cero del voltaje
+    uint8_t  histeresis     = 8;      // cuentas ADC alrededor del offset para armar el detector
+    int16_t  errorReloj_ppm = 0;      // corrección del resonador del micro (+ si el reloj va rápido)
+  };
+
+  /* Resultado de una ventana */
+  struct Resultado {
+    float    vrms_V;
+    float    irms_A;
+    float    potenciaReal_W;
+    float    potenciaAparente_VA;
+    float    factorPotencia;    // -1..1 (negativo: flujo inverso)
+    uint16_t muestras;          // pares V/I usados
+    uint32_t frecuencia_mHz;    // frecuencia de red (0 si no hubo sincronía)
+    bool     sincronizado;      // la ventana cubrió ciclos completos entre cruces
+  };
+
+  // Límite de pares por ventana para que las sumas int32 no se desborden
+  static const uint16_t MAX_MUESTRAS = 4000;
+
+  void begin(const Cfg& cfg) {
+    _cfg = cfg;
+    _muxV = _BV(REFS0) | (canalAdc(cfg.pinV) & 0x07);
+    _muxI = _BV(REFS0) | (canalAdc(cfg.pinI) & 0x07);
+    _offsetV = 512;
+    _offsetI = 512;
+    uint32_t pares = (uint32_t)cfg.ciclos * (cfg.muestreo_Hz / 2) / cfg.frecuenciaRed;
+    _objetivo = (uint16_t)constrain(pares, 2UL, (uint32_t)MAX_MUESTRAS);
+    // Con sincronía se espera hasta un ciclo para el primer cruce y se tolera -10 % de frecuencia
+    uint32_t tope = cfg.sincronizarCruces
+                      ? (uint32_t)_objetivo + (uint32_t)_objetivo * 11 / 10 / cfg.ciclos + _objetivo / 10
+                      : _objetivo;
+    _limite = (uint16_t)constrain(tope, 2UL, (uint32_t)MAX_MUESTRAS);
+  }
+
+  /* Arranca una ventana de medición sin bloquear */
+  bool start() {
+    if (_corriendo) return false;
+    instancia() = this;
+    _acc = Acumulador();
+    _completa = false;
+    _esV = true;
+    _hayI = false;
+    _idxV = 0;
+    _armado = false;
+    _cruces = 0;
+    _acumulando = !_cfg.sincronizarCruces;
+
+    // Guardar el Timer1 de Arduino (PWM en D9/D10) para restaurarlo al terminar
+    _tccr1a = TCCR1A; _tccr1b = TCCR1B; _ocr1a = OCR1A; _ocr1b = OCR1B; _timsk1 = TIMSK1;
+
+    uint8_t sreg = SREG;
+    cli();
+    TCCR1A = 0;
+    TCCR1B = 0;
+    TCNT1  = 0;
+    uint16_t tope = (uint16_t)((F_CPU / 8UL) / _cfg.muestreo_Hz - 1);
+    OCR1A  = tope;                      // CTC: período de muestreo
+    OCR1B  = tope;                      // compare match B = disparo del ADC
+    TIMSK1 = 0;
+    TIFR1  = _BV(OCF1B) | _BV(OCF1A);
+
+    ADMUX  = _muxV;
+    ADCSRB = _BV(ADTS2) | _BV(ADTS0);   // auto-trigger: Timer1 compare match B
+    ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADIF)
+           | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);  // 125 kHz → 104 us por conversión
+    _corriendo = true;
+    TCCR1B = _BV(WGM12) | _BV(CS11);    // CTC, prescaler 8
+    SREG = sreg;
+    return true;
+  }
+
+  bool ready() const { return _completa; }
+  bool running() const { return _corriendo; }
+
+  /* Calcula el resultado de la ventana terminada. false si aún no termina. */
+  bool read(Resultado& out) {
+    if (!_completa) return false;
+    Acumulador a;
+    uint8_t sreg = SREG;
+    cli();
+    a = _acc;
+    SREG = sreg;
+    calcular(a, out);
+    _completa = false;
+    return true;
+  }
+
+  /* Medición bloqueante: el micro espera en IDLE entre muestras */
+  bool measure(Resultado& out, uint16_t timeout_ms = 1000) {
+    if (!start()) return false;
+    uint32_t t0 = millis();
+    while (!_completa) {
+      if (millis() - t0 >= timeout_ms) { stop(); return false; }
+      set_sleep_mode(SLEEP_MODE_IDLE);
+      sleep_mode();                       // despierta con la ISR del ADC o de millis()
+    }
+    return read(out);
+  }
+
+  /* Detiene el muestreo y devuelve el ADC/Timer1 a la configuración de Arduino */
+  void stop() {
+    uint8_t sreg = SREG;
+    cli();
+    TCCR1B = 0;
+    ADCSRA = _BV(ADEN) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);  // analogRead() normal
+    ADCSRB = 0;
+    TCCR1A = _tccr1a; OCR1A = _ocr1a; OCR1B = _ocr1b; TIMSK1 = _timsk1;
+    TIFR1  = _BV(OCF1B) | _BV(OCF1A);
+    TCCR1B = _tccr1b;
+    _corriendo = false;
+    SREG = sreg;
+  }
+
+  /* Buffers opcionales para guardar la forma de onda (centrada) de la ventana, p. ej. para
+   * HarmonicAnalyzerWSN. Con ventana sincronizada y capacidad suficiente, lo capturado son
+   * ciclos completos. nullptr desactiva la captura. */
+  void setCapture(int16_t* bufV, int16_t* bufI, uint16_t capacidad) {
+    _capV = bufV;
+    _capI = bufI;
+    _capN = capacidad;
+  }
+
+  /* Muestras por canal guardadas en la última ventana */
+  uint16_t capturedSamples() const {
+    uint16_t n = (_acc.nV < _acc.n) ? _acc.nV : _acc.n;
+    return (n < _capN) ? n : _capN;
+  }
+
+  /* Frecuencia de muestreo por canal (Hz) */
+  uint16_t channelRate() const { return _cfg.muestreo_Hz / 2; }
+
+  /* Offsets DC actuales (cuentas ADC) */
+  int16_t offsetV() const { return _offsetV; }
+  int16_t offsetI() const { return _offsetI; }
+
+  /* Cuerpo de la ISR del ADC; no llamar desde el sketch */
+  void onAdc() {
+    int16_t x = (int16_t)ADC;
+    TIFR1 = _BV(OCF1B);                 // rearmar el disparo por compare match B
+    if (_esV) {
+      ADMUX = _muxI;                    // la siguiente conversión es corriente
+      int16_t v = x - _offsetV;
+      ++_idxV;
+      if (_cfg.sincronizarCruces && detectarCruce(v)) { _esV = false; return; }
+      if (_acumulando) {
+        if (_capV && _acc.nV < _capN) _capV[_acc.nV] = v;
+        _acc.sumV  += v;
+        _acc.sumV2 += (int32_t)v * v;
+        if (_hayI) {
+          // I se muestreó a mitad de camino entre dos V: se usa el promedio (x2)
+          _acc.sumP += (int32_t)_iPrev * (int16_t)(_vPrev + v);
+          _acc.nP++;
+        }
+        _acc.nV++;
+      }
+      _vPrev = v;
+    } else {
+      ADMUX = _muxV;
+      int16_t i = x - _offsetI;
+      if (_acumulando) {
+        if (_capI && _acc.n < _capN) _capI[_acc.n] = i;
+        _acc.sumI  += i;
+        _acc.sumI2 += (int32_t)i * i;
+        _iPrev = i;
+        _hayI  = true;
+        if (++_acc.n >= _limite) terminar(); // sin cruces (o ventana fija): cierre por cuenta
+      } else if (_idxV >= _limite) {
+        terminar();                     // no apareció ningún cruce: sin red o señal muy baja
+      }
+    }
+    _esV = !_esV;
+  }
+
+  static ACMeterWSN*& instancia() {
+    static ACMeterWSN* activo = nullptr;
+    return activo;
+  }
+
+private:
+  struct Acumulador {
+    int32_t  sumV  = 0, sumI  = 0;
+    uint32_t sumV2 = 0, sumI2 = 0;
+    int32_t  sumP  = 0;     // Σ I·(V_prev + V_sig), es decir 2·Σ V·I
+    uint16_t n     = 0;     // muestras de corriente
+    uint16_t nV    = 0;     // muestras de voltaje
+    uint16_t nP    = 0;     // productos acumulados
+    uint32_t cruce0_q8 = 0; // instante del primer cruce (muestras de V, Q24.8)
+    uint32_t cruceN_q8 = 0; // instante del último cruce
+    uint8_t  ciclos    = 0; // ciclos completos entre cruce0 y cruceN
+  };
+
+  Cfg      _cfg;
+  uint8_t  _muxV = 0, _muxI = 0;
+  int16_t  _offsetV = 512, _offsetI = 512;
+  uint16_t _objetivo = 0;   // pares por ventana sin sincronía
+  uint16_t _limite   = 0;   // tope duro de muestras por ventana
+
+  Acumulador    _acc;
+  volatile bool _completa  = false;
+  volatile bool _corriendo = false;
+  bool     _esV  = true;
+  bool     _hayI = false;
+  int16_t  _vPrev = 0, _iPrev = 0;
+  uint16_t _idxV = 0;       // muestras de V desde start()
+  bool     _armado = false; // el voltaje bajó de -histeresis: listo para un cruce ascendente
+  bool     _acumulando = false;
+  uint8_t  _cruces = 0;
+
+  int16_t* _capV = nullptr;
+  int16_t* _capI = nullptr;
+  uint16_t _capN = 0;
+
+  uint8_t  _tccr1a = 0, _tccr1b = 0, _timsk1 = 0;
+  uint16_t _ocr1a = 0, _ocr1b = 0;
+
+  /* Detector de cruce ascendente con histéresis. Devuelve true si la ventana se cerró. */
+  bool detectarCruce(int16_t v) {
+    int16_t h = _cfg.histeresis;
+    if (v < -h) { _armado = true; return false; }
+    if (!_armado || v < 0 || _idxV < 2) return false;
+    _armado = false;
+
+    // Interpolación lineal entre la muestra anterior (<0) y la actual (>=0), en 1/256 de muestra
+    int16_t  salto = v - _vPrev;
+    uint16_t frac  = salto > 0 ? (uint16_t)(((int32_t)(-_vPrev) << 8) / salto) : 0;
+    uint32_t t_q8  = ((uint32_t)(_idxV - 2) << 8) + frac;
+
+    if (_cruces == 0) {
+      _acc.cruce0_q8 = t_q8;
+      _acumulando = true;               // la ventana arranca en este cruce
+    } else {
+      _acc.cruceN_q8 = t_q8;
+      _acc.ciclos    = _cruces;
+    }
+    if (++_cruces > _cfg.ciclos) {
+      terminar();                       // la muestra que cierra no se acumula
+      return true;
+    }
+    return false;
+  }
+
+  void terminar() {
+    stop();
+    _completa = true;
+  }
+
+  static uint8_t canalAdc(uint8_t pin) { return (pin >= A0) ? pin - A0 : pin; }
+
+  /* Conversión a unidades: una vez por ventana, fuera de la ISR */
+  void calcular(const Acumulador& a, Resultado& out) {
+    out = Resultado();
+    out.muestras = a.n;
+    if (a.n == 0 || a.nV == 0) return;
+
+    float nV    = (float)a.nV;
+    float nI    = (float)a.n;
+    float mediaV = a.sumV / nV;
+    float mediaI = a.sumI / nI;
+    float varV  = a.sumV2 / nV - mediaV * mediaV;
+    float varI  = a.sumI2 / nI - mediaI * mediaI;
+    float cov   = (a.nP ? (a.sumP / (2.0f * a.nP)) : 0.0f) - mediaV * mediaI;
+
+    out.vrms_V              = sqrtf(varV > 0 ? varV : 0) * _cfg.escalaV;
+    out.irms_A              = sqrtf(varI > 0 ? varI : 0) * _cfg.escalaI;
+    out.potenciaReal_W      = cov * _cfg.escalaV * _cfg.escalaI;
+    out.potenciaAparente_VA = out.vrms_V * out.irms_A;
+    out.factorPotencia      = (out.potenciaAparente_VA > 0.001f)
+                                ? constrain(out.potenciaReal_W / out.potenciaAparente_VA, -1.0f, 1.0f)
+                                : 0.0f;
+
+    // Frecuencia: ciclos · fs_canal / (t_N − t_0), con t en 1/256 de muestra
+    out.sincronizado = (a.ciclos == _cfg.ciclos) && (a.cruceN_q8 > a.cruce0_q8);
+    if (out.sincronizado) {
+      int64_t fsCanal_mHz = (int64_t)(_cfg.muestreo_Hz / 2) * 1000LL;
+      fsCanal_mHz += fsCanal_mHz * _cfg.errorReloj_ppm / 1000000LL;   // reloj rápido → fs real mayor
+      out.frecuencia_mHz = (uint32_t)(((uint64_t)fsCanal_mHz * a.ciclos * 256ULL) / (a.cruceN_q8 - a.cruce0_q8));
+    }
+
+    // Seguimiento del offset DC: la media residual se incorpora para la siguiente ventana
+    _offsetV += (int16_t)lroundf(mediaV);
+    _offsetI += (int16_t)lroundf(mediaI);
+  }
+};
+
+// La ISR del ADC se define una sola vez en ACMeterWSN.cpp: definida aquí, un sketch con más
+// de un .cpp que incluya este header tendría dos definiciones del vector.
+extern "C" void ADC_vect(void) __attribute__((signal, used, externally_visible));
@@ -0,0 +1,60 @@
+#pragma once
+#include <Arduino.h>
+#include <math.h>
+
+/** Analizador de armónicos en el nodo: banco de Goertzel en punto fijo (coeficiente Q14,
+  *  estados int32) para la fundamental y los primeros armónicos impares de una forma de onda
+  *  capturada por ACMeterWSN. Como la ventana sincronizada contiene ciclos completos, la
+  *  ventana rectangular no introduce fuga apreciable y no hace falta FFT.
+  *  Con el resultado se arma un PacketArmonicos de CodecWSN: unos pocos bytes al aire en vez
+  *  de la forma de onda completa.
+  *  Los armónicos pares se omiten: en cargas no lineales típicas (rectificador + capacitor)
+  *  son despreciables y así el THD cuesta la mitad de cálculo.
+  *  Autores: Francisco Rosales, Omar Tox, 2025-09.
+**/
+
+template <uint8_t N_IMPARES = 5>   // h = 1, 3, 5, ..., 2·N_IMPARES−1
+class HarmonicAnalyzerWSN {
+public:
+  struct Resultado {
+    uint32_t thd_pm;                   // distorsión armónica total (por mil)
+    uint16_t relativa_pm[N_IMPARES];   // magnitud de cada armónico / fundamental (por mil); [0] = 1000
+    float    amplitudFundamental;      // pico de la fundamental en cuentas ADC
+  };
+
+  /* x: muestras centradas; ciclosPorMuestra = f_red / f_muestreo_canal */
+  static bool analyze(const int16_t* x, uint16_t n, float ciclosPorMuestra, Resultado& out) {
+    out = Resultado();
+    if (x == nullptr || n < 8 || ciclosPorMuestra <= 0.0f) return false;
+
+    uint64_t p1 = goertzel(x, n, ciclosPorMuestra);
+    if (p1 == 0) return false;
+    out.amplitudFundamental = 2.0f * sqrtf((float)p1) / n;
+    out.relativa_pm[0] = 1000;
+
+    float sumaArmonicos = 0.0f;
+    for (uint8_t k = 1; k < N_IMPARES; ++k) {
+      float fh = ciclosPorMuestra * (2 * k + 1);
+      if (fh >= 0.5f) break;           // por encima de Nyquist: no se puede medir
+      float relativa2 = (float)goertzel(x, n, fh) / (float)p1;
+      sumaArmonicos += relativa2;
+      float pm = sqrtf(relativa2) * 1000.0f;
+      out.relativa_pm[k] = (uint16_t)(pm > 65535.0f ? 65535.0f : pm);
+    }
+    out.thd_pm = (uint32_t)lroundf(sqrtf(sumaArmonicos) * 1000.0f);
+    return true;
+  }
+
+  /* Potencia (|X|²) de la componente en ω = 2π·ciclosPorMuestra, Goertzel en Q14 */
+  static uint64_t goertzel(const int16_t* x, uint16_t n, float ciclosPorMuestra) {
+    const int32_t coef = (int32_t)lroundf(2.0f * cosf(2.0f * (float)PI * ciclosPorMuestra) * 16384.0f);
+    int32_t s1 = 0, s2 = 0;
+    for (uint16_t i = 0; i < n; ++i) {
+      int32_t s0 = x[i] + (int32_t)(((int64_t)coef * s1) >> 14) - s2;
+      s2 = s1;
+      s1 = s0;
+    }
+    int64_t p = (int64_t)s1 * s1 + (int64_t)s2 * s2 - (((int64_t)coef * s1) >> 14) * s2;
+    return p > 0 ? (uint64_t)p : 0;
+  }
+};
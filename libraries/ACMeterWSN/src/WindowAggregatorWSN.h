@@ -0,0 +1,115 @@
+#pragma once
+#include <Arduino.h>
+#include "ACMeterWSN.h"
+#include "CodecWSN.h"
+
+/** Agregación por ventana de reporte: el nodo mide a una tasa local alta y solo envía
+  *  un PacketResumen por ventana (min/max/media de V e I, energía activa en mWh y
+  *  conteo de eventos sag/swell/sobrecorriente). Memoria O(1) y aritmética entera:
+  *  cada medición actualiza acumuladores, no se guarda ninguna muestra.
+  *  Así el período de reporte puede estirarse sin perder lo que pasa entre envíos.
+  *  Autores: Francisco Rosales, Omar Tox, 2025-09.
+**/
+
+class WindowAggregatorWSN {
+public:
+  /* Umbrales de eventos; cuenta cada entrada a la condición, no cada muestra dentro de ella */
+  struct Cfg {
+    int16_t vSag_cV      = 19000;  // 190.00 V
+    int16_t vSwell_cV    = 25000;  // 250.00 V
+    int16_t iSobre_mA    = 20000;  // 20 A
+  };
+
+  void begin(const Cfg& cfg, uint32_t ahora_ms) {
+    _cfg = cfg;
+    reset(ahora_ms);
+  }
+
+  /* Agrega el resultado de una ventana de ACMeterWSN */
+  void add(const ACMeterWSN::Resultado& r, uint32_t ahora_ms) {
+    add((int16_t)lroundf(r.vrms_V * 100.0f),
+        (int16_t)lroundf(r.irms_A * 1000.0f),
+        (int32_t)lroundf(r.potenciaReal_W * 10.0f),
+        ahora_ms);
+  }
+
+  /* Agrega una medición en enteros: V en centésimas, I en mA, P en décimas de W */
+  void add(int16_t v_cV, int16_t i_mA, int32_t p_dW, uint32_t ahora_ms) {
+    if (_n == 0) {
+      _vMin = _vMax = v_cV;
+      _iMin = _iMax = i_mA;
+    } else {
+      if (v_cV < _vMin) _vMin = v_cV;
+      if (v_cV > _vMax) _vMax = v_cV;
+      if (i_mA < _iMin) _iMin = i_mA;
+      if (i_mA > _iMax) _iMax = i_mA;
+    }
+    _sumV += v_cV;
+    _sumI += i_mA;
+    if (_n < 0xFFFF) ++_n;
+
+    // Energía: P·dt con el intervalo desde la medición anterior (dW·ms → mWh cada 36000)
+    uint32_t dt_ms = ahora_ms - _ultima_ms;
+    _ultima_ms = ahora_ms;
+    if (p_dW > 0) {
+      _resto_dWms += (uint32_t)p_dW * dt_ms;      // < 2^32 mientras dt < ~57 s a 7.5 kW
+      _energia_mWh += _resto_dWms / 36000UL;
+      _resto_dWms  %= 36000UL;
+    }
+
+    contarEvento(v_cV < _cfg.vSag_cV,   _enSag,   _eventosSag);
+    contarEvento(v_cV > _cfg.vSwell_cV, _enSwell, _eventosSwell);
+    contarEvento(i_mA > _cfg.iSobre_mA, _enSobreI, _eventosSobreI);
+  }
+
+  uint16_t samples() const { return _n; }
+
+  /* Llena el resumen de la ventana y abre la siguiente. false si no hubo mediciones. */
+  bool close(PacketResumen& out, uint16_t id, uint32_t ahora_ms) {
+    if (_n == 0) { reset(ahora_ms); return false; }
+    out.id          = id;
+    out.duracion_s  = (uint16_t)min((ahora_ms - _inicio_ms) / 1000UL, 65535UL);
+    out.muestras    = _n;
+    out.vMin        = _vMin;
+    out.vMax        = _vMax;
+    out.vMedia      = (int16_t)(_sumV / _n);
+    out.iMin        = _iMin;
+    out.iMax        = _iMax;
+    out.iMedia      = (int16_t)(_sumI / _n);
+    out.energia_mWh = _energia_mWh;
+    out.eventosSag    = _eventosSag;
+    out.eventosSwell  = _eventosSwell;
+    out.eventosSobreI = _eventosSobreI;
+    _totalEnergia_mWh += _energia_mWh;
+    reset(ahora_ms);
+    return true;
+  }
+
+  /* Energía acumulada desde begin(), sin contar la ventana en curso */
+  uint32_t totalEnergy_mWh() const { return _totalEnergia_mWh; }
+
+private:
+  Cfg      _cfg;
+  uint32_t _inicio_ms = 0, _ultima_ms = 0;
+  uint16_t _n = 0;
+  int16_t  _vMin = 0, _vMax = 0, _iMin = 0, _iMax = 0;
+  int32_t  _sumV = 0, _sumI = 0;
+  uint32_t _resto_dWms = 0;
+  uint32_t _energia_mWh = 0;
+  uint32_t _totalEnergia_mWh = 0;
+  uint8_t  _eventosSag = 0, _eventosSwell = 0, _eventosSobreI = 0;
+  bool     _enSag = false, _enSwell = false, _enSobreI = false;
+
+  static void contarEvento(bool condicion, bool& dentro, uint8_t& contador) {
+    if (condicion && !dentro && contador < 255) ++contador;
+    dentro = condicion;
+  }
+
+  void reset(uint32_t ahora_ms) {
+    _inicio_ms = _ultima_ms = ahora_ms;
+    _n = 0;
+    _sumV = _sumI = 0;
+    _energia_mWh = 0;          // el resto fraccionario pasa a la siguiente ventana
+    _eventosSag = _eventosSwell = _eventosSobreI = 0;
+  }
+};
@@ -63,6 +63,24 @@ public:
    * @return true si es momento de realizar una transmisión, false en caso contrario.
    */
   bool tick() {
+    if (!update()) return false; // Detiene toda transmisión por debajo del corte.
+
+    // Comprueba si ha transcurrido el tiempo para el próximo envío.
+    uint32_t ahoraMs = millis();
+    if ((int32_t)(ahoraMs - _msProximoEnvio) >= 0) {
+      _msProximoEnvio = ahoraMs + currentPeriod(); // Programa el siguiente envío.
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Mide la batería y actualiza el nivel sin mirar el reloj.
+   * Pensado para cuando un planificador externo (SchedulerWSN) decide el momento
+   * del envío y solo necesita currentPeriod() actualizado.
+   * @return false si la batería está por debajo del voltaje de corte.
+   */
+  bool update() {
     // Obtiene el voltaje actual, ya sea de una lectura real o de un valor inyectado para pruebas.
     float voltajeBateria_V = (_usarLecturaInyectada)
                                  ? _voltajeInyectado_V
@@ -72,20 +90,13 @@ public:
     // Verifica si el voltaje está por debajo del umbral de corte.
     if (voltajeBateria_V < _configuracion.corteVoltaje_V) {
       _bloqueadoPorCorte = true;
-      return false; // Detiene toda transmisión.
+      return false;
     }
     _bloqueadoPorCorte = false;
 
     // Actualiza el nivel de energía actual (ALTO, MEDIO, BAJO) usando histéresis.
     actualizarNivelConHisteresis(voltajeBateria_V);
-
-    // Comprueba si ha transcurrido el tiempo para el próximo envío.
-    uint32_t ahoraMs = millis();
-    if ((int32_t)(ahoraMs - _msProximoEnvio) >= 0) {
-      _msProximoEnvio = ahoraMs + currentPeriod(); // Programa el siguiente envío.
-      return true;
-    }
-    return false;
+    return true;
   }
 
   /**
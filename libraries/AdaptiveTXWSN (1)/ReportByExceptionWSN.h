@@ -0,0 +1,106 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @class ReportByExceptionWSN
+ * @brief Política de reporte por excepción para complementar AdaptiveTXWSN.
+ * * El nodo mide a su ritmo normal pero solo transmite cuando algún canal sale de
+ * una banda muerta alrededor del último valor REPORTADO, o cuando vence el latido
+ * (heartbeat). Con cargas estables se evitan despertares del radio con lecturas
+ * idénticas; el coordinador interpreta el silencio dentro del latido como "sin
+ * cambios" y solo declara perdido un nodo cuando el latido vence.
+ * Los canales y umbrales son enteros en la unidad que use el sketch
+ * (centésimas de V, mA, ...).
+ */
+template <uint8_t N_CANALES = 4>
+class ReportByExceptionWSN {
+public:
+  /**
+   * @struct Cfg
+   * @brief Banda muerta por canal y período máximo sin reportar.
+   */
+  struct Cfg {
+    int32_t  bandaMuerta[N_CANALES] = {};  // |valor - reportado| > banda dispara envío (0 = cualquier cambio).
+    uint32_t latido_ms = 60000;            // Envío forzado aunque nada cambie.
+  };
+
+  /**
+   * @enum Reason
+   * @brief Motivo del último envío decidido por check().
+   */
+  enum Reason : uint8_t { REASON_NONE = 0, REASON_FIRST, REASON_CHANGE, REASON_HEARTBEAT };
+
+  void begin(const Cfg& cfg) {
+    _configuracion = cfg;
+    _hayReporte    = false;
+    _motivo        = REASON_NONE;
+    _suprimidos    = 0;
+  }
+
+  /**
+   * @brief Decide si los valores actuales deben transmitirse.
+   * No modifica la referencia: llamar a commit() cuando el envío se haya hecho.
+   * @return true si hay que transmitir; el motivo queda en reason().
+   */
+  bool check(const int32_t valores[N_CANALES], uint32_t ahoraMs = millis()) {
+    if (!_hayReporte) {
+      _motivo = REASON_FIRST;
+    } else if (fueraDeBanda(valores)) {
+      _motivo = REASON_CHANGE;
+    } else if ((uint32_t)(ahoraMs - _msUltimoReporte) >= _configuracion.latido_ms) {
+      _motivo = REASON_HEARTBEAT;
+    } else {
+      _motivo = REASON_NONE;
+      if (_suprimidos < 0xFFFF) ++_suprimidos;
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief true si el próximo check() transmitirá sin importar los valores (primer
+   * reporte o latido vencido): el sketch puede despertar el radio antes de medir.
+   */
+  bool mustReport(uint32_t ahoraMs = millis()) const {
+    return !_hayReporte || (uint32_t)(ahoraMs - _msUltimoReporte) >= _configuracion.latido_ms;
+  }
+
+  /**
+   * @brief Registra los valores enviados como nueva referencia y reinicia el latido.
+   */
+  void commit(const int32_t valores[N_CANALES], uint32_t ahoraMs = millis()) {
+    for (uint8_t i = 0; i < N_CANALES; ++i) _reportado[i] = valores[i];
+    _msUltimoReporte = ahoraMs;
+    _hayReporte      = true;
+  }
+
+  /** @brief Obliga a reportar en el próximo check() (p.ej. tras un comando remoto). */
+  void invalidate() { _hayReporte = false; }
+
+  // --- Métodos de Acceso (Getters) ---
+  Reason   reason()     const { return _motivo; }
+  uint32_t heartbeat()  const { return _configuracion.latido_ms; }
+  uint16_t suppressed() const { return _suprimidos; }  // Mediciones no enviadas desde begin().
+  int32_t  reported(uint8_t canal) const { return _reportado[canal]; }
+
+  // --- Métodos de Configuración en Tiempo de Ejecución (Setters) ---
+  void setDeadband(uint8_t canal, int32_t banda) { _configuracion.bandaMuerta[canal] = banda; }
+  void setHeartbeat(uint32_t latido_ms)          { _configuracion.latido_ms = latido_ms; }
+
+private:
+  Cfg      _configuracion;
+  int32_t  _reportado[N_CANALES] = {};
+  uint32_t _msUltimoReporte = 0;
+  bool     _hayReporte      = false;
+  Reason   _motivo          = REASON_NONE;
+  uint16_t _suprimidos      = 0;
+
+  bool fueraDeBanda(const int32_t valores[N_CANALES]) const {
+    for (uint8_t i = 0; i < N_CANALES; ++i) {
+      int32_t delta = valores[i] - _reportado[i];
+      if (delta < 0) delta = -delta;
+      if (delta > _configuracion.bandaMuerta[i]) return true;
+    }
+    return false;
+  }
+};
@@ -46,6 +46,151 @@ inline bool decodePacketSafe(const uint8_t *buf, size_t len, Packet &out) {
   return true;
 }
 
+/* ===================== Registros tipados (frames versión 2) ===================== */
+/* Además del Packet fijo, un frame v2 lleva [TIPO][datos] con LEN = 1 + tamaño del registro.
+ * Todos los registros son big-endian y caben en un payload de nRF24 (32 B con el framing). */
+
+enum TipoRegistro : uint8_t {
+  REG_ARMONICOS = 0x10,   // resumen de armónicos (PacketArmonicos)
+  REG_RESUMEN   = 0x11,   // resumen de una ventana de reporte (PacketResumen)
+  REG_ACK       = 0x12,   // confirmación del coordinador con comandos para el nodo (PacketAck)
+};
+
+/* --- Resumen de armónicos: THD de V e I y armónicos impares de corriente (10 bytes) --- */
+struct PacketArmonicos {
+  uint16_t id;
+  uint16_t thdV;        // por mil
+  uint16_t thdI;        // por mil
+  uint8_t  armI[4];     // h3, h5, h7, h9 de corriente en medios por ciento de la fundamental (0..127.5 %)
+};
+
+constexpr size_t ARMONICOS_SIZE = 10;
+
+inline void encodeArmonicos(uint8_t *buf, const PacketArmonicos &p) {
+  buf[0] = uint8_t(p.id >> 8);
+  buf[1] = uint8_t(p.id);
+  buf[2] = uint8_t(p.thdV >> 8);
+  buf[3] = uint8_t(p.thdV);
+  buf[4] = uint8_t(p.thdI >> 8);
+  buf[5] = uint8_t(p.thdI);
+  for (uint8_t i = 0; i < 4; ++i) buf[6 + i] = p.armI[i];
+}
+
+inline bool decodeArmonicos(const uint8_t *buf, size_t len, PacketArmonicos &out) {
+  if (!buf || len < ARMONICOS_SIZE) return false;
+  out.id   = uint16_t((uint16_t(buf[0]) << 8) | buf[1]);
+  out.thdV = uint16_t((uint16_t(buf[2]) << 8) | buf[3]);
+  out.thdI = uint16_t((uint16_t(buf[4]) << 8) | buf[5]);
+  for (uint8_t i = 0; i < 4; ++i) out.armI[i] = buf[6 + i];
+  return true;
+}
+
+/* --- Resumen de ventana: min/max/media, energía y eventos (25 bytes) --- */
+struct PacketResumen {
+  uint16_t id;
+  uint16_t duracion_s;    // duración de la ventana
+  uint16_t muestras;      // mediciones agregadas
+  int16_t  vMin, vMax, vMedia;   // centésimas de V
+  int16_t  iMin, iMax, iMedia;   // mA
+  uint32_t energia_mWh;   // energía activa acumulada en la ventana
+  uint8_t  eventosSag;    // entradas por debajo del umbral de voltaje
+  uint8_t  eventosSwell;  // entradas por encima del umbral de voltaje
+  uint8_t  eventosSobreI; // entradas por encima del umbral de corriente
+};
+
+constexpr size_t RESUMEN_SIZE = 25;
+
+inline void encodeResumen(uint8_t *buf, const PacketResumen &p) {
+  const uint16_t campos[9] = { p.id, p.duracion_s, p.muestras,
+                               uint16_t(p.vMin), uint16_t(p.vMax), uint16_t(p.vMedia),
+                               uint16_t(p.iMin), uint16_t(p.iMax), uint16_t(p.iMedia) };
+  for (uint8_t i = 0; i < 9; ++i) {
+    buf[2 * i]     = uint8_t(campos[i] >> 8);
+    buf[2 * i + 1] = uint8_t(campos[i]);
+  }
+  buf[18] = uint8_t(p.energia_mWh >> 24);
+  buf[19] = uint8_t(p.energia_mWh >> 16);
+  buf[20] = uint8_t(p.energia_mWh >> 8);
+  buf[21] = uint8_t(p.energia_mWh);
+  buf[22] = p.eventosSag;
+  buf[23] = p.eventosSwell;
+  buf[24] = p.eventosSobreI;
+}
+
+inline bool decodeResumen(const uint8_t *buf, size_t len, PacketResumen &out) {
+  if (!buf || len < RESUMEN_SIZE) return false;
+  uint16_t campos[9];
+  for (uint8_t i = 0; i < 9; ++i) campos[i] = uint16_t((uint16_t(buf[2 * i]) << 8) | buf[2 * i + 1]);
+  out.id         = campos[0];
+  out.duracion_s = campos[1];
+  out.muestras   = campos[2];
+  out.vMin   = int16_t(campos[3]); out.vMax = int16_t(campos[4]); out.vMedia = int16_t(campos[5]);
+  out.iMin   = int16_t(campos[6]); out.iMax = int16_t(campos[7]); out.iMedia = int16_t(campos[8]);
+  out.energia_mWh = (uint32_t(buf[18]) << 24) | (uint32_t(buf[19]) << 16) |
+                    (uint32_t(buf[20]) << 8)  |  uint32_t(buf[21]);
+  out.eventosSag    = buf[22];
+  out.eventosSwell  = buf[23];
+  out.eventosSobreI = buf[24];
+  return true;
+}
+
+/* --- ACK del coordinador: confirma un paquete y baja hasta 4 comandos (4 + 5·n bytes) ---
+ * Los comandos son absolutos (estado, no "alternar"): repetirlos en dos ACK seguidos es
+ * inofensivo, y así un ACK perdido no pierde el comando. */
+enum TipoComando : uint8_t {
+  CMD_RELE       = 0x01,   // valor: 0 = apagado, 1 = encendido
+  CMD_PERIODO_MS = 0x02,   // nuevo período de reporte
+  CMD_HORA       = 0x03,   // segundos del reloj de la red (sincronía de las marcas de tiempo)
+};
+
+struct ComandoWSN {
+  uint8_t  tipo;
+  uint32_t valor;
+};
+
+constexpr uint8_t MAX_COMANDOS_ACK = 4;
+constexpr size_t  ACK_BASE_SIZE    = 4;
+constexpr size_t  COMANDO_SIZE     = 5;
+
+struct PacketAck {
+  uint8_t    nodo;
+  uint16_t   idPaquete;   // id del Packet que se confirma
+  uint8_t    nComandos;
+  ComandoWSN comandos[MAX_COMANDOS_ACK];
+};
+
+inline size_t encodeAck(uint8_t *buf, const PacketAck &p) {
+  const uint8_t n = p.nComandos > MAX_COMANDOS_ACK ? MAX_COMANDOS_ACK : p.nComandos;
+  buf[0] = p.nodo;
+  buf[1] = uint8_t(p.idPaquete >> 8);
+  buf[2] = uint8_t(p.idPaquete);
+  buf[3] = n;
+  for (uint8_t i = 0; i < n; ++i) {
+    uint8_t *c = buf + ACK_BASE_SIZE + COMANDO_SIZE * i;
+    c[0] = p.comandos[i].tipo;
+    c[1] = uint8_t(p.comandos[i].valor >> 24);
+    c[2] = uint8_t(p.comandos[i].valor >> 16);
+    c[3] = uint8_t(p.comandos[i].valor >> 8);
+    c[4] = uint8_t(p.comandos[i].valor);
+  }
+  return ACK_BASE_SIZE + COMANDO_SIZE * n;
+}
+
+inline bool decodeAck(const uint8_t *buf, size_t len, PacketAck &out) {
+  if (!buf || len < ACK_BASE_SIZE) return false;
+  out.nodo      = buf[0];
+  out.idPaquete = uint16_t((uint16_t(buf[1]) << 8) | buf[2]);
+  out.nComandos = buf[3];
+  if (out.nComandos > MAX_COMANDOS_ACK || len < ACK_BASE_SIZE + COMANDO_SIZE * out.nComandos) return false;
+  for (uint8_t i = 0; i < out.nComandos; ++i) {
+    const uint8_t *c = buf + ACK_BASE_SIZE + COMANDO_SIZE * i;
+    out.comandos[i].tipo  = c[0];
+    out.comandos[i].valor = (uint32_t(c[1]) << 24) | (uint32_t(c[2]) << 16) |
+                            (uint32_t(c[3]) << 8)  |  uint32_t(c[4]);
+  }
+  return true;
+}
+
 /* ============================ Framing robusto ================================ */
 /* Frame en la línea de datos (stream AT):
  *   [SOF0=0xAA][SOF1=0x55][VER][LEN=8][PAYLOAD(8)][CRC16_H][CRC16_L]
@@ -60,6 +205,10 @@ namespace WSNFrame {
   constexpr uint8_t MARCADOR_INICIO_1 = 0x55; 
   // Versión del protocolo: Permite identificar la versión del formato del frame.
   constexpr uint8_t VERSION_PROTOCOLO  = 0x01;
+  // Versión de registros tipados: el primer byte del payload es un TipoRegistro.
+  constexpr uint8_t VERSION_REGISTROS  = 0x02;
+  // Payload máximo de un frame v2 (TIPO incluido): 26 + 6 de framing = 32 B (un paquete nRF24).
+  constexpr size_t  MAX_PAYLOAD_SIZE   = 26;
 
   constexpr size_t HEADER_SIZE  = 2 /*SOF*/ + 1 /*VER*/ + 1 /*LEN*/; // Tamaño de la cabecera del frame.
   constexpr size_t TRAILER_SIZE = 2 /*CRC16*/; // Tamaño del trailer (CRC) del frame.
@@ -98,6 +247,44 @@ namespace WSNFrame {
     return FRAME_SIZE; // 14
   }
 
+  /* --- Empaquetar un registro tipado (v2): [SOF][VER=2][LEN][TIPO][datos][CRC] --- */
+  inline size_t encodeRecordFrame(uint8_t* out, uint8_t tipo, const uint8_t* datos, size_t len) {
+    if (len + 1 > MAX_PAYLOAD_SIZE) return 0;
+    out[0] = MARCADOR_INICIO_0;
+    out[1] = MARCADOR_INICIO_1;
+    out[2] = VERSION_REGISTROS;
+    out[3] = uint8_t(len + 1);
+    out[4] = tipo;
+    for (size_t i = 0; i < len; ++i) out[5 + i] = datos[i];
+
+    uint16_t crc = crc16_ccitt(out + 2, 2 + 1 + len);
+    out[5 + len] = uint8_t(crc >> 8);
+    out[6 + len] = uint8_t(crc);
+    return HEADER_SIZE + 1 + len + TRAILER_SIZE;
+  }
+
+  inline size_t encodeFrameArmonicos(uint8_t* out, const PacketArmonicos& p) {
+    uint8_t datos[ARMONICOS_SIZE];
+    encodeArmonicos(datos, p);
+    return encodeRecordFrame(out, REG_ARMONICOS, datos, ARMONICOS_SIZE);
+  }
+
+  inline size_t encodeFrameResumen(uint8_t* out, const PacketResumen& p) {
+    uint8_t datos[RESUMEN_SIZE];
+    encodeResumen(datos, p);
+    return encodeRecordFrame(out, REG_RESUMEN, datos, RESUMEN_SIZE);
+  }
+
+  // ACK con 4 comandos: 4 + 1 + 24 + 2 = 31 B, cabe en la carga del ACK de un nRF24
+  inline size_t encodeFrameAck(uint8_t* out, const PacketAck& p) {
+    uint8_t datos[ACK_BASE_SIZE + COMANDO_SIZE * MAX_COMANDOS_ACK];
+    size_t len = encodeAck(datos, p);
+    return encodeRecordFrame(out, REG_ACK, datos, len);
+  }
+
+  // Tamaño máximo de cualquier frame (útil para dimensionar buffers)
+  constexpr size_t MAX_FRAME_SIZE = HEADER_SIZE + MAX_PAYLOAD_SIZE + TRAILER_SIZE;
+
   /* --- Parser por bytes (recomendado para el coordinador) --- */
   struct Parser {
     enum State : uint8_t {
@@ -113,7 +300,7 @@ namespace WSNFrame {
     State st = FIND_SOF0;      // estado actual
     uint8_t ver = 0;           // versión leída
     uint8_t len = 0;           // longitud esperada del payload
-    uint8_t pay[PACKET_SIZE];  // buffer temporal para el payload
+    uint8_t pay[MAX_PAYLOAD_SIZE]; // buffer del payload (tras un frame válido conserva su contenido)
     uint8_t idx = 0;           // cuántos bytes de payload llevas
     uint16_t crc_run = 0xFFFF; // CRC incremental (se reinicia al detectar SOF completo)
     uint8_t crc_h = 0;         // guarda el byte alto del CRC recibido
@@ -122,10 +309,17 @@ namespace WSNFrame {
     void reset() {
       st = FIND_SOF0; ver = 0; len = 0; idx = 0; crc_run = 0xFFFF; crc_h = 0;
     }
+
+    /* Tipo del último frame v2 válido (0 si fue un Packet v1) */
+    uint8_t tipo() const { return (ver == VERSION_REGISTROS && len > 0) ? pay[0] : 0; }
+    /* Datos del registro (sin el byte de TIPO) y su longitud */
+    const uint8_t* datos() const { return pay + 1; }
+    size_t longitudDatos() const { return len > 0 ? len - 1 : 0; }
   };
 
-  /* Alimenta un byte. Devuelve true si decodificó un Packet válido en 'out'. */
-  inline bool feed(Parser& p, uint8_t b, Packet& out) {
+  /* Alimenta un byte. Devuelve true si completó un frame válido de cualquier versión.
+     ver/len/pay quedan disponibles hasta que llegue el siguiente SOF. */
+  inline bool feedFrame(Parser& p, uint8_t b) {
     switch (p.st) {
       case Parser::FIND_SOF0:
         if (b == MARCADOR_INICIO_0) p.st = Parser::FIND_SOF1;
@@ -142,12 +336,16 @@ namespace WSNFrame {
         p.st = Parser::READ_LEN; 
         return false;
 
-      case Parser::READ_LEN:
+      case Parser::READ_LEN: {
         p.len = b;
         p.crc_run = crc16_ccitt(&b, 1, p.crc_run);
-        if (p.len != PACKET_SIZE) { p.reset(); }
+        const bool lenOk = (p.ver == VERSION_PROTOCOLO) ? (p.len == PACKET_SIZE)
+                         : (p.ver == VERSION_REGISTROS) ? (p.len >= 1 && p.len <= MAX_PAYLOAD_SIZE)
+                         : false;
+        if (!lenOk) { p.reset(); }
         else { p.idx = 0; p.st = Parser::READ_PAYLOAD; }
         return false;
+      }
 
       case Parser::READ_PAYLOAD:
         p.pay[p.idx++] = b;
@@ -163,16 +361,23 @@ namespace WSNFrame {
       case Parser::READ_CRC_L: {
         uint16_t crc_rx = (uint16_t(p.crc_h) << 8) | b;
         bool ok = (crc_rx == p.crc_run);
-        if (ok) {
-          out = decodePacketFast(p.pay);
-        }
-        p.reset();
+        p.st = Parser::FIND_SOF0; p.idx = 0; p.crc_run = 0xFFFF; p.crc_h = 0;
+        if (!ok) p.reset();
         return ok;
       }
     }
     return false;
   }
 
+  /* Alimenta un byte. Devuelve true si decodificó un Packet válido en 'out'.
+     Los frames v2 se consumen sin reportarse (usar feedFrame para leerlos). */
+  inline bool feed(Parser& p, uint8_t b, Packet& out) {
+    if (!feedFrame(p, b)) return false;
+    if (p.ver != VERSION_PROTOCOLO) return false;
+    out = decodePacketFast(p.pay);
+    return true;
+  }
+
   /* --- Decoder de buffer: busca SOF en un bloque y consume lo necesario.
      Útil si prefieres llenar un ring-buffer y llamar por tandas.            --- */
   inline bool decodeFromBuffer(const uint8_t* in, size_t inLen, size_t& consumed, Packet& out) {
@@ -0,0 +1,95 @@
+#pragma once
+#include "CodecWSN.h"
+
+/** Cola de comandos de bajada del coordinador, por nodo, que viajan dentro del ACK
+  *  binario (REG_ACK) justo después de cada subida: el nodo solo escucha unos ms tras
+  *  enviar y nadie contesta "ON" a ciegas.
+  *  Los comandos se fusionan por tipo: si el relé se pide encendido y luego apagado
+  *  antes de que el nodo hable, solo baja el último estado. Cada comando viaja en
+  *  'repeticiones' ACK seguidos (son absolutos, repetirlos es inofensivo) y luego sale.
+  *  Memoria estática: MAX_NODOS × MAX_COMANDOS_ACK comandos.
+**/
+
+template <uint8_t MAX_NODOS = 8>
+class ColaBajadaWSN {
+public:
+  /* Encola (o reemplaza, si ya había uno del mismo tipo) un comando para el nodo.
+   * Devuelve false si la tabla de nodos o la cola de ese nodo están llenas. */
+  bool encolar(uint8_t nodo, uint8_t tipo, uint32_t valor, uint8_t repeticiones = 2) {
+    Nodo* n = buscar(nodo, true);
+    if (!n) return false;
+    for (uint8_t i = 0; i < n->pendientes; ++i) {
+      if (n->cmd[i].tipo == tipo) {
+        n->cmd[i].valor = valor;
+        n->restan[i]    = repeticiones;
+        ++_fusionados;
+        return true;
+      }
+    }
+    if (n->pendientes >= MAX_COMANDOS_ACK) return false;
+    n->cmd[n->pendientes].tipo  = tipo;
+    n->cmd[n->pendientes].valor = valor;
+    n->restan[n->pendientes]    = repeticiones;
+    ++n->pendientes;
+    return true;
+  }
+
+  /* Arma el frame REG_ACK para el paquete recibido (destino de WSNFrame::MAX_FRAME_SIZE),
+   * con lo pendiente del nodo; sin comandos es un ACK de 11 B. Devuelve la longitud. */
+  size_t armarAck(uint8_t nodo, uint16_t idPaquete, uint8_t* frame) {
+    PacketAck ack;
+    ack.nodo      = nodo;
+    ack.idPaquete = idPaquete;
+    ack.nComandos = 0;
+    Nodo* n = buscar(nodo, false);
+    if (n) {
+      for (uint8_t i = 0; i < n->pendientes; ++i) ack.comandos[ack.nComandos++] = n->cmd[i];
+      consumir(*n);
+    }
+    return WSNFrame::encodeFrameAck(frame, ack);
+  }
+
+  uint8_t pendientes(uint8_t nodo) const {
+    for (uint8_t i = 0; i < _nNodos; ++i)
+      if (_nodos[i].id == nodo) return _nodos[i].pendientes;
+    return 0;
+  }
+
+  /* Comandos que reemplazaron a otro del mismo tipo antes de bajar */
+  uint32_t fusionados() const { return _fusionados; }
+
+private:
+  struct Nodo {
+    uint8_t    id;
+    uint8_t    pendientes;
+    ComandoWSN cmd[MAX_COMANDOS_ACK];
+    uint8_t    restan[MAX_COMANDOS_ACK];   // ACK en los que aún debe viajar
+  };
+
+  Nodo     _nodos[MAX_NODOS];
+  uint8_t  _nNodos = 0;
+  uint32_t _fusionados = 0;
+
+  Nodo* buscar(uint8_t nodo, bool crear) {
+    for (uint8_t i = 0; i < _nNodos; ++i)
+      if (_nodos[i].id == nodo) return &_nodos[i];
+    if (!crear || _nNodos >= MAX_NODOS) return nullptr;
+    Nodo& n = _nodos[_nNodos++];
+    n.id = nodo;
+    n.pendientes = 0;
+    return &n;
+  }
+
+  // Descuenta una repetición y compacta los que ya terminaron (conserva el orden)
+  static void consumir(Nodo& n) {
+    uint8_t k = 0;
+    for (uint8_t i = 0; i < n.pendientes; ++i) {
+      if (n.restan[i] > 1) {
+        n.cmd[k]    = n.cmd[i];
+        n.restan[k] = (uint8_t)(n.restan[i] - 1);
+        ++k;
+      }
+    }
+    n.pendientes = k;
+  }
+};
@@ -21,6 +21,17 @@ public:
     Pins  pins;              // Pines utilizados por proyecto
     bool  invertPwr = false; // Lógica del gate de voltaje de los sensores (Si se abre con HIGH se queda así)
     bool  bootSleep = true;  // Estado en que arranca el sistema al encenderse, apagado por defecto
+    uint16_t settle_us = 0;  // Tiempo de estabilización de los sensores tras energizarlos (pipeline)
+  };
+
+  /* Fases del ciclo despierto; mark() guarda el instante de cada una respecto a startWake() */
+  enum Phase : uint8_t {
+    PH_SETTLED = 0, // sensores estables
+    PH_MEASURED,    // mediciones terminadas
+    PH_RADIO,       // ON/SLEEP en alto (XBee despierto)
+    PH_TX,          // transmisión terminada
+    PH_SLEEP,       // XBee confirmado dormido
+    PH_COUNT
   };
 
   /* Inicializar los pines dados con la lógica */
@@ -57,22 +68,107 @@ public:
     digitalWrite(_cfg.pins.pwrSens, level ? HIGH : LOW);
   }
 
-  /** Suspender el programa durante un tiempo específico (ms) **/
-  void sleepFor_ms(uint32_t ms) {
-    while (ms >= 8000) { LowPower.powerDown(SLEEP_8S,  ADC_OFF, BOD_OFF); ms -= 8000; }
-    if    (ms >= 4000) { LowPower.powerDown(SLEEP_4S,  ADC_OFF, BOD_OFF); ms -= 4000; }
-    if    (ms >= 2000) { LowPower.powerDown(SLEEP_2S,  ADC_OFF, BOD_OFF); ms -= 2000; }
-    if    (ms >= 1000) { LowPower.powerDown(SLEEP_1S,  ADC_OFF, BOD_OFF); ms -= 1000; }
-    while (ms >= 500)  { LowPower.powerDown(SLEEP_500MS, ADC_OFF, BOD_OFF); ms -= 500; }
-    while (ms >= 250)  { LowPower.powerDown(SLEEP_250MS, ADC_OFF, BOD_OFF); ms -= 250; }
-    while (ms >= 120)  { LowPower.powerDown(SLEEP_120MS, ADC_OFF, BOD_OFF); ms -= 120; }
-    while (ms >= 60)   { LowPower.powerDown(SLEEP_60MS,  ADC_OFF, BOD_OFF); ms -= 60; }
-    while (ms >= 30)   { LowPower.powerDown(SLEEP_30MS,  ADC_OFF, BOD_OFF); ms -= 30; }
-    while (ms >= 15)   { LowPower.powerDown(SLEEP_15MS,  ADC_OFF, BOD_OFF); ms -= 15; }
+  /* --- Despertar en paralelo (pipeline) ---
+   * startWake() levanta SLEEP_RQ y energiza los sensores a la vez, sin esperar.
+   * Mientras el XBee despierta se mide; awaitRadio() solo espera lo que falte
+   * de la latencia del radio y retorna en cuanto ON/SLEEP se afirma. */
+  void startWake() {
+    startSensors();
+    _enSerie = false;
+    digitalWrite(_cfg.pins.sleepRq, HIGH);
+  }
+
+  /* Como startWake() pero sin tocar el XBee: para ciclos que deciden tras medir si
+   * transmiten (reporte por excepción). Despertar luego con wakeRadio() o awaitRadio(). */
+  void startSensors() {
+    _t0_us = micros();
+    for (uint8_t i = 0; i < PH_COUNT; ++i) _marcas_us[i] = 0;
+    _fasesMarcadas = 0;
+    _enSerie = true;
+    powerSensors(true);
+  }
+
+  /* Espera activa hasta completar settle_us desde startWake() */
+  void awaitSensors() {
+    while (micros() - _t0_us < _cfg.settle_us) { }
+    mark(PH_SETTLED);
+  }
+
+  /* Consulta ON/SLEEP sin bloquear; registra PH_RADIO la primera vez que lo ve en alto */
+  bool radioReady() {
+    if (_fasesMarcadas & (1 << PH_RADIO)) return true;
+    if (digitalRead(_cfg.pins.onSleep) != HIGH) return false;
+    mark(PH_RADIO);
+    return true;
+  }
+
+  /* Sondeo fino (sin power-down de 15 ms) hasta que el XBee esté despierto */
+  bool awaitRadio(uint16_t timeout_ms = 200) {
+    uint32_t t0 = millis();
+    while (!radioReady()) {
+      if (millis() - t0 >= timeout_ms) return false;
+    }
+    return true;
+  }
+
+  void mark(Phase fase) {
+    _marcas_us[fase] = micros() - _t0_us;
+    _fasesMarcadas |= (1 << fase);
+  }
+
+  /* Instante de la fase respecto a startWake() (us), 0 si no se marcó */
+  uint32_t phaseUs(Phase fase) const { return _marcas_us[fase]; }
+
+  /* Tiempo despierto del ciclo: hasta PH_SLEEP si se marcó, si no hasta ahora */
+  uint32_t awakeUs() const {
+    return (_fasesMarcadas & (1 << PH_SLEEP)) ? _marcas_us[PH_SLEEP] : micros() - _t0_us;
+  }
+
+  /* Lo que habría durado el mismo ciclo en serie: esperar radio, luego medir, luego TX */
+  uint32_t sequentialUs() const {
+    if (_enSerie) return awakeUs();                       // startSensors(): ya fue en serie
+    uint32_t radio  = _marcas_us[PH_RADIO];
+    uint32_t medir  = _marcas_us[PH_MEASURED];
+    uint32_t inicio = (radio > medir) ? radio : medir;   // la TX arrancó tras ambas
+    uint32_t resto  = awakeUs() - inicio;                 // TX + dormir el radio
+    return radio + medir + resto;
+  }
+
+  /* Reporte por fase en una línea: fases en us y total paralelo vs serie */
+  void printTiming(Print& out) const {
+    static const char* const nombres[PH_COUNT] = { "est", "med", "rad", "tx", "dor" };
+    out.print(F("[t_us]"));
+    for (uint8_t i = 0; i < PH_COUNT; ++i) {
+      out.print(' '); out.print(nombres[i]); out.print('='); out.print(_marcas_us[i]);
+    }
+    out.print(F(" despierto=")); out.print(awakeUs());
+    out.print(F(" serie=")); out.println(sequentialUs());
+  }
+
+  /** Suspender el programa durante un tiempo específico (ms).
+   *  Devuelve los ms realmente dormidos (múltiplo de 15 ms); en power-down el Timer0
+   *  está detenido, así que ese tiempo no aparece en millis(). **/
+  uint32_t sleepFor_ms(uint32_t ms) {
+    uint32_t dormido = 0;
+    while (ms >= 8000) { LowPower.powerDown(SLEEP_8S,  ADC_OFF, BOD_OFF); ms -= 8000; dormido += 8000; }
+    if    (ms >= 4000) { LowPower.powerDown(SLEEP_4S,  ADC_OFF, BOD_OFF); ms -= 4000; dormido += 4000; }
+    if    (ms >= 2000) { LowPower.powerDown(SLEEP_2S,  ADC_OFF, BOD_OFF); ms -= 2000; dormido += 2000; }
+    if    (ms >= 1000) { LowPower.powerDown(SLEEP_1S,  ADC_OFF, BOD_OFF); ms -= 1000; dormido += 1000; }
+    while (ms >= 500)  { LowPower.powerDown(SLEEP_500MS, ADC_OFF, BOD_OFF); ms -= 500; dormido += 500; }
+    while (ms >= 250)  { LowPower.powerDown(SLEEP_250MS, ADC_OFF, BOD_OFF); ms -= 250; dormido += 250; }
+    while (ms >= 120)  { LowPower.powerDown(SLEEP_120MS, ADC_OFF, BOD_OFF); ms -= 120; dormido += 120; }
+    while (ms >= 60)   { LowPower.powerDown(SLEEP_60MS,  ADC_OFF, BOD_OFF); ms -= 60; dormido += 60; }
+    while (ms >= 30)   { LowPower.powerDown(SLEEP_30MS,  ADC_OFF, BOD_OFF); ms -= 30; dormido += 30; }
+    while (ms >= 15)   { LowPower.powerDown(SLEEP_15MS,  ADC_OFF, BOD_OFF); ms -= 15; dormido += 15; }
+    return dormido;
   }
 
 private:
   Cfg _cfg;
+  uint32_t _t0_us = 0;
+  bool     _enSerie = false;     // el ciclo arrancó con startSensors()
+  uint32_t _marcas_us[PH_COUNT] = {0};
+  uint8_t  _fasesMarcadas = 0;
 
   bool waitLevel(uint8_t pin, uint8_t targetLevel, uint16_t timeout_ms) {
     uint32_t t0 = millis();
@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+/** Cola de capacidad fija para un solo productor y un solo consumidor (SPSC), sin
+  *  mutex ni secciones críticas: cada lado escribe solo su índice y lee el del otro con
+  *  acquire/release, así que productor y consumidor pueden estar en núcleos distintos.
+  *  poner() nunca espera: con la cola llena devuelve false y cuenta el rechazo, para que
+  *  una etapa lenta no frene a la que la alimenta.
+  *  Los índices corren libres (uint32_t) y se enmascaran con N-1: N potencia de 2.
+  *  Profundidad y máxima son para estadísticas; leídas desde un tercer hilo son aproximadas.
+**/
+
+template <typename T, uint16_t N>
+class ColaSPSC {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "ColaSPSC: N debe ser potencia de 2");
+
+public:
+  static const uint16_t CAPACIDAD = N;
+
+  /* Solo el productor */
+  bool poner(const T& v) {
+    const uint32_t c = _cabeza.load(std::memory_order_relaxed);
+    const uint32_t ocupados = c - _cola.load(std::memory_order_acquire);
+    if (ocupados >= N) {
+      _rechazados.store(_rechazados.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    _datos[c & (N - 1)] = v;
+    _cabeza.store(c + 1, std::memory_order_release);
+    if (ocupados + 1 > _maxima.load(std::memory_order_relaxed))
+      _maxima.store((uint16_t)(ocupados + 1), std::memory_order_relaxed);
+    return true;
+  }
+
+  /* Solo el consumidor */
+  bool sacar(T& v) {
+    const uint32_t t = _cola.load(std::memory_order_relaxed);
+    if (_cabeza.load(std::memory_order_acquire) == t) return false;
+    v = _datos[t & (N - 1)];
+    _cola.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool vacia() const {
+    return _cabeza.load(std::memory_order_acquire) == _cola.load(std::memory_order_acquire);
+  }
+
+  uint16_t profundidad() const {
+    return (uint16_t)(_cabeza.load(std::memory_order_acquire) - _cola.load(std::memory_order_acquire));
+  }
+  uint16_t maxima() const     { return _maxima.load(std::memory_order_relaxed); }
+  uint32_t aceptados() const  { return _cabeza.load(std::memory_order_relaxed); }
+  uint32_t rechazados() const { return _rechazados.load(std::memory_order_relaxed); }
+
+private:
+  T                     _datos[N];
+  std::atomic<uint32_t> _cabeza{0};       // lo escribe el productor
+  std::atomic<uint32_t> _cola{0};         // lo escribe el consumidor
+  std::atomic<uint32_t> _rechazados{0};   // productor
+  std::atomic<uint16_t> _maxima{0};       // productor
+};
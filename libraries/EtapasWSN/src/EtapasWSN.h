@@ -0,0 +1,67 @@
+#pragma once
+#include <Arduino.h>
+#include "ColaSPSC.h"
+#include "HistogramaLatencia.h"
+
+/** Etapas de la tubería del coordinador ESP32 (recepción, decodificación, registro,
+  *  control), cada una en su tarea FreeRTOS fijada a un núcleo y unidas por ColaSPSC.
+  *  El productor pone en la cola y despierta al consumidor con una notificación de tarea
+  *  (no bloquea); el consumidor duerme en esperar() hasta la notificación o el plazo.
+  *  Cada etapa registra, por elemento procesado, la latencia desde que el registro se
+  *  recibió (el sello t_us que viaja con él), así el histograma de la etapa de registro
+  *  incluye la espera en colas y lo que tarde la SD.
+  *  Autores: Francisco Rosales, Omar Tox, 2026-10.
+**/
+
+class EtapaWSN {
+public:
+  explicit EtapaWSN(const char* nombre) : _nombre(nombre) {}
+
+  /* Crea la tarea fijada a 'nucleo' (0 o 1); ctx llega como argumento de la función */
+  bool lanzar(TaskFunction_t funcion, void* ctx, BaseType_t nucleo, UBaseType_t prioridad,
+              uint32_t pila = 4096) {
+    return xTaskCreatePinnedToCore(funcion, _nombre, pila, ctx, prioridad, &_tarea, nucleo) == pdPASS;
+  }
+
+  /* Desde el productor, tras poner en la cola de esta etapa */
+  void despertar() { if (_tarea) xTaskNotifyGive(_tarea); }
+
+  /* Desde la propia tarea: true si hubo notificación antes de plazo_ms */
+  bool esperar(uint32_t plazo_ms) { return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(plazo_ms)) > 0; }
+
+  /* Un elemento procesado; recibido_us es el sello micros() de su recepción */
+  void procesado(uint32_t recibido_us) {
+    _latencia.registrar(micros() - recibido_us);
+    _procesados.store(_procesados.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  const char*               nombre() const     { return _nombre; }
+  uint32_t                  procesados() const { return _procesados.load(std::memory_order_relaxed); }
+  const HistogramaLatencia& latencia() const   { return _latencia; }
+
+  /* "decod    n=1234 p50<=63us p99<=255us max=410us pila_libre=2100" */
+  void imprimir(Print& p) const {
+    char linea[96];
+    snprintf(linea, sizeof(linea), "%-8s n=%lu p50<=%luus p99<=%luus max=%luus pila_libre=%u",
+             _nombre, (unsigned long)procesados(), (unsigned long)_latencia.percentil_us(50),
+             (unsigned long)_latencia.percentil_us(99), (unsigned long)_latencia.maximo_us(),
+             _tarea ? (unsigned)uxTaskGetStackHighWaterMark(_tarea) : 0u);
+    p.println(linea);
+  }
+
+private:
+  const char*           _nombre;
+  TaskHandle_t          _tarea = nullptr;
+  HistogramaLatencia    _latencia;
+  std::atomic<uint32_t> _procesados{0};
+};
+
+/* "cola lineas  prof=0/16 max=3 ok=1234 rechazos=0" */
+template <typename T, uint16_t N>
+void imprimirCola(Print& p, const char* nombre, const ColaSPSC<T, N>& cola) {
+  char linea[80];
+  snprintf(linea, sizeof(linea), "cola %-8s prof=%u/%u max=%u ok=%lu rechazos=%lu", nombre,
+           (unsigned)cola.profundidad(), (unsigned)N, (unsigned)cola.maxima(),
+           (unsigned long)cola.aceptados(), (unsigned long)cola.rechazados());
+  p.println(linea);
+}
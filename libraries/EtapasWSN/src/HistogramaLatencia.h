@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+/** Histograma de latencias en µs con cubetas log2: la cubeta k cuenta [2^k, 2^(k+1)) µs
+  *  (la 0 incluye el 0), la última todo lo que pase de ~0.5 s. Registrar es O(1) y sin
+  *  asignación; lo escribe una sola tarea y cualquier otra puede leerlo para reportar.
+**/
+
+class HistogramaLatencia {
+public:
+  static const uint8_t CUBETAS = 20;
+
+  void registrar(uint32_t us) {
+    uint8_t k = 0;
+    while ((us >> (k + 1)) != 0 && k < CUBETAS - 1) ++k;
+    incrementar(_cubetas[k]);
+    incrementar(_muestras);
+    if (us > _maximo.load(std::memory_order_relaxed)) _maximo.store(us, std::memory_order_relaxed);
+  }
+
+  uint32_t muestras() const      { return _muestras.load(std::memory_order_relaxed); }
+  uint32_t maximo_us() const     { return _maximo.load(std::memory_order_relaxed); }
+  uint32_t cubeta(uint8_t k) const { return k < CUBETAS ? _cubetas[k].load(std::memory_order_relaxed) : 0; }
+
+  /* Cota superior (límite de la cubeta) del percentil p, 0..100 */
+  uint32_t percentil_us(uint8_t p) const {
+    const uint32_t total = muestras();
+    if (total == 0) return 0;
+    const uint32_t objetivo = (uint32_t)(((uint64_t)total * p + 99) / 100);
+    uint32_t acumulado = 0;
+    for (uint8_t k = 0; k < CUBETAS; ++k) {
+      acumulado += cubeta(k);
+      if (acumulado >= objetivo) return k == CUBETAS - 1 ? maximo_us() : (2UL << k) - 1;
+    }
+    return maximo_us();
+  }
+
+private:
+  static void incrementar(std::atomic<uint32_t>& c) {
+    c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);   // un solo escritor
+  }
+
+  std::atomic<uint32_t> _cubetas[CUBETAS] = {};
+  std::atomic<uint32_t> _muestras{0};
+  std::atomic<uint32_t> _maximo{0};
+};
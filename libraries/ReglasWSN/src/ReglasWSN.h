@@ -0,0 +1,257 @@
+#pragma once
+#include <Arduino.h>
+
+/** Motor de reglas de control por nodo para el coordinador.
+  *  Las reglas se escriben en texto compacto, una por línea (o separadas por ';'):
+  *
+  *      defecto ON
+  *      *     V<190 h2 t5 OFF       # cualquier nodo: voltaje bajo 5 s seguidos -> OFF
+  *      *     V>250 h2 t5 OFF
+  *      Nodo1 I<0.1 h0.02 t30 OFF   # solo Nodo1
+  *
+  *  nodo variable(<|>)umbral [h histéresis] [t permanencia en s] acción(ON|OFF)
+  *  Una regla se activa cuando la condición se cumple durante 't' segundos y se libera
+  *  cuando deja de cumplirse con margen 'h' (V<190 h2 se libera con V>=192) durante otros
+  *  't' segundos. La salida del nodo es la acción de la primera regla activa, en el orden
+  *  del texto, o la de 'defecto' si ninguna lo está.
+  *
+  *  cargar() compila el texto una sola vez a una tabla plana: umbrales en milésimas
+  *  (int32, sin float), variable como índice y nodos como máscara de bits. evaluar() es
+  *  O(reglas), sin asignación ni comparación de cadenas, y solo devuelve un comando cuando
+  *  la salida del nodo cambia; SIN_CAMBIO el resto de las veces.
+  *  Los nodos son índices 0..MAX_NODOS-1 que asigna el sketch (su tabla de nodos); con
+  *  asignarNodo() se resuelve, una vez por nodo, qué reglas con nombre le aplican.
+  *  Memoria estática: MAX_REGLAS × MAX_NODOS estados de 8 B.
+**/
+
+template <uint8_t MAX_REGLAS = 8, uint8_t MAX_NODOS = 8>
+class ReglasWSN {
+  static_assert(MAX_NODOS <= 32, "ReglasWSN: la máscara de nodos es de 32 bits");
+
+public:
+  static const int8_t  SIN_CAMBIO = -1;
+  static const uint8_t OFF = 0, ON = 1;
+  static const uint8_t LARGO_NOMBRE = 12;
+
+  ReglasWSN() { for (uint8_t k = 0; k < MAX_NODOS; ++k) reiniciarNodo(k); }
+
+  /* Compila 'texto'; 'variables' son los nombres de campo (V, I, ...) en el orden en que
+   * llegan los valores a evaluar(). Devuelve false y deja lineaError() con la línea
+   * (1..n) que no se entendió; en ese caso no queda ninguna regla cargada. */
+  bool cargar(const char* texto, const char* const* variables, uint8_t nVariables) {
+    _n = 0;
+    _defecto = ON;
+    _lineaError = 0;
+    uint16_t linea = 0;
+    while (*texto) {
+      ++linea;
+      const char* fin = texto;
+      while (*fin && *fin != '\n' && *fin != ';') ++fin;
+      if (!compilarLinea(texto, fin, variables, nVariables)) {
+        _lineaError = linea;
+        _n = 0;
+        return false;
+      }
+      texto = *fin ? fin + 1 : fin;
+    }
+    for (uint8_t k = 0; k < MAX_NODOS; ++k) reiniciarNodo(k);
+    return true;
+  }
+
+  /* Asocia el índice 'nodo' con su nombre: llamar cuando el sketch registra un nodo nuevo */
+  void asignarNodo(uint8_t nodo, const char* nombre) {
+    if (nodo >= MAX_NODOS) return;
+    for (uint8_t i = 0; i < _n; ++i) {
+      Regla& r = _reglas[i];
+      const bool aplica = r.nombre[0] == '*' || strcmp(r.nombre, nombre) == 0;
+      if (aplica) r.mascara |= (1UL << nodo);
+      else        r.mascara &= ~(1UL << nodo);
+    }
+    reiniciarNodo(nodo);
+  }
+
+  /* Un registro decodificado: valores[k] en milésimas de la variable k, 'presentes' con
+   * el bit k puesto si el registro traía esa variable (las ausentes no cambian nada).
+   * Devuelve ON/OFF si la salida del nodo cambió (hay que mandar el comando) o SIN_CAMBIO. */
+  int8_t evaluar(uint8_t nodo, const int32_t* valores, uint32_t presentes, uint32_t ahora_ms) {
+    if (nodo >= MAX_NODOS) return SIN_CAMBIO;
+    const uint32_t bit = 1UL << nodo;
+    for (uint8_t i = 0; i < _n; ++i) {
+      const Regla& r = _reglas[i];
+      if (!(r.mascara & bit) || !(presentes & (1UL << r.variable))) continue;
+      Estado& e = _estado[i][nodo];
+      const int32_t v = valores[r.variable];
+      const bool cumple = (r.op == MENOR)
+                              ? (e.activa ? v < r.umbral + r.histeresis : v < r.umbral)
+                              : (e.activa ? v > r.umbral - r.histeresis : v > r.umbral);
+      if (cumple == e.activa) { e.pendiente = false; continue; }
+      if (!e.pendiente) { e.pendiente = true; e.desde_ms = ahora_ms; }
+      if (ahora_ms - e.desde_ms >= r.permanencia_ms) { e.activa = cumple; e.pendiente = false; }
+    }
+    return decidir(nodo);
+  }
+
+  /* Sin registro nuevo: completa las permanencias vencidas. Los nodos reportan por
+   * excepción, así que el silencio significa que la condición sigue igual. */
+  int8_t revisar(uint8_t nodo, uint32_t ahora_ms) {
+    if (nodo >= MAX_NODOS) return SIN_CAMBIO;
+    const uint32_t bit = 1UL << nodo;
+    for (uint8_t i = 0; i < _n; ++i) {
+      Estado& e = _estado[i][nodo];
+      if (!(_reglas[i].mascara & bit) || !e.pendiente) continue;
+      if (ahora_ms - e.desde_ms >= _reglas[i].permanencia_ms) { e.activa = !e.activa; e.pendiente = false; }
+    }
+    return decidir(nodo);
+  }
+
+  /* Olvida la última salida enviada (p. ej. el nodo se reinició): la próxima evaluación
+   * vuelve a mandar el comando aunque no haya cambiado */
+  void olvidarSalida(uint8_t nodo) { if (nodo < MAX_NODOS) _salida[nodo] = DESCONOCIDA; }
+
+  int8_t   salida(uint8_t nodo) const { return nodo < MAX_NODOS && _salida[nodo] != DESCONOCIDA ? (int8_t)_salida[nodo] : SIN_CAMBIO; }
+  uint8_t  reglas() const     { return _n; }
+  uint16_t lineaError() const { return _lineaError; }
+
+  /* Número decimal ("-12.5", "0.02") a milésimas, sin float; false si no hay número */
+  static bool milesimas(const char*& p, const char* fin, int32_t& salida) {
+    bool negativo = false;
+    if (p < fin && (*p == '-' || *p == '+')) negativo = (*p++ == '-');
+    int32_t entero = 0, fraccion = 0;
+    uint8_t digitos = 0, decimales = 0;
+    while (p < fin && *p >= '0' && *p <= '9') { entero = entero * 10 + (*p++ - '0'); ++digitos; }
+    if (p < fin && *p == '.') {
+      ++p;
+      while (p < fin && *p >= '0' && *p <= '9') {
+        if (decimales < 3) { fraccion = fraccion * 10 + (*p - '0'); ++decimales; }
+        ++p; ++digitos;
+      }
+    }
+    if (digitos == 0) return false;
+    while (decimales < 3) { fraccion *= 10; ++decimales; }
+    salida = entero * 1000 + fraccion;
+    if (negativo) salida = -salida;
+    return true;
+  }
+
+private:
+  static const uint8_t MENOR = 0, MAYOR = 1;
+  static const uint8_t DESCONOCIDA = 0xFF;
+
+  struct Regla {
+    int32_t  umbral;            // milésimas
+    int32_t  histeresis;        // milésimas
+    uint32_t permanencia_ms;
+    uint32_t mascara;           // bit k: la regla aplica al nodo k
+    uint8_t  variable, op, accion;
+    char     nombre[LARGO_NOMBRE];   // "*" o nombre del nodo; solo lo usa asignarNodo()
+  };
+  struct Estado {
+    uint32_t desde_ms;          // desde cuándo la condición pide cambiar
+    bool     activa, pendiente;
+  };
+
+  static void saltarEspacios(const char*& p, const char* fin) {
+    while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+  }
+
+  static bool palabra(const char*& p, const char* fin, const char*& ini, uint8_t& largo) {
+    saltarEspacios(p, fin);
+    ini = p;
+    while (p < fin && *p != ' ' && *p != '\t' && *p != '\r' && *p != '#') ++p;
+    largo = (uint8_t)(p - ini);
+    return largo > 0;
+  }
+
+  static bool igual(const char* a, uint8_t largo, const char* b) {
+    return strlen(b) == largo && strncmp(a, b, largo) == 0;
+  }
+
+  bool compilarLinea(const char* p, const char* fin, const char* const* variables, uint8_t nVariables) {
+    const char* c = p;                                 // el comentario corta la línea
+    while (c < fin && *c != '#') ++c;
+    fin = c;
+    const char* w;
+    uint8_t largo;
+    if (!palabra(p, fin, w, largo)) return true;       // vacía o solo comentario
+
+    if (igual(w, largo, "defecto")) {
+      if (!palabra(p, fin, w, largo)) return false;
+      if      (igual(w, largo, "ON"))  _defecto = ON;
+      else if (igual(w, largo, "OFF")) _defecto = OFF;
+      else return false;
+      saltarEspacios(p, fin);
+      return p == fin;
+    }
+
+    if (_n >= MAX_REGLAS || largo >= LARGO_NOMBRE) return false;
+    Regla& r = _reglas[_n];
+    memcpy(r.nombre, w, largo);
+    r.nombre[largo] = '\0';
+    r.mascara = r.nombre[0] == '*' ? 0xFFFFFFFFUL : 0;
+    r.histeresis = 0;
+    r.permanencia_ms = 0;
+
+    // Condición: variable, '<' o '>', umbral (con o sin espacios entre medio)
+    saltarEspacios(p, fin);
+    const char* v = p;
+    while (p < fin && *p != '<' && *p != '>' && *p != ' ') ++p;
+    uint8_t k = 0;
+    while (k < nVariables && !igual(v, (uint8_t)(p - v), variables[k])) ++k;
+    if (k == nVariables || k >= 32) return false;
+    r.variable = k;
+    saltarEspacios(p, fin);
+    if (p == fin || (*p != '<' && *p != '>')) return false;
+    r.op = (*p++ == '<') ? MENOR : MAYOR;
+    saltarEspacios(p, fin);
+    if (!milesimas(p, fin, r.umbral)) return false;
+
+    // Opcionales y acción
+    bool conAccion = false;
+    while (palabra(p, fin, w, largo)) {
+      if (conAccion) return false;
+      const char* q = w + 1;
+      int32_t x;
+      if (w[0] == 'h' && milesimas(q, w + largo, x) && q == w + largo && x >= 0) {
+        r.histeresis = x;
+      } else if (w[0] == 't' && milesimas(q, w + largo, x) && q == w + largo && x >= 0) {
+        r.permanencia_ms = (uint32_t)x;                // segundos en milésimas = ms
+      } else if (igual(w, largo, "ON")) {
+        r.accion = ON;  conAccion = true;
+      } else if (igual(w, largo, "OFF")) {
+        r.accion = OFF; conAccion = true;
+      } else {
+        return false;
+      }
+    }
+    if (!conAccion) return false;
+    ++_n;
+    return true;
+  }
+
+  void reiniciarNodo(uint8_t nodo) {
+    for (uint8_t i = 0; i < MAX_REGLAS; ++i) {
+      _estado[i][nodo].activa    = false;
+      _estado[i][nodo].pendiente = false;
+      _estado[i][nodo].desde_ms  = 0;
+    }
+    _salida[nodo] = DESCONOCIDA;
+  }
+
+  int8_t decidir(uint8_t nodo) {
+    const uint32_t bit = 1UL << nodo;
+    uint8_t s = _defecto;
+    for (uint8_t i = 0; i < _n; ++i) {
+      if ((_reglas[i].mascara & bit) && _estado[i][nodo].activa) { s = _reglas[i].accion; break; }
+    }
+    if (s == _salida[nodo]) return SIN_CAMBIO;
+    _salida[nodo] = s;
+    return (int8_t)s;
+  }
+
+  Regla    _reglas[MAX_REGLAS];
+  Estado   _estado[MAX_REGLAS][MAX_NODOS];
+  uint8_t  _salida[MAX_NODOS];
+  uint8_t  _n = 0;
+  uint8_t  _defecto = ON;
+  uint16_t _lineaError = 0;
+};
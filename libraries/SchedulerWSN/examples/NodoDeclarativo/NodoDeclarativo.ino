@@ -0,0 +1,106 @@
+/*
+ * Nodo sensor como lista declarativa de tareas.
+ *  - medir y enviar: período dictado por AdaptiveTXWSN según la batería
+ *  - ventana de escucha: 50 ms despierto tras cada envío para recibir "ON"/"OFF"
+ *  - latido de consola: cada 60 s
+ * Entre plazos el micro duerme con EnergyWSN (power-down + XBee pin-sleep).
+ */
+#include <SoftwareSerial.h>
+#include <LowPower.h>
+#include "EnergyWSN.h"
+#include "AdaptiveTXWSN.h"
+#include "SchedulerWSN.h"
+
+SoftwareSerial xbeeSerial(2, 3);   // D2=RX, D3=TX
+
+#define RELAY_PIN 4
+#define ACS_PIN   A0
+#define ZMPT_PIN  A1
+#define VBAT_PIN  A2
+
+const uint8_t  PIN_SLEEP_RQ   = 8;
+const uint8_t  PIN_ON_SLEEP   = 9;
+const uint8_t  PIN_PWR_SENS   = 7;
+const uint32_t VENTANA_RX_MS  = 50;
+const uint32_t LATIDO_MS      = 60000;
+
+EnergyWSN      energy;
+AdaptiveTXWSN  txManager;
+SchedulerWSN<4> sched;
+
+int8_t   tareaEnvio   = SchedulerWSN<4>::SIN_TAREA;
+int8_t   tareaCierre  = SchedulerWSN<4>::SIN_TAREA;
+uint32_t paquetesEnviados = 0;
+
+void setup() {
+  pinMode(RELAY_PIN, OUTPUT);
+  digitalWrite(RELAY_PIN, LOW);
+  Serial.begin(9600);
+  xbeeSerial.begin(9600);
+
+  EnergyWSN::Cfg cfg;
+  cfg.pins = { PIN_SLEEP_RQ, PIN_ON_SLEEP, PIN_PWR_SENS, -1 };
+  cfg.invertPwr = true;
+  cfg.bootSleep = true;
+  energy.begin(cfg);
+
+  AdaptiveTXWSN::Cfg cfgTx;
+  cfgTx.pinAdcBateria   = VBAT_PIN;
+  cfgTx.divisorRArriba_k = 20.0f;
+  cfgTx.divisorRAbajo_k  = 10.0f;
+  txManager.begin(cfgTx);
+
+  // --- Lista de tareas ---
+  sched.begin(dormirNodo);
+  tareaEnvio  = sched.every(txManager.currentPeriod(), medirYEnviar);
+  tareaCierre = sched.after(0, cerrarEscucha);   // queda reservada; se rearma tras cada envío
+  sched.cancel(tareaCierre);
+  sched.every(LATIDO_MS, latido, nullptr, LATIDO_MS);
+}
+
+void loop() {
+  // Mientras la ventana de escucha está abierta el planificador no duerme
+  if (sched.isActive(tareaCierre) && xbeeSerial.available()) {
+    String comando = xbeeSerial.readStringUntil('\n');
+    comando.trim();
+    if (comando == "ON")  digitalWrite(RELAY_PIN, HIGH);
+    if (comando == "OFF") digitalWrite(RELAY_PIN, LOW);
+  }
+  sched.run();
+}
+
+uint32_t dormirNodo(uint32_t ms) {
+  Serial.flush();
+  return energy.sleepFor_ms(ms);
+}
+
+void medirYEnviar(void*) {
+  if (!txManager.update()) return;                       // batería en corte: no transmitir
+  sched.setPeriod(tareaEnvio, txManager.currentPeriod()); // el nivel pudo cambiar
+
+  energy.powerSensors(true);
+  energy.wakeRadio();
+  float voltage   = ((analogRead(ZMPT_PIN) * 5.0f) / 1023.0f) * 50.0f;
+  float corriente = (((analogRead(ACS_PIN) * 5.0f) / 1023.0f) - 2.5f) / 0.066f;
+  energy.powerSensors(false);
+
+  paquetesEnviados++;
+  xbeeSerial.print(F("N:")); xbeeSerial.print(paquetesEnviados);
+  xbeeSerial.print(F(" V:")); xbeeSerial.print(voltage, 2);
+  xbeeSerial.print(F(" I:")); xbeeSerial.print(corriente, 2);
+  xbeeSerial.print(F(" B:")); xbeeSerial.println(txManager.lastVolts(), 2);
+
+  // Abrir la ventana de escucha: el radio sigue despierto hasta cerrarEscucha()
+  sched.holdAwake(true);
+  sched.reschedule(tareaCierre, VENTANA_RX_MS);
+}
+
+void cerrarEscucha(void*) {
+  energy.sleepRadio();
+  sched.holdAwake(false);
+}
+
+void latido(void*) {
+  Serial.print(F("Dormido total (ms): "));
+  Serial.println(sched.sleptMs());
+}
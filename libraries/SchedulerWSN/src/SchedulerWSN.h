@@ -0,0 +1,159 @@
+#pragma once
+#include <Arduino.h>
+
+/** Planificador cooperativo sin tick para los nodos de la red de sensores.
+  *  Cada tarea se registra con un período o con un plazo único (medir, enviar,
+  *  ventana de escucha, flush del log). En cada llamada a run() se ejecutan las
+  *  tareas vencidas y el micro se duerme hasta el siguiente plazo usando la función
+  *  de sueño indicada (normalmente EnergyWSN::sleepFor_ms).
+  *  En power-down el Timer0 se detiene y millis() no avanza, por eso el planificador
+  *  lleva un reloj propio: now() = millis() + tiempo dormido.
+  *  Memoria estática: la capacidad se fija con el parámetro de plantilla.
+  *  Autores: Francisco Rosales, Omar Tox, 2025-09.
+**/
+
+template <uint8_t MAX_TAREAS = 8>
+class SchedulerWSN {
+public:
+  /* Acción de una tarea; ctx es el puntero que se dio al registrarla */
+  typedef void (*Accion)(void* ctx);
+  /* Duerme como máximo 'ms' y devuelve el tiempo que millis() NO vio pasar */
+  typedef uint32_t (*Dormir)(uint32_t ms);
+
+  static const int8_t SIN_TAREA = -1;
+
+  /* dormir = nullptr deja al micro despierto (p. ej. coordinador ESP32) */
+  void begin(Dormir dormir = nullptr, uint16_t minimoDormir_ms = 15) {
+    _dormir          = dormir;
+    _minimoDormir_ms = minimoDormir_ms;
+    _msDormido       = 0;
+    _despiertos      = 0;
+    for (uint8_t i = 0; i < MAX_TAREAS; ++i) { _tareas[i].usada = false; _tareas[i].activa = false; }
+  }
+
+  /* Reloj del planificador (ms), incluye el tiempo dormido */
+  uint32_t now() const { return millis() + _msDormido; }
+
+  /* Registra una tarea periódica; desfase_ms retrasa la primera ejecución */
+  int8_t every(uint32_t periodo_ms, Accion accion, void* ctx = nullptr, uint32_t desfase_ms = 0) {
+    return agregar(periodo_ms, desfase_ms, accion, ctx);
+  }
+
+  /* Registra una tarea que se ejecuta una sola vez dentro de retardo_ms */
+  int8_t after(uint32_t retardo_ms, Accion accion, void* ctx = nullptr) {
+    return agregar(0, retardo_ms, accion, ctx);
+  }
+
+  /* Mueve el próximo plazo de una tarea (también reactiva una tarea de plazo único) */
+  void reschedule(int8_t id, uint32_t retardo_ms) {
+    if (!valida(id) || !_tareas[id].usada) return;
+    _tareas[id].proximo_ms = now() + retardo_ms;
+    _tareas[id].activa     = true;
+  }
+
+  /* Cambia el período; se aplica a partir del siguiente disparo */
+  void setPeriod(int8_t id, uint32_t periodo_ms) {
+    if (valida(id)) _tareas[id].periodo_ms = periodo_ms;
+  }
+
+  /* Desactiva la tarea; el id sigue reservado y puede reactivarse con reschedule() */
+  void cancel(int8_t id) {
+    if (valida(id)) _tareas[id].activa = false;
+  }
+
+  /* Libera el id para que otra tarea pueda ocuparlo */
+  void remove(int8_t id) {
+    if (valida(id)) { _tareas[id].activa = false; _tareas[id].usada = false; }
+  }
+
+  bool isActive(int8_t id) const {
+    return valida(id) && _tareas[id].activa;
+  }
+
+  /* Impide dormir mientras haya una ventana abierta (p. ej. escucha del radio).
+   * Es un contador: cada holdAwake(true) necesita su holdAwake(false). */
+  void holdAwake(bool mantener) {
+    if (mantener) { if (_despiertos < 255) ++_despiertos; }
+    else if (_despiertos > 0) --_despiertos;
+  }
+
+  /* ms hasta el plazo más cercano (0 si ya hay una vencida, UINT32_MAX si no hay tareas) */
+  uint32_t msUntilNext() const {
+    uint32_t t = now();
+    uint32_t minimo = UINT32_MAX;
+    for (uint8_t i = 0; i < MAX_TAREAS; ++i) {
+      if (!_tareas[i].activa) continue;
+      int32_t resta = (int32_t)(_tareas[i].proximo_ms - t);
+      if (resta <= 0) return 0;
+      if ((uint32_t)resta < minimo) minimo = (uint32_t)resta;
+    }
+    return minimo;
+  }
+
+  /* Ejecuta lo vencido y duerme hasta el siguiente plazo. Llamar en cada loop(). */
+  void run() {
+    runDue();
+    if (_dormir == nullptr || _despiertos > 0) return;
+
+    uint32_t espera = msUntilNext();
+    if (espera == UINT32_MAX || espera < _minimoDormir_ms) return;
+    _msDormido += _dormir(espera);
+  }
+
+  /* Ejecuta solo las tareas vencidas, sin dormir. Devuelve cuántas corrió. */
+  uint8_t runDue() {
+    uint8_t ejecutadas = 0;
+    for (uint8_t i = 0; i < MAX_TAREAS; ++i) {
+      Tarea& t = _tareas[i];
+      if (!t.activa) continue;
+      uint32_t ahora = now();
+      if ((int32_t)(ahora - t.proximo_ms) < 0) continue;
+
+      if (t.periodo_ms == 0) {
+        t.activa = false;                  // plazo único: se consume antes de ejecutar
+      } else {
+        t.proximo_ms += t.periodo_ms;      // mantiene la fase sin acumular deriva
+        if ((int32_t)(ahora - t.proximo_ms) >= 0) t.proximo_ms = ahora + t.periodo_ms; // se atrasó más de un período
+      }
+      t.accion(t.ctx);
+      ++ejecutadas;
+    }
+    return ejecutadas;
+  }
+
+  /* Tiempo total dormido desde begin() (ms) */
+  uint32_t sleptMs() const { return _msDormido; }
+
+private:
+  struct Tarea {
+    Accion   accion;
+    void*    ctx;
+    uint32_t periodo_ms;   // 0 = plazo único
+    uint32_t proximo_ms;   // siguiente disparo en la base de now()
+    bool     usada;        // id reservado
+    bool     activa;       // pendiente de ejecutar
+  };
+
+  Tarea    _tareas[MAX_TAREAS];
+  Dormir   _dormir          = nullptr;
+  uint16_t _minimoDormir_ms = 15;
+  uint32_t _msDormido       = 0;
+  uint8_t  _despiertos      = 0;
+
+  bool valida(int8_t id) const { return id >= 0 && id < (int8_t)MAX_TAREAS; }
+
+  int8_t agregar(uint32_t periodo_ms, uint32_t retardo_ms, Accion accion, void* ctx) {
+    if (accion == nullptr) return SIN_TAREA;
+    for (uint8_t i = 0; i < MAX_TAREAS; ++i) {
+      if (_tareas[i].usada) continue;
+      _tareas[i].usada      = true;
+      _tareas[i].accion     = accion;
+      _tareas[i].ctx        = ctx;
+      _tareas[i].periodo_ms = periodo_ms;
+      _tareas[i].proximo_ms = now() + retardo_ms;
+      _tareas[i].activa     = true;
+      return (int8_t)i;
+    }
+    return SIN_TAREA;
+  }
+};
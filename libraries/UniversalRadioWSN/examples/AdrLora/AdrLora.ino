@@ -0,0 +1,121 @@
+/*
+ * ADR (adaptive data rate) entre nodos LoRa y un coordinador SX1276.
+ *
+ *  - NODO (Nano): cada 3 s manda la línea de siempre con la cabecera ADR de 4 bytes
+ *    y escucha 300 ms la respuesta; el coordinador le baja la potencia mientras sobre
+ *    margen de SNR. Si deja de oír ACKs, vuelve solo a 20 dBm.
+ *  - COORDINADOR (ESP32): registra el SNR de cada subida y contesta un ACK de 2 bytes,
+ *    o de 3 con el perfil nuevo cuando la ventana de 20 paquetes lo pide.
+ *
+ * El coordinador es un SX127x y solo oye su SF, así que sfMin = sfMax = SF del enlace.
+ */
+#include <SPI.h>
+#include <UniversalRadioWSN.h>
+
+//#define ROL_COORDINADOR   // descomentar para compilar el coordinador
+
+const uint8_t NODO_ID = 1;
+
+#if defined(ROL_COORDINADOR)
+const LoRaConfig configLora = {
+  410000000L, // frequency
+  20,         // txPower
+  7,          // spreadingFactor
+  125000L,    // signalBandwidth
+  5,          // codingRate
+  0xF3,       // syncWord
+  5,          // csPin
+  -1,         // resetPin
+  2           // irqPin
+};
+#else
+const LoRaConfig configLora = {
+  410000000L, // frequency
+  20,         // txPower (arranca en el perfil seguro)
+  7,          // spreadingFactor
+  125000L,    // signalBandwidth
+  5,          // codingRate
+  0xF3,       // syncWord
+  10,         // csPin
+  -1,         // resetPin
+  2           // irqPin
+};
+#endif
+UniversalRadio<LoraRadio> radio(configLora);
+
+#if defined(ROL_COORDINADOR)
+// =============================== COORDINADOR ===============================
+AdrCoordinador<16, 20> adr;
+
+void setup() {
+  Serial.begin(115200);
+  SPI.begin();
+  if (!radio.iniciar()) { Serial.println(F("Fallo al iniciar LoRa")); while (true); }
+
+  AdrCoordinador<16, 20>::Cfg cfg;
+  cfg.sfMin = cfg.sfMax = configLora.spreadingFactor;
+  adr.begin(cfg);
+  Serial.println(F("Coordinador ADR listo"));
+}
+
+void loop() {
+  uint8_t datos[64];
+  BufferRx rx(datos);
+  size_t n = radio.recibirEn(rx);
+  if (n == 0) return;
+
+  int16_t id = adr.registrar(datos, n, rx.meta.snr_cuartos_dB);
+  if (id < 0) return;
+
+  uint8_t bajada[ADR_MAX_BAJADA];
+  radio.enviar(bajada, adr.respuesta((uint8_t)id, bajada));
+
+  const AdrCoordinador<16, 20>::Nodo* nodo = adr.nodo((uint8_t)id);
+  Serial.print(F("Nodo "));   Serial.print(id);
+  Serial.print(F(" SNR "));   Serial.print(rx.meta.snr_cuartos_dB / 4.0f, 2);
+  Serial.print(F(" SF"));     Serial.print(nodo->actual.sf);
+  Serial.print(F(" "));       Serial.print(nodo->actual.potencia_dBm);
+  Serial.print(F(" dBm -> ")); Serial.print(nodo->objetivo.potencia_dBm);
+  Serial.print(F(" dBm, entrega ")); Serial.print(nodo->entrega * 100 / 255);
+  Serial.print(F(" %: "));
+  Serial.write(datos + ADR_CABECERA, n - ADR_CABECERA);
+  Serial.println();
+}
+
+#else
+// ================================== NODO ===================================
+AdrNodo adr(radio);
+uint32_t paquetesEnviados = 0;
+
+void setup() {
+  Serial.begin(9600);
+  if (!radio.iniciar()) { Serial.println(F("Fallo al iniciar LoRa")); while (true); }
+
+  AdrNodo::Cfg cfg;
+  cfg.nodo = NODO_ID;
+  adr.begin(cfg);
+}
+
+void loop() {
+  char linea[32];
+  int n = snprintf(linea, sizeof(linea), "N:%lu\n", (unsigned long)++paquetesEnviados);
+  adr.enviar(reinterpret_cast<const uint8_t*>(linea), n);
+
+  // Ventana de recepción corta después de cada subida
+  uint8_t bajada[8];
+  BufferRx rx(bajada);
+  uint32_t inicio = millis();
+  while (millis() - inicio < 300) {
+    if (radio.recibirEn(rx) && adr.procesar(bajada, rx.longitud)) break;
+  }
+
+  Serial.print(F("Paquete ")); Serial.print(paquetesEnviados);
+  Serial.print(F(": SF"));     Serial.print(adr.perfil().sf);
+  Serial.print(F(", "));       Serial.print(adr.perfil().potencia_dBm);
+  Serial.print(F(" dBm, sin ACK ")); Serial.print(adr.sinAck());
+  Serial.print(F(", caídas al perfil seguro ")); Serial.println(adr.caidas());
+
+  radio.dormir();
+  delay(3000);
+}
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Nodo LoRa en EU868 (sub-banda g1: 1 % de ciclo de trabajo por hora).
+ *
+ * El tiempo en aire se calcula en compilación con la misma configuración del radio:
+ * si alguien sube el SF y el paquete deja de caber, el sketch no compila.
+ * Las lecturas se toman cada 5 s, más rápido de lo que el 1 % permite a SF10; con
+ * CICLO_FUSIONAR las que no alcanzan se juntan en un solo paquete que atender()
+ * manda en cuanto hay fichas, y proximoEnvio_ms() dice cuánto falta.
+ * Si el nodo duerme en power-down, pasar a setCicloTrabajo() un reloj que cuente lo
+ * dormido (p. ej. sched.now() de SchedulerWSN): con millis() la cubeta no se rellena.
+ */
+#include <SPI.h>
+#include <UniversalRadioWSN.h>
+
+constexpr LoRaConfig configLora = {
+  868100000L, // frequency
+  14,         // txPower (EU868: 14 dBm ERP)
+  10,         // spreadingFactor
+  125000L,    // signalBandwidth
+  5,          // codingRate
+  0x34,       // syncWord
+  10,         // csPin
+  -1,         // resetPin
+  2           // irqPin
+};
+UniversalRadio<LoraRadio> radio(configLora);
+
+const uint8_t  TAM_LECTURA = 6;
+const uint32_t PPM_EU868   = 10000;   // 1 %
+const uint32_t VENTANA_S   = 3600;
+
+static_assert(loraTiempoEnAire_us(configLora, TAM_LECTURA) * 1000000ULL / PPM_EU868 < VENTANA_S * 1000000ULL,
+              "una lectura no cabe en el ciclo de trabajo de la ventana");
+
+uint32_t ultimaLectura = 0;
+uint16_t secuencia = 0;
+
+void setup() {
+  Serial.begin(9600);
+  if (!radio.iniciar()) {
+    Serial.println(F("Fallo al iniciar LoRa"));
+    while (true);
+  }
+  radio.setCicloTrabajo(PPM_EU868, VENTANA_S, CICLO_FUSIONAR);
+  Serial.print(F("Tiempo en aire por lectura: "));
+  Serial.print(radio.tiempoEnAire_us(TAM_LECTURA));
+  Serial.println(F(" us"));
+}
+
+void loop() {
+  radio.atender();
+
+  if (millis() - ultimaLectura < 5000) return;
+  ultimaLectura = millis();
+
+  uint16_t valor = analogRead(A0);
+  uint8_t lectura[TAM_LECTURA] = {
+    'S', (uint8_t)(secuencia >> 8), (uint8_t)secuencia,
+    (uint8_t)(valor >> 8), (uint8_t)valor, 0
+  };
+  ++secuencia;
+
+  uint32_t espera = radio.proximoEnvio_ms(TAM_LECTURA);
+  if (!radio.enviar(lectura, sizeof(lectura))) {
+    Serial.println(F("Lectura descartada: no cabe en el buffer diferido"));
+  } else if (espera > 0) {
+    Serial.print(F("Diferida ("));
+    Serial.print(radio.diferidos());
+    Serial.print(F(" B pendientes), siguiente envío en "));
+    Serial.print(espera);
+    Serial.println(F(" ms"));
+  }
+}
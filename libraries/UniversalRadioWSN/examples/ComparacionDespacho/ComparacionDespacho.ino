@@ -0,0 +1,80 @@
+/*
+ * Comparación de flash/RAM: despacho virtual vs. despacho estático.
+ *
+ * El mismo emisor LoRa compilado de dos formas:
+ *   - DESPACHO_VIRTUAL definido:  RadioInterface* radio = new LoraRadio(cfg)
+ *                                 (malloc/free, vtable en RAM, llamada indirecta)
+ *   - DESPACHO_VIRTUAL comentado: UniversalRadio<LoraRadio> radio(cfg)
+ *                                 (objeto global, llamadas directas e inlineables)
+ *
+ * Cómo medir: compilar para "Arduino Nano" (ATmega328P) en cada modo y anotar las
+ * dos líneas que imprime el IDE / arduino-cli al terminar:
+ *   "El Sketch usa N bytes (...) del espacio de almacenamiento de programa"
+ *   "Las variables Globales usan M bytes (...) de la memoria dinámica"
+ * En modo virtual, M no incluye el objeto creado con new ni la sobrecarga del heap;
+ * freeRam() al arrancar muestra la RAM libre real en ambos modos.
+ */
+#include <SPI.h>
+#include <UniversalRadioWSN.h>
+
+//#define DESPACHO_VIRTUAL
+
+const LoRaConfig configLora = {
+  410000000L, // frequency
+  20,         // txPower
+  7,          // spreadingFactor
+  125000L,    // signalBandwidth
+  5,          // codingRate
+  0xF3,       // syncWord
+  10,         // csPin
+  -1,         // resetPin
+  2           // irqPin
+};
+
+#if defined(DESPACHO_VIRTUAL)
+  RadioInterface* radio;
+  #define RADIO (*radio)
+#else
+  UniversalRadio<LoraRadio> radio(configLora);
+  #define RADIO radio
+#endif
+
+uint32_t paquetesEnviados = 0;
+
+int freeRam() {
+  extern int __heap_start, *__brkval;
+  int v;
+  return (int)&v - (__brkval == 0 ? (int)&__heap_start : (int)__brkval);
+}
+
+void setup() {
+  Serial.begin(9600);
+#if defined(DESPACHO_VIRTUAL)
+  radio = new LoraRadio(configLora);
+  Serial.println(F("Despacho: virtual"));
+#else
+  Serial.println(F("Despacho: estatico"));
+#endif
+  if (!RADIO.iniciar()) {
+    Serial.println(F("Fallo al iniciar LoRa"));
+    while (true);
+  }
+  Serial.print(F("RAM libre: "));
+  Serial.println(freeRam());
+}
+
+void loop() {
+  uint8_t payload[8] = { 0 };
+  paquetesEnviados++;
+  payload[0] = uint8_t(paquetesEnviados >> 8);
+  payload[1] = uint8_t(paquetesEnviados);
+  RADIO.enviar(payload, sizeof(payload));
+
+  if (RADIO.hayDatosDisponibles()) {
+    uint8_t rx[32];
+    size_t n = RADIO.leer(rx, sizeof(rx));
+    Serial.print(F("RX ")); Serial.print(n);
+    Serial.print(F(" bytes, RSSI ")); Serial.println(RADIO.obtenerRSSI());
+  }
+  delay(3000);
+}
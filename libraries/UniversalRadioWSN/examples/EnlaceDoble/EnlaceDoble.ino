@@ -0,0 +1,96 @@
+/*
+ * Nodo con LoRa y XBee a la vez (BondedRadio).
+ *
+ *  - Cada lectura sale por el enlace sano más barato por byte entregado; si falla,
+ *    por el otro. LoRa y XBee AT no confirman la entrega, así que el coordinador
+ *    responde "ACK" a cada lectura y el sketch le pasa el resultado a la BondedRadio
+ *    con notificarResultado(): sin ACK antes de la siguiente lectura cuenta como
+ *    pérdida, y tras seis seguidas el enlace queda enfermo y el tráfico pasa al otro.
+ *  - Las alarmas (relé disparado) salen por los dos enlaces con enviarCritico();
+ *    el coordinador, con su propia BondedRadio, se queda con una sola copia.
+ *  - Cada 30 s imprime el puntaje de cada enlace.
+ *
+ * Los costos son estimaciones del sketch (µJ por byte a la potencia configurada);
+ * medirlos en el propio hardware con la corriente del módulo y el tiempo en aire.
+ */
+#include <SPI.h>
+#include <SoftwareSerial.h>
+#include <UniversalRadioWSN.h>
+
+SoftwareSerial xbeeSerial(2, 3);
+
+const LoRaConfig configLora = {
+  410000000L, // frequency
+  20,         // txPower
+  7,          // spreadingFactor
+  125000L,    // signalBandwidth
+  5,          // codingRate
+  0xF3,       // syncWord
+  10,         // csPin
+  -1,         // resetPin
+  8           // irqPin (D2/D3 los usa el XBee)
+};
+
+LoraRadio  lora(configLora);
+XBeeRadio  xbee(xbeeSerial, 9600, -1, -1);
+BondedRadio<2> radio;
+
+const uint8_t ENLACE_NINGUNO = BondedRadio<2>::SIN_ENLACE;
+uint8_t enlaceLora = ENLACE_NINGUNO, enlaceXbee = ENLACE_NINGUNO;
+
+uint32_t paquetesEnviados = 0;
+unsigned long ultimoEnvio = 0, ultimoReporte = 0;
+uint8_t enlaceSinAck = ENLACE_NINGUNO;   // enlace de la última lectura, hasta que llegue su ACK
+
+void setup() {
+  Serial.begin(9600);
+  xbeeSerial.begin(9600);
+
+  BondedRadio<2>::Cfg cfg;
+  cfg.nodo = 7;
+  radio.configurar(cfg);
+  enlaceLora = radio.agregarEnlace(&lora, 40);   // SF7 a 20 dBm: ~120 mA · 1.6 ms/byte
+  enlaceXbee = radio.agregarEnlace(&xbee, 25);   // Serie 1: ~45 mA a 250 kbps + UART a 9600
+
+  if (!radio.iniciar()) { Serial.println(F("Ningún radio respondió")); while (true); }
+}
+
+void loop() {
+  unsigned long ahora = millis();
+
+  if (ahora - ultimoEnvio >= 3000) {
+    ultimoEnvio = ahora;
+    if (enlaceSinAck != ENLACE_NINGUNO) radio.notificarResultado(enlaceSinAck, false);
+    char linea[24];
+    int n = snprintf(linea, sizeof(linea), "N:%lu\n", (unsigned long)++paquetesEnviados);
+    bool ok = radio.enviar(reinterpret_cast<const uint8_t*>(linea), n);
+    enlaceSinAck = ok ? radio.ultimoEnlaceTx() : ENLACE_NINGUNO;
+    Serial.print(F("Enviado por "));
+    Serial.print(radio.ultimoEnlaceTx() == enlaceLora ? F("LoRa") : F("XBee"));
+    Serial.println(ok ? F("") : F(" (sin confirmar)"));
+  }
+
+  if (ahora - ultimoReporte >= 30000) {
+    ultimoReporte = ahora;
+    for (uint8_t k = 0; k < radio.enlaces(); ++k) {
+      const BondedRadio<2>::Enlace& e = radio.enlace(k);
+      Serial.print(k == enlaceLora ? F("LoRa") : F("XBee"));
+      Serial.print(F(": entrega "));   Serial.print(e.entrega * 100 / 255);
+      Serial.print(F("%  RSSI "));     Serial.print(e.rssi_dBm);
+      Serial.print(F("  costo "));     Serial.print(radio.costoEsperado(k, 16));
+      Serial.println(radio.sano(k) ? F(" uJ  sano") : F(" uJ  ENFERMO"));
+    }
+  }
+
+  uint8_t comando[16];
+  BufferRx rx(comando);
+  size_t n = radio.recibirEn(rx);
+  while (n > 0 && (comando[n - 1] == '\n' || comando[n - 1] == '\r')) n--;
+  if (n == 3 && memcmp(comando, "ACK", 3) == 0 && enlaceSinAck != ENLACE_NINGUNO) {
+    radio.notificarResultado(enlaceSinAck, true);
+    enlaceSinAck = ENLACE_NINGUNO;
+  } else if (n == 5 && memcmp(comando, "ALARM", 5) == 0) {
+    static const uint8_t ALARMA[] = { 'A', 'L', 'A', 'R', 'M', 'A', '\n' };
+    radio.enviarCritico(ALARMA, sizeof(ALARMA));   // llega una vez aunque viaje por los dos
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ * Entrega confiable con RadioHead (RHReliableDatagram) sobre un RFM95/SX1276.
+ *
+ *  - NODO (Nano, dirección 1): envía la misma línea de siempre al coordinador (0);
+ *    enviar() ya espera el ACK y reintenta, y se imprimen los reintentos usados.
+ *  - COORDINADOR (dirección 0): recibe de varios nodos; RadioHead confirma cada paquete
+ *    y descarta los duplicados que llegan cuando un ACK se pierde.
+ *
+ * Cambiar RH_RF95 por RH_NRF24(ce, csn) o RH_Serial(Serial1) no toca el resto del sketch.
+ */
+#include <SPI.h>
+#include <RH_RF95.h>
+#include <UniversalRadioWSN.h>
+#include <RadioHeadRadio.h>
+
+//#define ROL_COORDINADOR   // descomentar para compilar el coordinador
+
+const uint8_t DIR_COORDINADOR = 0;
+const uint8_t DIR_NODO        = 1;
+
+RH_RF95 driver(10, 2);   // NSS=D10, DIO0=D2
+
+#if defined(ROL_COORDINADOR)
+// =============================== COORDINADOR ===============================
+UniversalRadio<RadioHeadRadio> radio(driver, DIR_COORDINADOR);
+
+void setup() {
+  Serial.begin(115200);
+  if (!radio.iniciar()) { Serial.println(F("Fallo al iniciar RF95")); while (true); }
+  driver.setFrequency(433.0);
+  Serial.println(F("Coordinador RadioHead listo"));
+}
+
+void loop() {
+  uint8_t datos[RADIOHEAD_WSN_MAX_CARGA];
+  BufferRx rx(datos);
+  size_t n = radio.recibirEn(rx);
+  if (n == 0) return;
+
+  Serial.print(F("Nodo "));  Serial.print(rx.meta.origen);
+  Serial.print(F(" ("));     Serial.print(rx.meta.rssi_dBm);
+  Serial.print(F(" dBm): "));
+  Serial.write(datos, n);
+  Serial.println();
+}
+
+#else
+// ================================== NODO ===================================
+UniversalRadio<RadioHeadRadio> radio(driver, DIR_NODO, DIR_COORDINADOR);
+uint32_t paquetesEnviados = 0;
+
+void setup() {
+  Serial.begin(9600);
+  if (!radio.iniciar()) { Serial.println(F("Fallo al iniciar RF95")); while (true); }
+  driver.setFrequency(433.0);
+  radio.setReintentos(5);
+  radio.setTimeoutAck(400);   // SF7/125 kHz: el ACK tarda ~30 ms en aire, sobra margen
+}
+
+void loop() {
+  char linea[32];
+  int n = snprintf(linea, sizeof(linea), "N:%lu\n", (unsigned long)++paquetesEnviados);
+  bool ok = radio.enviar(reinterpret_cast<const uint8_t*>(linea), n);
+
+  Serial.print(F("Paquete ")); Serial.print(paquetesEnviados);
+  Serial.print(ok ? F(" confirmado") : F(" SIN ACK"));
+  Serial.print(F(", reintentos ")); Serial.print(radio.ultimosReintentos());
+  Serial.print(F("  (entregados ")); Serial.print(radio.entregados());
+  Serial.print(F(" / fallidos ")); Serial.print(radio.fallidos());
+  Serial.println(F(")"));
+
+  delay(3000);
+}
+#endif
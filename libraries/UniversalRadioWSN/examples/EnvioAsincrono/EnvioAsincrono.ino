@@ -0,0 +1,73 @@
+/*
+ * Envío LoRa no bloqueante con LoraTxAsincrono.
+ *  - cada 10 s se encolan dos paquetes (medición + estado) y se vuelve de inmediato
+ *  - mientras están en el aire el micro duerme en power-down; DIO0 (TX-done, pin 2)
+ *    lo despierta y atender() entrega el resultado al callback y lanza el siguiente
+ * Con SF12/125 kHz un paquete de 12 bytes pasa ~1 s en el aire: con endPacket()
+ * bloqueante ese segundo se gastaba en una espera activa.
+ */
+#include <SPI.h>
+#include <LowPower.h>
+#include <UniversalRadioWSN.h>
+
+const LoRaConfig configLora = {
+  410000000L, // frequency
+  17,         // txPower
+  12,         // spreadingFactor
+  125000L,    // signalBandwidth
+  5,          // codingRate
+  0xF3,       // syncWord
+  10,         // csPin
+  9,          // resetPin
+  2           // irqPin (DIO0 en INT0: puede despertar del power-down)
+};
+
+UniversalRadio<LoraRadio> radio(configLora);
+LoraTxAsincrono<4, 24>    colaTx;
+
+const uint32_t PERIODO_MS = 10000;
+uint32_t dormido_ms = 0;     // power-down detiene millis(): se suma aparte
+uint32_t proximo_ms = 0;
+uint16_t secuencia  = 0;
+
+uint32_t ahora() { return millis() + dormido_ms; }
+
+void alTerminar(uint8_t id, bool ok, void*) {
+  Serial.print(F("TX ")); Serial.print(id);
+  Serial.println(ok ? F(" ok") : F(" FALLO"));
+}
+
+void setup() {
+  Serial.begin(9600);
+  if (!radio.iniciar()) {
+    Serial.println(F("Fallo al iniciar LoRa"));
+    while (true);
+  }
+  colaTx.begin(configLora, 4000, false, ahora);   // SF12: margen sobre el aire; el plazo corre con ahora()
+}
+
+void loop() {
+  colaTx.atender();
+
+  if ((int32_t)(ahora() - proximo_ms) >= 0) {
+    proximo_ms = ahora() + PERIODO_MS;
+    secuencia++;
+    uint8_t cabecera[2] = { uint8_t(secuencia >> 8), uint8_t(secuencia) };
+    uint8_t medicion[10] = { 0x01 };   // aquí iría el Packet de CodecWSN
+    uint8_t estado[4]    = { 0x02, uint8_t(colaTx.fallidos()) };
+    if (colaTx.encolar(cabecera, sizeof(cabecera), medicion, sizeof(medicion), alTerminar) < 0 ||
+        colaTx.encolar(cabecera, sizeof(cabecera), estado, sizeof(estado), alTerminar) < 0) {
+      Serial.println(F("Cola llena"));
+    }
+  }
+
+  Serial.flush();
+  if (colaTx.enVuelo()) {
+    // Duerme hasta el TX-done (INT0) o 120 ms como máximo para revisar el timeout
+    LowPower.powerDown(SLEEP_120MS, ADC_OFF, BOD_OFF);
+    dormido_ms += 120;   // cota superior: si despertó DIO0 antes, solo adelanta el timeout
+  } else {
+    LowPower.powerDown(SLEEP_1S, ADC_OFF, BOD_OFF);
+    dormido_ms += 1000;
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ * Benchmark: asignaciones de heap por paquete, String vs. buffers del llamador.
+ *
+ * En AVR, __brkval vale 0 mientras nadie haya llamado a malloc(); cualquier String
+ * lo mueve. El sketch envía RONDAS paquetes con cada API y reporta, por ronda:
+ *   - __brkval antes y después (0 → 0 significa cero asignaciones)
+ *   - µs promedio por envío
+ * Primero corre la API sin copias (cabecera + datos con scatter-gather y recibirEn)
+ * y después la de String, para que la primera no herede el heap de la segunda.
+ */
+#include <SPI.h>
+#include <UniversalRadioWSN.h>
+
+const LoRaConfig configLora = {
+  410000000L, // frequency
+  20,         // txPower
+  7,          // spreadingFactor
+  125000L,    // signalBandwidth
+  5,          // codingRate
+  0xF3,       // syncWord
+  10,         // csPin
+  -1,         // resetPin
+  2           // irqPin
+};
+UniversalRadio<LoraRadio> radio(configLora);
+
+const uint16_t RONDAS = 20;
+extern char* __brkval;
+
+void reportar(const __FlashStringHelper* nombre, uintptr_t antes, uint32_t us) {
+  Serial.print(nombre);
+  Serial.print(F(": __brkval 0x")); Serial.print(antes, HEX);
+  Serial.print(F(" -> 0x"));        Serial.print((uintptr_t)__brkval, HEX);
+  Serial.print(F(", "));            Serial.print(us / RONDAS);
+  Serial.println(F(" us/paquete"));
+}
+
+void setup() {
+  Serial.begin(9600);
+  if (!radio.iniciar()) {
+    Serial.println(F("Fallo al iniciar LoRa"));
+    while (true);
+  }
+
+  // --- 1) Buffers: cabecera fija + datos, recepción en un arreglo estático ---
+  static uint8_t bufferRx[64];
+  BufferRx rx(bufferRx);
+  uint8_t cabecera[3] = { 'N', ':', 0 };
+  uint8_t datos[8];
+  uintptr_t antes = (uintptr_t)__brkval;
+  uint32_t t0 = micros();
+  for (uint16_t i = 0; i < RONDAS; ++i) {
+    cabecera[2] = (uint8_t)i;
+    for (uint8_t k = 0; k < sizeof(datos); ++k) datos[k] = (uint8_t)(i + k);
+    radio.enviar(cabecera, sizeof(cabecera), datos, sizeof(datos));
+    radio.recibirEn(rx);
+  }
+  reportar(F("Buffers"), antes, micros() - t0);
+
+  // --- 2) String: misma carga útil, construida y leída como String ---
+  antes = (uintptr_t)__brkval;
+  t0 = micros();
+  for (uint16_t i = 0; i < RONDAS; ++i) {
+    String payload = "N:" + String(i) + " D:" + String(i * 7);
+    radio.enviar(payload);
+    if (radio.hayDatosDisponibles()) {
+      String recibido = radio.leerComoString();
+      (void)recibido;
+    }
+  }
+  reportar(F("String "), antes, micros() - t0);
+}
+
+void loop() {}
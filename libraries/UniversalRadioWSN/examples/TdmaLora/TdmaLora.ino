@@ -0,0 +1,129 @@
+/*
+ * TDMA por baliza sobre LoRa: sin colisiones entre nodos y con horario fijo de despertar.
+ *
+ *  - COORDINADOR: cada (8 + 1)·400 ms manda la baliza con la hora de red y el mapa de
+ *    slots; a cada nodo que oye le da slot (el primero libre). No contesta cada trama.
+ *  - NODO: escucha hasta oír una baliza; después solo despierta para la ventana de la
+ *    siguiente y para su slot. Sin slot aún, transmite en uno libre para pedirlo.
+ *    Imprime la guarda, que se ajusta sola a la deriva medida de su reloj.
+ *
+ * En un nodo con EnergyWSN, dormirHasta() es sched.after()/sleepFor_ms y la llegada de
+ * la baliza se toma con sched.now() (millis() no avanza en power-down).
+ */
+#include <SPI.h>
+#include <UniversalRadioWSN.h>
+
+//#define ROL_COORDINADOR   // descomentar para compilar el coordinador
+
+const uint8_t  NODO_ID = 1;
+const uint8_t  SLOTS   = 8;
+const uint16_t SLOT_MS = 400;   // SF7: subida de 24 B ≈ 57 ms + guardas, con holgura
+
+const LoRaConfig configLora = {
+  410000000L, // frequency
+  20,         // txPower
+  7,          // spreadingFactor
+  125000L,    // signalBandwidth
+  5,          // codingRate
+  0xF3,       // syncWord
+  10,         // csPin
+  -1,         // resetPin
+  2           // irqPin
+};
+UniversalRadio<LoraRadio> radio(configLora);
+
+#if defined(ROL_COORDINADOR)
+// =============================== COORDINADOR ===============================
+TdmaCoordinador<SLOTS> tdma;
+
+void setup() {
+  Serial.begin(115200);
+  if (!radio.iniciar()) { Serial.println(F("Fallo al iniciar LoRa")); while (true); }
+  TdmaCoordinador<SLOTS>::Cfg cfg;
+  cfg.slot_ms = SLOT_MS;
+  cfg.nSlots  = SLOTS;
+  tdma.begin(cfg);
+}
+
+void loop() {
+  if (tdma.msHastaBaliza() == 0) {
+    uint8_t baliza[TdmaCoordinador<SLOTS>::MAX_BALIZA];
+    radio.enviar(baliza, tdma.baliza(baliza));
+  }
+
+  uint8_t datos[64];
+  BufferRx rx(datos);
+  size_t n = radio.recibirEn(rx);
+  if (n == 0) return;
+
+  int8_t enCurso = tdma.slotEnCurso(rx.meta.llegada_ms);
+  int8_t slot    = tdma.registrar(datos[0]);
+  Serial.print(F("Nodo "));       Serial.print(datos[0]);
+  Serial.print(F(" slot "));      Serial.print(slot);
+  Serial.print(enCurso == slot ? F(" (a tiempo)") : F(" (fuera de su slot)"));
+  Serial.print(F(": "));
+  Serial.write(datos + 1, n - 1);
+  Serial.println();
+}
+
+#else
+// ================================== NODO ===================================
+TdmaNodo tdma;
+uint32_t paquetesEnviados = 0;
+
+void setup() {
+  Serial.begin(9600);
+  if (!radio.iniciar()) { Serial.println(F("Fallo al iniciar LoRa")); while (true); }
+  TdmaNodo::Cfg cfg;
+  cfg.nodo          = NODO_ID;
+  cfg.aireBaliza_ms = (uint16_t)(loraTiempoEnAire_us(configLora, TDMA_CABECERA + SLOTS) / 1000);
+  tdma.begin(cfg);
+  randomSeed(analogRead(A3));
+}
+
+void loop() {
+  uint8_t datos[TDMA_CABECERA + SLOTS + 8];
+  BufferRx rx(datos);
+
+  if (!tdma.sincronizado()) {
+    // Sin sincronía: escucha continua hasta la próxima baliza
+    if (radio.recibirEn(rx)) tdma.procesar(datos, rx.longitud, rx.meta.llegada_ms);
+    return;
+  }
+
+  uint32_t hastaBaliza = tdma.msHastaBaliza();
+  uint32_t hastaSlot   = tdma.msHastaSlot();
+
+  if (hastaSlot < hastaBaliza) {
+    dormirHasta(hastaSlot);
+    char linea[24];
+    linea[0] = (char)NODO_ID;
+    int n = snprintf(linea + 1, sizeof(linea) - 1, "N:%lu", (unsigned long)++paquetesEnviados);
+    radio.enviar(reinterpret_cast<const uint8_t*>(linea), n + 1);
+    return;
+  }
+
+  // Ventana de la baliza: se abre una guarda antes de lo previsto
+  dormirHasta(hastaBaliza);
+  uint32_t inicio = millis(), ventana = tdma.ventanaBaliza_ms();
+  bool oida = false;
+  while (!oida && millis() - inicio < ventana) {
+    if (radio.recibirEn(rx)) oida = tdma.procesar(datos, rx.longitud, rx.meta.llegada_ms);
+  }
+  if (!oida) tdma.balizaPerdida();
+
+  Serial.print(oida ? F("Baliza") : F("Baliza perdida"));
+  Serial.print(F(": slot "));   Serial.print(tdma.slot());
+  Serial.print(F(", guarda ")); Serial.print(tdma.guarda_ms());
+  Serial.print(F(" ms, sesgo ")); Serial.print(tdma.sesgo_ms());
+  Serial.print(F(" ms/ciclo, hora de red ")); Serial.println(tdma.tiempoRed());
+}
+
+// Aquí el nodo real duerme (radio y micro); el ejemplo solo apaga el radio
+void dormirHasta(uint32_t ms) {
+  if (ms == 0) return;
+  radio.dormir();
+  delay(ms);
+  radio.despertar();
+}
+#endif
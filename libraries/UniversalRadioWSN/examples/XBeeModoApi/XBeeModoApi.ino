@@ -0,0 +1,89 @@
+/*
+ * XBee en modo API (AP=1, Serie 1): un coordinador distingue a muchos nodos.
+ *
+ *  - COORDINADOR (ESP32, Serial2): cada frame trae la dirección MY del emisor y el
+ *    RSSI real; se lleva una tabla de nodos con paquetes y último RSSI.
+ *  - NODO (Nano, SoftwareSerial): envía un paquete binario de 8 bytes (sin '\n')
+ *    al coordinador (MY=0) y recibe el TX Status de forma asíncrona.
+ *
+ * Configurar los módulos con XCTU: AP=1, MY único por nodo, coordinador MY=0.
+ */
+#include <UniversalRadioWSN.h>
+#include <XBeeApiRadio.h>
+
+#define ROL_COORDINADOR   // comentar para compilar el nodo
+
+#if defined(ROL_COORDINADOR)
+// =============================== COORDINADOR ===============================
+#define RXD2 16
+#define TXD2 17
+
+UniversalRadio<XBeeApiRadio> radio(Serial2);
+
+const uint8_t MAX_NODOS = 16;
+struct Nodo { uint16_t direccion; uint32_t paquetes; int16_t rssi; };
+Nodo    nodos[MAX_NODOS];
+uint8_t nNodos = 0;
+
+Nodo* nodoPorDireccion(uint16_t direccion) {
+  for (uint8_t k = 0; k < nNodos; ++k)
+    if (nodos[k].direccion == direccion) return &nodos[k];
+  if (nNodos == MAX_NODOS) return nullptr;
+  nodos[nNodos] = { direccion, 0, 0 };
+  return &nodos[nNodos++];
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial2.begin(9600, SERIAL_8N1, RXD2, TXD2);
+  radio.iniciar();
+  Serial.println(F("Coordinador XBee API listo"));
+}
+
+void loop() {
+  uint8_t datos[100];
+  BufferRx rx(datos);
+  if (radio.recibirEn(rx) == 0) return;
+
+  Nodo* nodo = nodoPorDireccion(rx.meta.origen);
+  if (nodo) { nodo->paquetes++; nodo->rssi = rx.meta.rssi_dBm; }
+
+  char linea[64];
+  snprintf(linea, sizeof(linea), "Nodo 0x%04X  %2u bytes  RSSI %4d dBm  total %lu",
+           rx.meta.origen, (unsigned)rx.longitud, rx.meta.rssi_dBm,
+           nodo ? (unsigned long)nodo->paquetes : 0UL);
+  Serial.println(linea);
+}
+
+#else
+// ================================== NODO ===================================
+#include <SoftwareSerial.h>
+
+SoftwareSerial xbeeSerial(2, 3);
+UniversalRadio<XBeeApiRadio> radio(xbeeSerial, 8, 9);   // SLEEP_RQ=D8, ON/SLEEP=D9
+
+uint16_t secuencia = 0;
+
+void alEstadoTx(uint8_t frameId, uint8_t estado, void*) {
+  Serial.print(F("TX ")); Serial.print(frameId);
+  Serial.println(estado == SUCCESS ? F(" entregado") : F(" sin ACK"));
+}
+
+void setup() {
+  Serial.begin(9600);
+  xbeeSerial.begin(9600);
+  radio.iniciar();
+  radio.setDestino(0x0000);          // coordinador
+  radio.onEstadoTx(alEstadoTx);
+}
+
+void loop() {
+  secuencia++;
+  uint8_t paquete[8] = { uint8_t(secuencia >> 8), uint8_t(secuencia), 0x0A, 0x00, 0xFF, 0x13, 0x00, 0x0D };
+  radio.enviar(paquete, sizeof(paquete));   // binario: un 0x0A no corta el paquete
+
+  // El TX Status llega por el UART; hayDatosDisponibles() lo procesa
+  uint32_t t0 = millis();
+  while (millis() - t0 < 3000) radio.hayDatosDisponibles();
+}
+#endif
@@ -0,0 +1,359 @@
+#ifndef SIM_RADIO_H
+#define SIM_RADIO_H
+
+/**
+ * Radio simulado para el host (Linux): los nodos comparten un MedioSim que modela
+ *  - el canal: tiempo en aire por paquete (UART 9600 8N1 del XBee AT, LoRa SFx) y
+ *    colisiones cuando dos transmisiones se solapan en el receptor;
+ *  - cada enlace origen->destino: pérdida, BER, latencia + jitter y RSSI.
+ * enviar() bloquea el tiempo en aire, igual que endPacket() o un SoftwareSerial a 9600.
+ *
+ * Dos modos:
+ *  - en proceso: varios SimRadio (uno por hilo) sobre el mismo MedioSim;
+ *  - multiproceso: cada proceso con su MedioSim en usarUdp(puertoBase, nodos); los
+ *    paquetes viajan por UDP en 127.0.0.1 y el modelo se aplica al llegar.
+ * Es un backend más: UniversalRadio<SimRadio> radio(medio, id) en un sketch.
+ */
+#include <Arduino.h>
+#include <RadioBase.h>
+#include <RadioAdaptador.h>
+#include <LoraTiempoAire.h>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Cómo ocupa el canal cada paquete (común a todos los nodos del medio)
+struct PerfilCanal {
+  uint32_t bitsPorSegundo = 9600;   // UART o tasa de bits del radio; 0 = instantáneo
+  uint8_t  bitsPorByte    = 10;     // 8N1 = 10 bits en el cable
+  uint32_t fijo_us        = 0;      // preámbulo/cabecera por paquete
+  uint8_t  sf             = 0;      // != 0: tiempo en aire LoRa (ignora lo anterior)
+  uint32_t anchoBanda_Hz  = 125000;
+  uint8_t  codingRate     = 5;      // 4/5 .. 4/8
+  uint16_t preambulo      = 8;
+  bool     colisiones     = true;   // dos paquetes solapados en el receptor se pierden
+
+  // XBee AT: enviar() queda bloqueado por el UART a 9600; el RF (250 kbps con CSMA-CA
+  // y reintentos MAC) rara vez colisiona, así que no se modelan colisiones
+  static PerfilCanal xbee9600() {
+    PerfilCanal c;
+    c.colisiones = false;
+    return c;
+  }
+  static PerfilCanal lora(uint8_t sf, uint32_t anchoBanda_Hz = 125000, uint8_t codingRate = 5) {
+    PerfilCanal c;
+    c.sf = sf; c.anchoBanda_Hz = anchoBanda_Hz; c.codingRate = codingRate;
+    return c;
+  }
+
+  // LoRa: misma fórmula que LoraRadio (LoraTiempoAire.h), cabecera explícita y CRC activo
+  uint32_t tiempoEnAire_us(size_t n) const {
+    if (sf == 0) {
+      if (bitsPorSegundo == 0) return fijo_us;
+      return fijo_us + (uint32_t)((uint64_t)n * bitsPorByte * 1000000ULL / bitsPorSegundo);
+    }
+    return loraTiempoEnAire_us(n, sf, anchoBanda_Hz, codingRate, preambulo, true);
+  }
+};
+
+// Calidad de un enlace dirigido origen->destino
+struct PerfilEnlace {
+  float    perdida     = 0.0f;    // probabilidad de perder el paquete entero
+  float    ber         = 0.0f;    // probabilidad de error por bit
+  uint32_t latencia_us = 0;
+  uint32_t jitter_us   = 0;
+  int16_t  rssi_dBm    = -70;
+  bool     crc         = true;    // con CRC un bit malo descarta el paquete; sin CRC llega corrupto
+};
+
+class MedioSim {
+public:
+  static const uint16_t DIFUSION = 0xFFFF;
+  static const size_t   MAX_CARGA = 255;
+
+  struct Estadisticas {
+    uint32_t enviados = 0, recibidos = 0;
+    uint64_t bytesEnviados = 0, bytesRecibidos = 0;
+    uint32_t perdidos = 0, colisiones = 0, errorCrc = 0, corruptos = 0, dormido = 0;
+    uint64_t aire_us = 0;            // tiempo total transmitiendo
+    uint64_t latenciaTotal_us = 0;   // inicio de TX -> disponible en el receptor
+  };
+
+  struct Paquete {
+    uint16_t origen = 0, destino = DIFUSION;
+    uint64_t inicio_us = 0, fin_us = 0, disponible_us = 0;
+    int16_t  rssi_dBm = 0;
+    bool     colisionado = false, errorCrc = false;
+    std::vector<uint8_t> datos;
+  };
+
+  explicit MedioSim(const PerfilCanal& canal = PerfilCanal::xbee9600(), uint32_t semilla = 1)
+    : _canal(canal), _azar(semilla) {}
+
+  ~MedioSim() { for (auto& n : _nodos) if (n.second.socket >= 0) close(n.second.socket); }
+
+  /* Multiproceso: el nodo k escucha en 127.0.0.1:puertoBase+k; la difusión va a 0..nodos-1. */
+  void usarUdp(uint16_t puertoBase, uint16_t nodos) { _puertoBase = puertoBase; _nodosUdp = nodos; }
+
+  const PerfilCanal& canal() const { return _canal; }
+  void setEnlacePorDefecto(const PerfilEnlace& perfil) { std::lock_guard<std::mutex> l(_mutex); _porDefecto = perfil; }
+  void setEnlace(uint16_t origen, uint16_t destino, const PerfilEnlace& perfil) {
+    std::lock_guard<std::mutex> l(_mutex);
+    _enlaces[clave(origen, destino)] = perfil;
+  }
+
+  bool registrar(uint16_t id) {
+    std::lock_guard<std::mutex> l(_mutex);
+    Nodo& n = _nodos[id];
+    if (_puertoBase == 0 || n.socket >= 0) return true;
+    n.socket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (n.socket < 0) return false;
+    fcntl(n.socket, F_SETFL, O_NONBLOCK);
+    sockaddr_in dir = direccionUdp(id);
+    return bind(n.socket, (sockaddr*)&dir, sizeof(dir)) == 0;
+  }
+
+  void setDormido(uint16_t id, bool dormido) { std::lock_guard<std::mutex> l(_mutex); _nodos[id].dormido = dormido; }
+
+  /* Pone el paquete en el canal y bloquea su tiempo en aire; lo devuelve en µs. */
+  uint32_t transmitir(uint16_t origen, uint16_t destino, const uint8_t* datos, size_t n) {
+    uint32_t aire = _canal.tiempoEnAire_us(n);
+    Paquete p;
+    p.origen = origen; p.destino = destino;
+    p.inicio_us = relojHost_us();
+    p.fin_us = p.inicio_us + aire;
+    p.datos.assign(datos, datos + n);
+    {
+      std::lock_guard<std::mutex> l(_mutex);
+      Estadisticas& e = _nodos[origen].stats;
+      e.enviados++; e.bytesEnviados += n; e.aire_us += aire;
+      if (_puertoBase == 0) {
+        for (auto& par : _nodos)
+          if (par.first != origen && (destino == DIFUSION || destino == par.first)) llegada(par.first, par.second, p);
+      }
+    }
+    if (_puertoBase != 0) enviarUdp(p);
+    if (aire) std::this_thread::sleep_for(std::chrono::microseconds(aire));
+    return aire;
+  }
+
+  /* Siguiente paquete ya disponible para id (descarta los perdidos en el camino). */
+  bool tomar(uint16_t id, Paquete& salida) {
+    std::lock_guard<std::mutex> l(_mutex);
+    Nodo& nodo = _nodos[id];
+    if (nodo.socket >= 0) recibirUdp(id, nodo);
+    uint64_t ahora = relojHost_us();
+    while (!nodo.cola.empty() && nodo.cola.front().disponible_us <= ahora) {
+      Paquete p = std::move(nodo.cola.front());
+      nodo.cola.pop_front();
+      if (p.colisionado) { nodo.stats.colisiones++; continue; }
+      if (p.errorCrc)    { nodo.stats.errorCrc++;   continue; }
+      nodo.stats.recibidos++;
+      nodo.stats.bytesRecibidos += p.datos.size();
+      nodo.stats.latenciaTotal_us += p.disponible_us - p.inicio_us;
+      salida = std::move(p);
+      return true;
+    }
+    return false;
+  }
+
+  Estadisticas estadisticas(uint16_t id) { std::lock_guard<std::mutex> l(_mutex); return _nodos[id].stats; }
+
+  Estadisticas totales() {
+    std::lock_guard<std::mutex> l(_mutex);
+    Estadisticas t;
+    for (auto& par : _nodos) {
+      const Estadisticas& e = par.second.stats;
+      t.enviados += e.enviados; t.recibidos += e.recibidos;
+      t.bytesEnviados += e.bytesEnviados; t.bytesRecibidos += e.bytesRecibidos;
+      t.perdidos += e.perdidos; t.colisiones += e.colisiones; t.errorCrc += e.errorCrc;
+      t.corruptos += e.corruptos; t.dormido += e.dormido;
+      t.aire_us += e.aire_us; t.latenciaTotal_us += e.latenciaTotal_us;
+    }
+    return t;
+  }
+
+private:
+  struct Nodo {
+    std::deque<Paquete> cola;
+    Estadisticas stats;
+    bool dormido = false;
+    int  socket = -1;
+  };
+
+  PerfilCanal  _canal;
+  PerfilEnlace _porDefecto;
+  std::map<uint32_t, PerfilEnlace> _enlaces;
+  std::map<uint16_t, Nodo> _nodos;
+  std::mt19937 _azar;
+  std::mutex   _mutex;
+  uint16_t     _puertoBase = 0, _nodosUdp = 0;
+
+  static uint32_t clave(uint16_t origen, uint16_t destino) { return ((uint32_t)origen << 16) | destino; }
+
+  const PerfilEnlace& enlace(uint16_t origen, uint16_t destino) const {
+    auto it = _enlaces.find(clave(origen, destino));
+    return it == _enlaces.end() ? _porDefecto : it->second;
+  }
+
+  float azar01() { return std::uniform_real_distribution<float>(0.0f, 1.0f)(_azar); }
+
+  // Aplica el modelo del enlace al llegar un paquete a id (con _mutex tomado)
+  void llegada(uint16_t id, Nodo& nodo, Paquete p) {
+    if (nodo.dormido) { nodo.stats.dormido++; return; }
+    const PerfilEnlace& e = enlace(p.origen, id);
+    if (e.perdida > 0 && azar01() < e.perdida) { nodo.stats.perdidos++; return; }
+
+    if (e.ber > 0) {
+      bool volteado = false;
+      for (size_t i = 0; i < p.datos.size() * 8; ++i)
+        if (azar01() < e.ber) { p.datos[i / 8] ^= (uint8_t)(1u << (i % 8)); volteado = true; }
+      if (volteado) { if (e.crc) p.errorCrc = true; else nodo.stats.corruptos++; }
+    }
+
+    uint32_t jitter = e.jitter_us ? (uint32_t)(_azar() % (e.jitter_us + 1)) : 0;
+    p.disponible_us = p.fin_us + e.latencia_us + jitter;
+    p.rssi_dBm = e.rssi_dBm;
+
+    if (_canal.colisiones) {
+      for (Paquete& otro : nodo.cola)
+        if (otro.origen != p.origen && otro.inicio_us < p.fin_us && p.inicio_us < otro.fin_us)
+          otro.colisionado = p.colisionado = true;
+    }
+
+    // Orden por disponibilidad: con jitter un paquete puede adelantar a otro
+    auto pos = nodo.cola.end();
+    while (pos != nodo.cola.begin() && (pos - 1)->disponible_us > p.disponible_us) --pos;
+    nodo.cola.insert(pos, std::move(p));
+  }
+
+  // --- Transporte UDP (multiproceso) ---
+  // Datagrama: [origen u16][destino u16][inicio u64][fin u64][datos], little endian del host
+
+  sockaddr_in direccionUdp(uint16_t id) const {
+    sockaddr_in dir = {};
+    dir.sin_family = AF_INET;
+    dir.sin_port = htons((uint16_t)(_puertoBase + id));
+    dir.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return dir;
+  }
+
+  void enviarUdp(const Paquete& p) {
+    int s;
+    {
+      std::lock_guard<std::mutex> l(_mutex);
+      auto it = _nodos.find(p.origen);
+      if (it == _nodos.end() || it->second.socket < 0) return;
+      s = it->second.socket;
+    }
+    uint8_t dgrama[20 + MAX_CARGA];
+    size_t n = min(p.datos.size(), MAX_CARGA);
+    memcpy(dgrama, &p.origen, 2);
+    memcpy(dgrama + 2, &p.destino, 2);
+    memcpy(dgrama + 4, &p.inicio_us, 8);
+    memcpy(dgrama + 12, &p.fin_us, 8);
+    memcpy(dgrama + 20, p.datos.data(), n);
+    for (uint16_t k = 0; k < _nodosUdp; ++k) {
+      if (k == p.origen || (p.destino != DIFUSION && p.destino != k)) continue;
+      sockaddr_in dir = direccionUdp(k);
+      sendto(s, dgrama, 20 + n, 0, (sockaddr*)&dir, sizeof(dir));
+    }
+  }
+
+  void recibirUdp(uint16_t id, Nodo& nodo) {
+    uint8_t dgrama[20 + MAX_CARGA];
+    ssize_t n;
+    while ((n = recv(nodo.socket, dgrama, sizeof(dgrama), 0)) >= 20) {
+      Paquete p;
+      memcpy(&p.origen, dgrama, 2);
+      memcpy(&p.destino, dgrama + 2, 2);
+      memcpy(&p.inicio_us, dgrama + 4, 8);
+      memcpy(&p.fin_us, dgrama + 12, 8);
+      p.datos.assign(dgrama + 20, dgrama + n);
+      llegada(id, nodo, std::move(p));
+    }
+  }
+};
+
+class SimBackend : public RadioBase<SimBackend> {
+public:
+  using RadioBase<SimBackend>::enviar;
+
+  SimBackend(MedioSim& medio, uint16_t id, uint16_t destino = MedioSim::DIFUSION)
+    : _medio(medio), _id(id), _destino(destino) {}
+
+  bool iniciar() { return _medio.registrar(_id); }
+
+  void setDestino(uint16_t destino) { _destino = destino; }
+
+  bool enviar(const uint8_t* buffer, size_t longitud) {
+    if (longitud == 0 || longitud > MedioSim::MAX_CARGA || _dormido) return false;
+    _stats.registrarTx(true, _medio.transmitir(_id, _destino, buffer, longitud));
+    return true;
+  }
+
+  int hayDatosDisponibles() {
+    if (_pendiente) return (int)_paquete.datos.size();
+    if (_dormido) return 0;
+    bool hay = _medio.tomar(_id, _paquete);
+    _stats.errorCrc = _medio.estadisticas(_id).errorCrc;
+    if (!hay) return 0;
+    _pendiente = true;
+    return (int)_paquete.datos.size();
+  }
+
+  size_t leer(uint8_t* buffer, size_t maxLongitud) {
+    if (hayDatosDisponibles() <= 0) return 0;
+    size_t n = min(_paquete.datos.size(), maxLongitud);   // como LoRa: lo que no cabe se pierde
+    memcpy(buffer, _paquete.datos.data(), n);
+    _pendiente = false;
+    _stats.registrarRx(_paquete.rssi_dBm);
+    return n;
+  }
+
+  size_t recibirEn(BufferRx& buffer) {
+    buffer.longitud = 0;
+    if (hayDatosDisponibles() <= 0) return 0;
+    buffer.meta.longitudOriginal = _paquete.datos.size();
+    buffer.meta.rssi_dBm         = _paquete.rssi_dBm;
+    buffer.meta.snr_cuartos_dB   = 0;
+    buffer.meta.llegada_ms       = millis();
+    buffer.meta.origen           = _paquete.origen;
+    buffer.longitud = leer(buffer.datos, buffer.capacidad);
+    return buffer.longitud;
+  }
+
+  int  obtenerRSSI() { return _paquete.rssi_dBm; }
+  bool dormir()      { _dormido = true;  _medio.setDormido(_id, true);  return true; }
+  bool despertar()   { _dormido = false; _medio.setDormido(_id, false); return true; }
+
+  uint16_t  id() const { return _id; }
+  MedioSim& medio()    { return _medio; }
+
+private:
+  MedioSim& _medio;
+  uint16_t  _id, _destino;
+  MedioSim::Paquete _paquete;
+  bool      _pendiente = false, _dormido = false;
+};
+
+// Versión polimórfica (RadioInterface): radio = new SimRadio(medio, id)
+class SimRadio : public RadioAdaptador<SimBackend> {
+public:
+  SimRadio(MedioSim& medio, uint16_t id, uint16_t destino = MedioSim::DIFUSION)
+    : RadioAdaptador<SimBackend>(medio, id, destino) {}
+};
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * Prueba de carga en un solo proceso: N nodos (un hilo cada uno) reportan al
+ * coordinador 0 por un MedioSim compartido y se mide entrega, colisiones,
+ * ocupación del canal y throughput útil.
+ *
+ *   sim_carga [nodos=20] [segundos=30] [periodo_ms=3000] [canal=xbee|sf7..sf12]
+ *             [perdida=0.0] [ber=0.0]
+ */
+#include <Arduino.h>
+#include <UniversalRadio.h>
+#include "SimRadio.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> corriendo(true);
+
+void nodo(MedioSim& medio, uint16_t id, uint32_t periodo_ms) {
+  UniversalRadio<SimRadio> radio(medio, id, 0);
+  radio.iniciar();
+  uint32_t proximo = millis() + (uint32_t)random(periodo_ms);   // fases al azar
+  uint32_t secuencia = 0;
+  while (corriendo) {
+    if ((int32_t)(millis() - proximo) >= 0) {
+      proximo += periodo_ms;
+      char linea[64];
+      int n = snprintf(linea, sizeof(linea), "N:%lu V:%.2f I:%.2f B:3.90\n",
+                       (unsigned long)++secuencia, 127.0 + random(-300, 300) / 100.0, random(0, 1500) / 100.0);
+      radio.enviar(reinterpret_cast<const uint8_t*>(linea), (size_t)n);
+    }
+    delay(1);
+  }
+}
+
+PerfilCanal canalPorNombre(const std::string& nombre) {
+  if (nombre.size() > 2 && nombre.compare(0, 2, "sf") == 0)
+    return PerfilCanal::lora((uint8_t)atoi(nombre.c_str() + 2));
+  return PerfilCanal::xbee9600();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint16_t    nodos      = argc > 1 ? (uint16_t)atoi(argv[1]) : 20;
+  uint32_t    segundos   = argc > 2 ? (uint32_t)atoi(argv[2]) : 30;
+  uint32_t    periodo_ms = argc > 3 ? (uint32_t)atoi(argv[3]) : 3000;
+  std::string canal      = argc > 4 ? argv[4] : "xbee";
+  PerfilEnlace enlace;
+  enlace.perdida = argc > 5 ? (float)atof(argv[5]) : 0.0f;
+  enlace.ber     = argc > 6 ? (float)atof(argv[6]) : 0.0f;
+
+  MedioSim medio(canalPorNombre(canal));
+  medio.setEnlacePorDefecto(enlace);
+
+  UniversalRadio<SimRadio> coordinador(medio, 0);
+  coordinador.iniciar();
+  for (uint16_t id = 1; id <= nodos; ++id) medio.registrar(id);   // todos existen antes del primer envío
+
+  std::vector<std::thread> hilos;
+  for (uint16_t id = 1; id <= nodos; ++id) hilos.emplace_back(nodo, std::ref(medio), id, periodo_ms);
+
+  uint8_t  datos[64];
+  BufferRx rx(datos);
+  uint32_t t0 = millis();
+  while (millis() - t0 < segundos * 1000UL) {
+    if (coordinador.recibirEn(rx) == 0) delayMicroseconds(200);
+  }
+  corriendo = false;
+  for (std::thread& h : hilos) h.join();
+
+  MedioSim::Estadisticas total = medio.totales();
+  MedioSim::Estadisticas rxc   = medio.estadisticas(0);
+  double duracion_s = (millis() - t0) / 1000.0;
+  uint32_t ofrecidos = total.enviados;
+
+  printf("canal %s, %u nodos, periodo %lu ms, %.0f s\n", canal.c_str(), nodos, (unsigned long)periodo_ms, duracion_s);
+  printf("  tiempo en aire de un paquete de 40 B: %.1f ms\n", medio.canal().tiempoEnAire_us(40) / 1000.0);
+  printf("  ofrecidos %lu, entregados %lu (%.1f %%)\n", (unsigned long)ofrecidos, (unsigned long)rxc.recibidos,
+         ofrecidos ? 100.0 * rxc.recibidos / ofrecidos : 0.0);
+  printf("  perdidos %lu, colisiones %lu, CRC %lu\n", (unsigned long)rxc.perdidos,
+         (unsigned long)rxc.colisiones, (unsigned long)rxc.errorCrc);
+  printf("  ocupación del canal %.1f %%, throughput útil %.1f B/s, latencia media %.1f ms\n",
+         100.0 * total.aire_us / 1e6 / duracion_s, rxc.bytesRecibidos / duracion_s,
+         rxc.recibidos ? rxc.latenciaTotal_us / 1000.0 / rxc.recibidos : 0.0);
+  return 0;
+}
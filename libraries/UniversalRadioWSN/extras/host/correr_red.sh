@@ -0,0 +1,15 @@
+#!/bin/sh
+# Coordinador + N nodos como procesos separados sobre el medio UDP de SimRadio.
+#   ./correr_red.sh [nodos=8] [segundos=30] [canal=0|7..12] [dir_build=build]
+NODOS=${1:-8}
+export SIM_DURACION_S=${2:-30}
+export SIM_CANAL=${3:-0}
+BUILD=${4:-build}
+export SIM_NODOS=$((NODOS + 1))
+
+SIM_NODO=0 "$BUILD/CoordinadorSim" &
+sleep 1
+for k in $(seq 1 "$NODOS"); do
+  SIM_NODO=$k SIM_DURACION_S=$((SIM_DURACION_S - 1)) "$BUILD/NodoSim" &
+done
+wait
@@ -0,0 +1,121 @@
+/*
+ * Prueba del failover de BondedRadio con radios de mentira (sin medio ni hilos):
+ *
+ *  1. Enlace barato sin ACK (como LoRa) muerto: enviar() siempre devuelve true y el
+ *     sketch notifica la pérdida de cada frame por falta de ACK de aplicación, como
+ *     examples/EnlaceDoble. El tráfico debe pasar al otro enlace en a lo más
+ *     PERDIDAS_MAX frames, y los true ciegos no deben frenar la caída de la tasa.
+ *  2. Enlace barato con ACK de enlace (como nRF24) muerto: enviar() devuelve false y
+ *     el mismo frame sale por el otro enlace en esa llamada.
+ *  3. Un enlace sin ACK que entrega bien: sus ACK notificados lo mantienen sano.
+ *
+ *   prueba_bonded
+ *
+ * Sale con 0 si todo se cumple.
+ */
+#include <Arduino.h>
+#include <BondedRadio.h>
+
+#include <stdio.h>
+
+namespace {
+
+// Con umbralSalud 128 y EWMA 1/8 desde 255: 224 196 172 151 133 117 -> enfermo al sexto
+const int PERDIDAS_MAX = 6;
+
+class RadioFalso : public RadioInterface {
+public:
+  RadioFalso(bool conAck, bool vivo) : _conAck(conAck), _vivo(vivo) {}
+
+  bool iniciar() override { return true; }
+  bool enviar(const uint8_t*, size_t) override {
+    ++enviados;
+    return _conAck ? _vivo : true;      // sin ACK: salió al aire, llegue o no
+  }
+  int    hayDatosDisponibles() override            { return 0; }
+  size_t leer(uint8_t*, size_t) override           { return 0; }
+  bool   confirmaEntrega() const override          { return _conAck; }
+
+  bool vivo() const { return _vivo; }
+
+  int enviados = 0;
+
+private:
+  bool _conAck, _vivo;
+};
+
+int fallas = 0;
+
+void verificar(bool condicion, const char* que) {
+  printf("  [%s] %s\n", condicion ? "ok" : "FALLA", que);
+  if (!condicion) ++fallas;
+}
+
+const uint8_t DATOS[] = { 'N', ':', '1', '\n' };
+
+// Envía hasta que el tráfico sale por 'respaldo'; notifica cada resultado como lo haría
+// el ACK de aplicación. Devuelve cuántos frames se perdieron por el enlace muerto.
+int perdidasHastaFailover(BondedRadio<2>& radio, RadioFalso* enlaces[2], uint8_t respaldo) {
+  for (int perdidas = 0; perdidas <= 50; ) {
+    radio.enviar(DATOS, sizeof(DATOS));
+    uint8_t k = radio.ultimoEnlaceTx();
+    if (k == respaldo) return perdidas;
+    bool llego = enlaces[k]->vivo();
+    radio.notificarResultado(k, llego);
+    if (!llego) ++perdidas;
+  }
+  return 1000;
+}
+
+void caso(const char* titulo, bool primarioConAck) {
+  printf("%s\n", titulo);
+  RadioFalso primario(primarioConAck, false), respaldo(false, true);
+  RadioFalso* enlaces[2] = { &primario, &respaldo };
+  BondedRadio<2> radio;
+  radio.agregarEnlace(&primario, 10);     // el más barato, muerto
+  radio.agregarEnlace(&respaldo, 40);
+  radio.iniciar();
+
+  int perdidas = perdidasHastaFailover(radio, enlaces, 1);
+  printf("  frames perdidos antes del failover: %d\n", perdidas);
+  if (primarioConAck) {
+    verificar(perdidas == 0, "con ACK de enlace el primer frame ya sale por el respaldo");
+  } else {
+    verificar(perdidas <= PERDIDAS_MAX, "sin ACK el failover llega en a lo más 6 pérdidas notificadas");
+  }
+
+  // Ya en el respaldo: sus ACK lo mantienen y el muerto no vuelve antes de reintentoSalud_ms
+  bool todosPorRespaldo = true;
+  for (int i = 0; i < 20; ++i) {
+    radio.enviar(DATOS, sizeof(DATOS));
+    uint8_t k = radio.ultimoEnlaceTx();
+    todosPorRespaldo &= (k == 1);
+    radio.notificarResultado(k, enlaces[k]->vivo());
+  }
+  verificar(todosPorRespaldo, "20 frames más llegan por el respaldo");
+  verificar(!radio.sano(0), "el enlace muerto queda enfermo");
+  verificar(radio.sano(1), "el respaldo sigue sano");
+}
+
+}  // namespace
+
+int main() {
+  caso("primario sin ACK (LoRa/XBee AT) muerto", false);
+  caso("primario con ACK (nRF24/RadioHead) muerto", true);
+
+  printf("primario sin ACK que entrega\n");
+  RadioFalso bueno(false, true), otro(false, true);
+  BondedRadio<2> radio;
+  radio.agregarEnlace(&bueno, 10);
+  radio.agregarEnlace(&otro, 40);
+  radio.iniciar();
+  for (int i = 0; i < 100; ++i) {
+    radio.enviar(DATOS, sizeof(DATOS));
+    radio.notificarResultado(radio.ultimoEnlaceTx(), true);
+  }
+  verificar(bueno.enviados == 100 && otro.enviados == 0, "los 100 frames salen por el barato");
+  verificar(radio.enlace(0).entrega == 255, "su tasa sigue en 255");
+
+  printf(fallas ? "FALLA (%d)\n" : "OK\n", fallas);
+  return fallas ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+#include "Arduino.h"
+
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace {
+  const uint64_t ARRANQUE_US = relojHost_us();
+
+  std::mutex   mutexSalida;   // los nodos de una simulación en hilos comparten stdout
+  std::mt19937 generador(1);
+  std::mutex   mutexAzar;
+
+  char* enBase(unsigned long valor, char* destino, int base, bool negativo) {
+    char tmp[34];
+    int i = 0;
+    if (base < 2 || base > 36) base = 10;
+    do {
+      int d = (int)(valor % (unsigned long)base);
+      tmp[i++] = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+      valor /= (unsigned long)base;
+    } while (valor);
+    char* p = destino;
+    if (negativo) *p++ = '-';
+    while (i) *p++ = tmp[--i];
+    *p = '\0';
+    return destino;
+  }
+}
+
+uint64_t relojHost_us() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t millis() { return (uint32_t)((relojHost_us() - ARRANQUE_US) / 1000); }
+uint32_t micros() { return (uint32_t)(relojHost_us() - ARRANQUE_US); }
+
+void delay(uint32_t ms)             { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+void delayMicroseconds(uint32_t us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+
+long random(long maximo) { return random(0, maximo); }
+long random(long minimo, long maximo) {
+  if (maximo <= minimo) return minimo;
+  std::lock_guard<std::mutex> l(mutexAzar);
+  return std::uniform_int_distribution<long>(minimo, maximo - 1)(generador);
+}
+void randomSeed(unsigned long semilla) {
+  std::lock_guard<std::mutex> l(mutexAzar);
+  generador.seed((std::mt19937::result_type)semilla);
+}
+
+char* dtostrf(double valor, signed char ancho, unsigned char decimales, char* destino) {
+  sprintf(destino, "%*.*f", ancho, decimales, valor);
+  return destino;
+}
+char* ultoa(unsigned long valor, char* destino, int base) { return enBase(valor, destino, base, false); }
+char* utoa(unsigned valor, char* destino, int base)       { return enBase(valor, destino, base, false); }
+char* ltoa(long valor, char* destino, int base) {
+  bool negativo = valor < 0 && base == 10;
+  return enBase(negativo ? 0UL - (unsigned long)valor : (unsigned long)valor, destino, base, negativo);
+}
+char* itoa(int valor, char* destino, int base) { return ltoa(valor, destino, base); }
+
+long hostParametro(const char* nombre, long porDefecto) {
+  const char* valor = getenv(nombre);
+  return valor && *valor ? strtol(valor, nullptr, 0) : porDefecto;
+}
+
+size_t HardwareSerial::write(uint8_t b) { return write(&b, 1); }
+size_t HardwareSerial::write(const uint8_t* buffer, size_t n) {
+  std::lock_guard<std::mutex> l(mutexSalida);
+  return fwrite(buffer, 1, n, stdout);
+}
+void HardwareSerial::flush() { fflush(stdout); }
+
+HardwareSerial Serial;
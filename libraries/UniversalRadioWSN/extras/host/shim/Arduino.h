@@ -0,0 +1,104 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/**
+ * Subconjunto del núcleo de Arduino para compilar UniversalRadioWSN y sketches en Linux.
+ * millis()/micros() son tiempo real (reloj monótono desde el arranque del proceso) y
+ * Serial escribe en stdout; los pines y el ADC no hacen nada. Solo lo que usan
+ * las librerías WSN: no es un emulador de la placa.
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <type_traits>
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define LED_BUILTIN 13
+
+#define PROGMEM
+#define F(texto) (texto)
+#define pgm_read_byte(direccion) (*(const uint8_t*)(direccion))
+#define pgm_read_word(direccion) (*(const uint16_t*)(direccion))
+
+// Como las macros de AVR, pero sin evaluar dos veces ni chocar con <algorithm>.
+// Devuelven por valor: con decltype(a < b ? a : b) y A == B el tipo sería A&, una
+// referencia al parámetro que muere al retornar.
+template <class A, class B> inline typename std::common_type<A, B>::type min(A a, B b) { return a < b ? a : b; }
+template <class A, class B> inline typename std::common_type<A, B>::type max(A a, B b) { return a > b ? a : b; }
+template <class T, class A, class B> inline T constrain(T x, A a, B b) { return x < a ? a : (x > b ? b : x); }
+
+// --- Tiempo ---
+uint32_t millis();
+uint32_t micros();
+uint64_t relojHost_us();        // reloj monótono del sistema: común a todos los procesos
+void     delay(uint32_t ms);
+void     delayMicroseconds(uint32_t us);
+inline void yield() {}
+
+// --- E/S (sin efecto en el host) ---
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int  digitalRead(uint8_t) { return LOW; }
+inline int  analogRead(uint8_t) { return 0; }
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline int  digitalPinToInterrupt(int pin) { return pin; }
+inline void attachInterrupt(int, void (*)(), int) {}
+inline void detachInterrupt(int) {}
+
+long random(long maximo);
+long random(long minimo, long maximo);
+void randomSeed(unsigned long semilla);
+
+// --- stdlib de avr-libc que glibc no trae ---
+char* dtostrf(double valor, signed char ancho, unsigned char decimales, char* destino);
+char* ultoa(unsigned long valor, char* destino, int base);
+char* ltoa(long valor, char* destino, int base);
+char* utoa(unsigned valor, char* destino, int base);
+char* itoa(int valor, char* destino, int base);
+
+// --- Parámetros del proceso (SIM_NODO=3 ./NodoSim) ---
+long hostParametro(const char* nombre, long porDefecto);
+
+// El sketch puede definirla para imprimir sus métricas al terminar SIM_DURACION_S
+void hostAlTerminar();
+
+#include "WString.h"
+#include "Stream.h"
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long, int = 0, int = -1, int = -1) {}
+  void end() {}
+  operator bool() const { return true; }
+  size_t write(uint8_t b) override;
+  size_t write(const uint8_t* buffer, size_t n) override;
+  using Print::write;
+  int available() override { return 0; }
+  int read() override      { return -1; }
+  int peek() override      { return -1; }
+  void flush() override;
+};
+
+extern HardwareSerial Serial;
+
+#define SERIAL_8N1 0x06
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef HOST_STREAM_H
+#define HOST_STREAM_H
+
+#include "Arduino.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// Print/Stream de Arduino: todo termina en write(uint8_t) o write(buffer, n)
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t n) {
+    size_t escritos = 0;
+    while (n--) escritos += write(*buffer++);
+    return escritos;
+  }
+  size_t write(const char* texto)             { return texto ? write((const uint8_t*)texto, strlen(texto)) : 0; }
+  size_t write(const char* buffer, size_t n)  { return write((const uint8_t*)buffer, n); }
+  virtual void flush() {}
+
+  size_t print(const char* texto)                  { return write(texto); }
+  size_t print(const String& texto)                { return write(texto.c_str(), texto.length()); }
+  size_t print(char c)                             { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base = DEC)    { return print((unsigned long)v, base); }
+  size_t print(int v, int base = DEC)              { return print((long)v, base); }
+  size_t print(unsigned v, int base = DEC)         { return print((unsigned long)v, base); }
+  size_t print(long v, int base = DEC)             { char b[34]; return write(ltoa(v, b, base)); }
+  size_t print(unsigned long v, int base = DEC)    { char b[34]; return write(ultoa(v, b, base)); }
+  size_t print(double v, int decimales = 2)        { char b[48]; snprintf(b, sizeof(b), "%.*f", decimales, v); return write(b); }
+
+  size_t println()                                 { return write("\r\n"); }
+  template <class T> size_t println(const T& v)            { size_t n = print(v); return n + println(); }
+  template <class T> size_t println(const T& v, int extra) { size_t n = print(v, extra); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long ms) { _timeout_ms = ms; }
+
+  size_t readBytes(uint8_t* buffer, size_t n) {
+    size_t leidos = 0;
+    while (leidos < n) {
+      int c = leerConTimeout();
+      if (c < 0) break;
+      buffer[leidos++] = (uint8_t)c;
+    }
+    return leidos;
+  }
+  size_t readBytes(char* buffer, size_t n) { return readBytes((uint8_t*)buffer, n); }
+
+  size_t readBytesUntil(char fin, uint8_t* buffer, size_t n) {
+    size_t leidos = 0;
+    while (leidos < n) {
+      int c = leerConTimeout();
+      if (c < 0 || c == fin) break;
+      buffer[leidos++] = (uint8_t)c;
+    }
+    return leidos;
+  }
+  size_t readBytesUntil(char fin, char* buffer, size_t n) { return readBytesUntil(fin, (uint8_t*)buffer, n); }
+
+  String readStringUntil(char fin) {
+    String r;
+    for (int c = leerConTimeout(); c >= 0 && c != fin; c = leerConTimeout()) r += (char)c;
+    return r;
+  }
+
+protected:
+  unsigned long _timeout_ms = 1000;
+
+  int leerConTimeout() {
+    uint32_t t0 = millis();
+    do {
+      int c = read();
+      if (c >= 0) return c;
+    } while (millis() - t0 < _timeout_ms);
+    return -1;
+  }
+};
+
+#endif
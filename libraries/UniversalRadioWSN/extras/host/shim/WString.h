@@ -0,0 +1,89 @@
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+#include <string>
+
+// String de Arduino sobre std::string: mismas operaciones que usan los sketches WSN
+class String {
+public:
+  String(const char* texto = "") : _s(texto ? texto : "") {}
+  String(const std::string& texto) : _s(texto) {}
+  explicit String(char c) : _s(1, c) {}
+  String(int valor, unsigned char base = 10)           { entero(valor, base); }
+  String(unsigned valor, unsigned char base = 10)      { natural(valor, base); }
+  String(long valor, unsigned char base = 10)          { entero(valor, base); }
+  String(unsigned long valor, unsigned char base = 10) { natural(valor, base); }
+  String(float valor, unsigned char decimales = 2)     { real(valor, decimales); }
+  String(double valor, unsigned char decimales = 2)    { real(valor, decimales); }
+
+  const char*  c_str() const  { return _s.c_str(); }
+  unsigned int length() const { return (unsigned int)_s.size(); }
+  bool reserve(unsigned int n) { _s.reserve(n); return true; }
+
+  char charAt(unsigned int i) const     { return i < _s.size() ? _s[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+
+  String& operator+=(const String& otro) { _s += otro._s; return *this; }
+  String& operator+=(const char* texto)  { _s += texto; return *this; }
+  String& operator+=(char c)             { _s += c; return *this; }
+  friend String operator+(String a, const String& b) { a += b; return a; }
+  friend String operator+(String a, const char* b)   { a += b; return a; }
+  friend String operator+(const char* a, const String& b) { return String(a) + b; }
+
+  bool equals(const String& otro) const     { return _s == otro._s; }
+  bool operator==(const String& otro) const { return _s == otro._s; }
+  bool operator==(const char* texto) const  { return _s == texto; }
+  bool operator!=(const String& otro) const { return _s != otro._s; }
+  bool operator!=(const char* texto) const  { return _s != texto; }
+
+  bool startsWith(const String& prefijo) const { return _s.compare(0, prefijo._s.size(), prefijo._s) == 0; }
+  bool endsWith(const String& sufijo) const {
+    return _s.size() >= sufijo._s.size() &&
+           _s.compare(_s.size() - sufijo._s.size(), sufijo._s.size(), sufijo._s) == 0;
+  }
+  int indexOf(char c, unsigned int desde = 0) const {
+    size_t p = _s.find(c, desde);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  int indexOf(const String& texto, unsigned int desde = 0) const {
+    size_t p = _s.find(texto._s, desde);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  String substring(unsigned int desde) const { return desde < _s.size() ? String(_s.substr(desde)) : String(); }
+  String substring(unsigned int desde, unsigned int hasta) const {
+    if (hasta > _s.size()) hasta = (unsigned int)_s.size();
+    return desde < hasta ? String(_s.substr(desde, hasta - desde)) : String();
+  }
+
+  void trim() {
+    const char* blancos = " \t\r\n\f\v";
+    size_t a = _s.find_first_not_of(blancos);
+    if (a == std::string::npos) { _s.clear(); return; }
+    _s = _s.substr(a, _s.find_last_not_of(blancos) - a + 1);
+  }
+  void toUpperCase() { for (char& c : _s) if (c >= 'a' && c <= 'z') c = (char)(c - 32); }
+
+  long   toInt() const   { return strtol(_s.c_str(), nullptr, 10); }
+  float  toFloat() const { return strtof(_s.c_str(), nullptr); }
+
+private:
+  std::string _s;
+
+  void natural(unsigned long valor, unsigned char base) {
+    char b[34];
+    ultoa(valor, b, base);
+    _s = b;
+  }
+  void entero(long valor, unsigned char base) {
+    char b[34];
+    ltoa(valor, b, base);
+    _s = b;
+  }
+  void real(double valor, unsigned char decimales) {
+    char b[48];
+    snprintf(b, sizeof(b), "%.*f", decimales, valor);
+    _s = b;
+  }
+};
+
+#endif
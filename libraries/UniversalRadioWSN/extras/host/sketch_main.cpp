@@ -0,0 +1,20 @@
+#include <Arduino.h>
+
+// main() de los sketches en el host: setup() una vez y loop() durante SIM_DURACION_S segundos
+
+void setup();
+void loop();
+void hostAlTerminar() __attribute__((weak));
+
+int main() {
+  const uint32_t duracion_ms = (uint32_t)hostParametro("SIM_DURACION_S", 30) * 1000UL;
+  setup();
+  const uint32_t t0 = millis();
+  while (millis() - t0 < duracion_ms) {
+    loop();
+    delayMicroseconds(200);   // el sketch no gira al 100 % de una CPU del host
+  }
+  if (hostAlTerminar) hostAlTerminar();
+  Serial.flush();
+  return 0;
+}
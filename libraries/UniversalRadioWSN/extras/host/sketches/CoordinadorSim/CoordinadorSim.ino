@@ -0,0 +1,85 @@
+/*
+ * Coordinador de la red simulada (nodo 0): el mismo ciclo que ReceptorUniversal.
+ * Cuenta por nodo los paquetes recibidos y los huecos en N: (pérdidas) y al final
+ * imprime entrega, throughput útil y latencia media del medio.
+ *
+ *   SIM_NODOS=9 SIM_CANAL=0 ./CoordinadorSim
+ */
+#include <UniversalRadio.h>
+#include <SimRadio.h>
+
+const uint16_t ID_COORDINADOR = 0;
+const uint16_t MAX_NODOS = 64;
+
+PerfilCanal canalElegido() {
+  long sf = hostParametro("SIM_CANAL", 0);
+  return sf ? PerfilCanal::lora((uint8_t)sf) : PerfilCanal::xbee9600();
+}
+
+MedioSim medio(canalElegido(), 7);
+UniversalRadio<SimRadio> radio(medio, ID_COORDINADOR);
+
+uint8_t  bufferRx[128];
+BufferRx rx(bufferRx);
+
+struct Nodo { uint32_t recibidos, primero, ultimo; };
+Nodo     nodos[MAX_NODOS];
+uint32_t inicio_ms = 0;
+bool     responder = false;
+
+void setup() {
+  Serial.begin(115200);
+  PerfilEnlace enlace;
+  enlace.perdida = hostParametro("SIM_PERDIDA_PPM", 0) / 1e6f;
+  enlace.ber     = hostParametro("SIM_BER_PPB", 0) / 1e9f;
+  medio.setEnlacePorDefecto(enlace);
+  medio.usarUdp((uint16_t)hostParametro("SIM_PUERTO", 47000), (uint16_t)hostParametro("SIM_NODOS", 8));
+  responder = hostParametro("SIM_RESPONDER", 0) != 0;
+
+  if (!radio.iniciar()) {
+    Serial.println("ERROR: no se pudo abrir el puerto UDP del coordinador");
+    exit(1);
+  }
+  inicio_ms = millis();
+  Serial.println("--- COORDINADOR SIMULADO ---");
+}
+
+void loop() {
+  size_t n = radio.recibirEn(rx);
+  if (n == 0 || n < 3 || bufferRx[0] != 'N' || bufferRx[1] != ':') return;
+
+  uint32_t secuencia = strtoul(reinterpret_cast<char*>(bufferRx) + 2, nullptr, 10);
+  if (rx.meta.origen < MAX_NODOS) {
+    Nodo& nodo = nodos[rx.meta.origen];
+    if (nodo.recibidos == 0) nodo.primero = secuencia;
+    nodo.ultimo = secuencia;
+    nodo.recibidos++;
+  }
+
+  if (responder) {
+    static const uint8_t RESPUESTA[] = { 'O', 'N', '\n' };
+    radio.setDestino(rx.meta.origen);
+    radio.enviar(RESPUESTA, sizeof(RESPUESTA));
+  }
+}
+
+void hostAlTerminar() {
+  uint32_t esperados = 0, recibidos = 0;
+  for (uint16_t k = 1; k < MAX_NODOS; ++k) {
+    if (nodos[k].recibidos == 0) continue;
+    esperados += nodos[k].ultimo - nodos[k].primero + 1;
+    recibidos += nodos[k].recibidos;
+  }
+  MedioSim::Estadisticas e = medio.estadisticas(ID_COORDINADOR);
+  float segundos = (millis() - inicio_ms) / 1000.0f;
+  char linea[256];
+  snprintf(linea, sizeof(linea),
+           "coordinador: %lu/%lu paquetes (%.1f %% entrega), %.1f B/s útiles, latencia media %.1f ms\n"
+           "  descartados: perdidos %lu, colisiones %lu, CRC %lu\n",
+           (unsigned long)recibidos, (unsigned long)esperados,
+           esperados ? 100.0f * recibidos / esperados : 0.0f,
+           e.bytesRecibidos / segundos,
+           e.recibidos ? e.latenciaTotal_us / 1000.0 / e.recibidos : 0.0,
+           (unsigned long)e.perdidos, (unsigned long)e.colisiones, (unsigned long)e.errorCrc);
+  Serial.print(linea);
+}
@@ -0,0 +1,88 @@
+/*
+ * Nodo de la red simulada: el mismo ciclo que EmisorUniversal (línea armada en un
+ * buffer fijo, comandos ON/OFF por recibirEn) sobre SimRadio en lugar de LoRa/XBee.
+ *
+ *   SIM_NODO=3 SIM_NODOS=9 SIM_CANAL=0 ./NodoSim
+ * SIM_CANAL: 0 = XBee AT 9600, 7..12 = LoRa SFx a 125 kHz.
+ */
+#include <UniversalRadio.h>
+#include <SimRadio.h>
+
+#define RELAY_PIN 4
+
+const uint16_t ID_COORDINADOR = 0;
+const uint16_t NODO = (uint16_t)hostParametro("SIM_NODO", 1);
+
+PerfilCanal canalElegido() {
+  long sf = hostParametro("SIM_CANAL", 0);
+  return sf ? PerfilCanal::lora((uint8_t)sf) : PerfilCanal::xbee9600();
+}
+
+MedioSim medio(canalElegido(), NODO);
+UniversalRadio<SimRadio> radio(medio, NODO, ID_COORDINADOR);
+
+unsigned long previousMillis = 0;
+const unsigned long INTERVAL_MS = (unsigned long)hostParametro("SIM_PERIODO_MS", 3000);
+uint32_t paquetesEnviados = 0;
+uint32_t comandosRecibidos = 0;
+
+size_t agregarCampo(char* linea, size_t n, const char* clave, float valor, uint8_t decimales) {
+  strcpy(linea + n, clave);
+  n += strlen(clave);
+  dtostrf(valor, 1, decimales, linea + n);
+  return n + strlen(linea + n);
+}
+
+void setup() {
+  pinMode(RELAY_PIN, OUTPUT);
+  Serial.begin(9600);
+  randomSeed(NODO);
+
+  PerfilEnlace enlace;
+  enlace.perdida = hostParametro("SIM_PERDIDA_PPM", 0) / 1e6f;
+  enlace.ber     = hostParametro("SIM_BER_PPB", 0) / 1e9f;
+  medio.setEnlacePorDefecto(enlace);
+  medio.usarUdp((uint16_t)hostParametro("SIM_PUERTO", 47000), (uint16_t)hostParametro("SIM_NODOS", 8));
+
+  if (!radio.iniciar()) {
+    Serial.println("ERROR: no se pudo abrir el puerto UDP del nodo");
+    exit(1);
+  }
+  previousMillis = millis() - random(INTERVAL_MS);   // los nodos no arrancan en fase
+}
+
+void loop() {
+  unsigned long currentMillis = millis();
+
+  if (currentMillis - previousMillis >= INTERVAL_MS) {
+    previousMillis = currentMillis;
+    paquetesEnviados++;
+
+    char linea[64] = "N:";
+    size_t n = strlen(ultoa(paquetesEnviados, linea + 2, 10)) + 2;
+    n = agregarCampo(linea, n, " V:", 127.0f + random(-300, 300) / 100.0f, 2);
+    n = agregarCampo(linea, n, " I:", random(0, 1500) / 100.0f, 2);
+    n = agregarCampo(linea, n, " B:", 3.9f, 2);
+    linea[n++] = '\n';
+    radio.enviar(reinterpret_cast<const uint8_t*>(linea), n);
+  }
+
+  uint8_t comando[16];
+  BufferRx rx(comando);
+  size_t n = radio.recibirEn(rx);
+  while (n > 0 && (comando[n - 1] == '\n' || comando[n - 1] == '\r' || comando[n - 1] == ' ')) n--;
+  if (n > 0) {
+    comandosRecibidos++;
+    if (n == 2 && memcmp(comando, "ON", 2) == 0)       digitalWrite(RELAY_PIN, HIGH);
+    else if (n == 3 && memcmp(comando, "OFF", 3) == 0) digitalWrite(RELAY_PIN, LOW);
+  }
+}
+
+void hostAlTerminar() {
+  MedioSim::Estadisticas e = medio.estadisticas(NODO);
+  char linea[128];
+  snprintf(linea, sizeof(linea), "nodo %u: enviados %lu, aire %.1f s, comandos %lu (perdidos %lu, colisiones %lu)\n",
+           NODO, (unsigned long)e.enviados, e.aire_us / 1e6, (unsigned long)comandosRecibidos,
+           (unsigned long)e.perdidos, (unsigned long)e.colisiones);
+  Serial.print(linea);
+}
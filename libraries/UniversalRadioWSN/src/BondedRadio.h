@@ -0,0 +1,310 @@
+#ifndef BONDED_RADIO_H
+#define BONDED_RADIO_H
+
+#include "RadioInterface.h"
+
+/**
+ * Varios radios del mismo nodo (p. ej. LoRa + XBee) vistos como uno solo.
+ *
+ * Cada enlace lleva una tasa de entrega (EWMA 1/8 de los enviar() confirmados, 0..255),
+ * el RSSI del último paquete recibido por él y un costo de energía en µJ por byte que
+ * da el sketch. enviar() usa el enlace sano más barato por byte *entregado*
+ * (costo·256/entrega, doble si el RSSI está bajo el mínimo) y, si falla, los demás en
+ * orden de costo: el failover es automático. Un enlace enfermo vuelve a probarse una
+ * vez cada reintentoSalud_ms aunque haya otro sano (así puede recuperarse).
+ * enviarCritico() manda el mismo frame por todos los enlaces sanos.
+ *
+ * Radios sin ACK de enlace (confirmaEntrega() == false: XBee AT, LoRa) devuelven true
+ * aunque nadie reciba, así que su true no cuenta como entrega: su tasa solo la mueven
+ * notificarResultado() (TX Status, ACK de aplicación, ...) y los fallos locales de
+ * enviar(). Con umbralSalud 128, seis pérdidas notificadas seguidas lo enferman.
+ *
+ * Formato en aire: [0xBD][nodo][secuencia][datos]. XBee AT corta lo recibido en cada
+ * '\n', así que la secuencia salta 0x0A, un nodo 0x0A se rechaza (enviar() devuelve
+ * false) y los datos solo pueden llevar '\n' al final. Del lado del coordinador otra
+ * BondedRadio con los mismos radios quita la cabecera y descarta la copia que llega
+ * por el segundo enlace (ventana de 8 secuencias por nodo; si un nodo se reinicia,
+ * sus primeros frames pueden caer como duplicados hasta que la secuencia se aleje
+ * 8 posiciones). Los frames sin la marca (líneas ASCII, CodecWSN con SOF 0xAA)
+ * pasan sin tocar.
+ */
+template <uint8_t N_ENLACES = 2, uint8_t MAX_BYTES = 64>
+class BondedRadio : public RadioInterface {
+  static_assert(N_ENLACES >= 1 && N_ENLACES <= 8, "BondedRadio: de 1 a 8 enlaces");
+public:
+  static const uint8_t MARCA        = 0xBD;
+  static const uint8_t CABECERA     = 3;
+  static const uint8_t MAX_NODOS    = 16;
+  static const uint8_t SIN_ENLACE   = 0xFF;
+
+  struct Cfg {
+    uint8_t  nodo              = 0;      // va en la cabecera: clave de deduplicación (no 0x0A)
+    uint8_t  umbralSalud       = 128;    // entrega mínima (0..255) para considerar sano un enlace
+    int16_t  rssiMinimo_dBm    = -110;   // por debajo, el enlace cuesta el doble
+    uint32_t reintentoSalud_ms = 60000;  // cada cuánto se vuelve a probar un enlace enfermo
+  };
+
+  struct Enlace {
+    RadioInterface* radio;
+    uint16_t costo_uJ_por_byte;
+    uint8_t  entrega;        // EWMA 0..255
+    int16_t  rssi_dBm;       // 0 = sin dato
+    uint32_t ultimoIntento_ms;
+    uint16_t enviados, fallidos;
+  };
+
+  BondedRadio() {}
+  explicit BondedRadio(const Cfg& cfg) : _cfg(cfg) {}
+
+  void configurar(const Cfg& cfg) { _cfg = cfg; }
+
+  /* Agrega un radio; devuelve su índice o SIN_ENLACE si no cabe. Entra con entrega plena. */
+  uint8_t agregarEnlace(RadioInterface* radio, uint16_t costo_uJ_por_byte) {
+    if (_n == N_ENLACES || radio == nullptr) return SIN_ENLACE;
+    _enlaces[_n] = { radio, costo_uJ_por_byte, 255, 0, 0, 0, 0 };
+    return _n++;
+  }
+
+  // --- RadioInterface ---
+
+  bool iniciar() override {
+    bool alguno = false;
+    for (uint8_t k = 0; k < _n; ++k) {
+      bool ok = _enlaces[k].radio->iniciar();
+      if (!ok) _enlaces[k].entrega = 0;     // arranca enfermo; se reintentará por salud
+      alguno |= ok;
+    }
+    return alguno;
+  }
+
+  bool enviar(const uint8_t* buffer, size_t longitud) override {
+    return enviar(nullptr, 0, buffer, longitud);
+  }
+
+  bool enviar(const uint8_t* cabecera, size_t longCabecera,
+              const uint8_t* datos, size_t longDatos) override {
+    uint8_t frame[MAX_BYTES];
+    size_t n = armar(frame, cabecera, longCabecera, datos, longDatos);
+    if (n == 0) return false;
+
+    uint8_t orden[N_ENLACES];
+    uint8_t m = ordenarPorCosto(orden, n);
+    uint32_t ahora = millis();
+    uint8_t intentados = 0;                    // bit k = el enlace k ya se probó en esta llamada
+    for (uint8_t i = 0; i < m; ++i) {
+      uint8_t k = orden[i];
+      if (!sano(k) && !tocaReintento(k, ahora)) continue;   // enfermo: solo por turno de salud
+      intentados |= (uint8_t)(1u << k);
+      if (intentar(k, frame, n, ahora)) return true;
+    }
+    // Todos los sanos fallaron: última oportunidad para los enfermos saltados
+    for (uint8_t i = 0; i < m; ++i) {
+      uint8_t k = orden[i];
+      if (!(intentados & (1u << k)) && intentar(k, frame, n, ahora)) return true;
+    }
+    return false;
+  }
+
+  /* Mismo frame (misma secuencia) por todos los enlaces sanos; true si alguno confirmó. */
+  bool enviarCritico(const uint8_t* datos, size_t longDatos) {
+    uint8_t frame[MAX_BYTES];
+    size_t n = armar(frame, nullptr, 0, datos, longDatos);
+    if (n == 0) return false;
+    uint32_t ahora = millis();
+    bool alguno = false, intentado = false;
+    for (uint8_t k = 0; k < _n; ++k) {
+      if (!sano(k)) continue;
+      alguno |= intentar(k, frame, n, ahora);
+      intentado = true;
+    }
+    if (!intentado)                            // ninguno sano: mejor todos que ninguno
+      for (uint8_t k = 0; k < _n; ++k) alguno |= intentar(k, frame, n, ahora);
+    return alguno;
+  }
+
+  int hayDatosDisponibles() override {
+    if (_pendiente > 0) return _pendiente;
+    for (uint8_t i = 0; i < _n; ++i) {
+      uint8_t k = _turnoRx;
+      _turnoRx = (uint8_t)((_turnoRx + 1) % _n);  // round-robin: un enlace ruidoso no tapa al otro
+      BufferRx rx(_rx, sizeof(_rx));
+      if (_enlaces[k].radio->recibirEn(rx) == 0) continue;
+      if (rx.meta.rssi_dBm != 0) _enlaces[k].rssi_dBm = rx.meta.rssi_dBm;
+      if (!aceptar(rx)) { ++_duplicados; continue; }
+      _meta = rx.meta;
+      _enlaceRx = k;
+      return _pendiente;
+    }
+    return 0;
+  }
+
+  size_t leer(uint8_t* buffer, size_t maxLongitud) override {
+    if (hayDatosDisponibles() <= 0) return 0;
+    size_t n = min((size_t)_pendiente, maxLongitud);
+    memcpy(buffer, _rx + _inicio, n);
+    _pendiente = 0;
+    return n;
+  }
+
+  size_t recibirEn(BufferRx& buffer) override {
+    buffer.longitud = 0;
+    if (hayDatosDisponibles() <= 0) return 0;
+    buffer.meta = _meta;
+    buffer.longitud = leer(buffer.datos, buffer.capacidad);
+    return buffer.longitud;
+  }
+
+  int obtenerRSSI() override { return _enlaceRx == SIN_ENLACE ? 0 : _enlaces[_enlaceRx].rssi_dBm; }
+
+  /* Suma de los contadores de todos los enlaces; RSSI/SNR del último que recibió. */
+  const LinkStats& estadisticasEnlace() const override {
+    _resumen = (_enlaceRx == SIN_ENLACE) ? LinkStats() : _enlaces[_enlaceRx].radio->estadisticasEnlace();
+    _resumen.aireTx_ms = _resumen.enviados = _resumen.fallosTx = _resumen.reintentos = 0;
+    _resumen.recibidos = _resumen.errorCrc = _resumen.descartesCola = 0;
+    for (uint8_t k = 0; k < _n; ++k) {
+      const LinkStats& s = _enlaces[k].radio->estadisticasEnlace();
+      _resumen.aireTx_ms     += s.aireTx_ms;
+      _resumen.enviados      += s.enviados;
+      _resumen.fallosTx      += s.fallosTx;
+      _resumen.reintentos    += s.reintentos;
+      _resumen.recibidos     += s.recibidos;
+      _resumen.errorCrc      += s.errorCrc;
+      _resumen.descartesCola += s.descartesCola;
+    }
+    return _resumen;
+  }
+
+  bool dormir() override {
+    bool ok = true;
+    for (uint8_t k = 0; k < _n; ++k) ok &= _enlaces[k].radio->dormir();
+    return ok;
+  }
+
+  bool despertar() override {
+    bool ok = true;
+    for (uint8_t k = 0; k < _n; ++k) ok &= _enlaces[k].radio->despertar();
+    return ok;
+  }
+
+  /* Solo si todos los enlaces tienen ACK: si no, el true pudo venir de uno sin él. */
+  bool confirmaEntrega() const override {
+    for (uint8_t k = 0; k < _n; ++k) if (!_enlaces[k].radio->confirmaEntrega()) return false;
+    return _n > 0;
+  }
+
+  // --- Puntaje y estado ---
+
+  /* Resultado confirmado por fuera (TX Status, ACK de aplicación) para el último enlace usado. */
+  void notificarResultado(uint8_t enlace, bool ok) {
+    if (enlace < _n) actualizarEntrega(_enlaces[enlace], ok);
+  }
+
+  bool sano(uint8_t k) const { return _enlaces[k].entrega >= _cfg.umbralSalud; }
+
+  /* µJ esperados por frame entregado de n bytes (0xFFFFFFFF si la entrega es 0). */
+  uint32_t costoEsperado(uint8_t k, size_t n) const {
+    const Enlace& e = _enlaces[k];
+    if (e.entrega == 0) return 0xFFFFFFFFUL;
+    uint32_t costo = (uint32_t)e.costo_uJ_por_byte * n * 256UL / e.entrega;
+    if (e.rssi_dBm != 0 && e.rssi_dBm < _cfg.rssiMinimo_dBm) costo *= 2;
+    return costo;
+  }
+
+  uint8_t       enlaces() const              { return _n; }
+  const Enlace& enlace(uint8_t k) const      { return _enlaces[k]; }
+  uint8_t       ultimoEnlaceTx() const       { return _enlaceTx; }
+  uint8_t       ultimoEnlaceRx() const       { return _enlaceRx; }
+  uint8_t       secuencia() const            { return _secuencia; }
+  uint16_t      duplicados() const           { return _duplicados; }
+
+private:
+  struct Ventana { uint8_t nodo, ultima, vistos; bool usada; };  // vistos: bit i = ultima - i
+
+  Cfg      _cfg;
+  Enlace   _enlaces[N_ENLACES];
+  uint8_t  _n = 0, _secuencia = 0, _turnoRx = 0;
+  uint8_t  _enlaceTx = SIN_ENLACE, _enlaceRx = SIN_ENLACE;
+  uint8_t  _rx[MAX_BYTES];
+  uint8_t  _pendiente = 0, _inicio = 0;
+  MetaRx   _meta;
+  Ventana  _ventanas[MAX_NODOS] = {};
+  uint16_t _duplicados = 0;
+  mutable LinkStats _resumen;   // lo arma estadisticasEnlace() sin heap
+
+  size_t armar(uint8_t* frame, const uint8_t* cabecera, size_t lc, const uint8_t* datos, size_t ld) {
+    if (_n == 0 || _cfg.nodo == '\n' || CABECERA + lc + ld > MAX_BYTES) return 0;
+    if (++_secuencia == '\n') ++_secuencia;   // un 0x0A partiría el frame en XBee AT
+    frame[0] = MARCA;
+    frame[1] = _cfg.nodo;
+    frame[2] = _secuencia;
+    if (lc) memcpy(frame + CABECERA, cabecera, lc);
+    memcpy(frame + CABECERA + lc, datos, ld);
+    return CABECERA + lc + ld;
+  }
+
+  // Ordena por costo esperado (inserción: N_ENLACES es 2 o 3)
+  uint8_t ordenarPorCosto(uint8_t* orden, size_t n) const {
+    for (uint8_t k = 0; k < _n; ++k) {
+      uint8_t j = k;
+      while (j > 0 && costoEsperado(orden[j - 1], n) > costoEsperado(k, n)) { orden[j] = orden[j - 1]; --j; }
+      orden[j] = k;
+    }
+    return _n;
+  }
+
+  bool tocaReintento(uint8_t k, uint32_t ahora) const {
+    return ahora - _enlaces[k].ultimoIntento_ms >= _cfg.reintentoSalud_ms;
+  }
+
+  bool intentar(uint8_t k, const uint8_t* frame, size_t n, uint32_t ahora) {
+    Enlace& e = _enlaces[k];
+    e.ultimoIntento_ms = ahora;
+    bool ok = e.radio->enviar(frame, n);
+    if (!ok || e.radio->confirmaEntrega()) actualizarEntrega(e, ok);   // un true sin ACK no dice nada
+    if (ok) { ++e.enviados; _enlaceTx = k; } else ++e.fallidos;
+    return ok;
+  }
+
+  static void actualizarEntrega(Enlace& e, bool ok) {
+    int16_t objetivo = ok ? 255 : 0;
+    e.entrega = (uint8_t)(e.entrega + (objetivo - (int16_t)e.entrega) / 8);
+    if (ok && e.entrega > 247) e.entrega = 255;   // la división trunca: sin esto nunca vuelve a 255
+  }
+
+  // Quita la cabecera y filtra duplicados; deja _inicio/_pendiente listos
+  bool aceptar(const BufferRx& rx) {
+    if (rx.longitud < CABECERA || _rx[0] != MARCA) {
+      _inicio = 0;
+      _pendiente = (uint8_t)rx.longitud;
+      return true;
+    }
+    if (esDuplicado(_rx[1], _rx[2])) return false;
+    _inicio = CABECERA;
+    _pendiente = (uint8_t)(rx.longitud - CABECERA);
+    return _pendiente > 0;
+  }
+
+  bool esDuplicado(uint8_t nodo, uint8_t seq) {
+    Ventana* v = nullptr;
+    for (uint8_t i = 0; i < MAX_NODOS; ++i) {
+      if (_ventanas[i].usada && _ventanas[i].nodo == nodo) { v = &_ventanas[i]; break; }
+      if (!_ventanas[i].usada && v == nullptr) v = &_ventanas[i];
+    }
+    if (v == nullptr) return false;            // tabla llena: sin deduplicar antes que perder datos
+    if (!v->usada) { *v = { nodo, seq, 1, true }; return false; }
+
+    int8_t d = (int8_t)(seq - v->ultima);
+    if (d > 0) {                               // más nueva: corre la ventana
+      v->vistos = (d >= 8) ? 1 : (uint8_t)((v->vistos << d) | 1);
+      v->ultima = seq;
+      return false;
+    }
+    if (d <= -8) return false;                 // muy vieja (¿el nodo se reinició?): se acepta
+    uint8_t bit = (uint8_t)(1u << (-d));
+    if (v->vistos & bit) return true;
+    v->vistos |= bit;
+    return false;
+  }
+};
+
+#endif
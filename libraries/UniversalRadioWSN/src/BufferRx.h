@@ -0,0 +1,29 @@
+#ifndef BUFFER_RX_H
+#define BUFFER_RX_H
+
+#include <Arduino.h>
+
+// Metadatos del último paquete recibido con recibirEn()
+struct MetaRx {
+  int16_t  rssi_dBm         = 0;  // 0 si el radio no lo reporta
+  int8_t   snr_cuartos_dB   = 0;  // SNR en cuartos de dB (registro del SX127x), 0 si no aplica
+  uint32_t llegada_ms       = 0;  // millis() al sacar el paquete del radio
+  size_t   longitudOriginal = 0;  // tamaño del paquete en el aire; > longitud si no cupo
+  uint16_t origen           = 0;  // dirección del emisor; 0 si el radio no direcciona
+};
+
+// Vista sobre un buffer del llamador: el radio escribe ahí directamente, sin String ni heap
+struct BufferRx {
+  uint8_t* datos;
+  size_t   capacidad;
+  size_t   longitud = 0;
+  MetaRx   meta;
+
+  BufferRx(uint8_t* d, size_t cap) : datos(d), capacidad(cap) {}
+  template <size_t N>
+  explicit BufferRx(uint8_t (&arreglo)[N]) : datos(arreglo), capacidad(N) {}
+
+  bool truncado() const { return meta.longitudOriginal > longitud; }
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef LINK_STATS_H
+#define LINK_STATS_H
+
+#include <Arduino.h>
+
+/**
+ * Calidad del enlace de un radio, acumulada desde iniciar(). Cada backend la llena con
+ * lo que su hardware reporta (lo que no reporta queda en 0) y se lee por referencia
+ * const con estadisticasEnlace(): sin copias ni heap, apta para telemetría y para
+ * políticas adaptativas. Promedios: EWMA 1/8 con 3 bits de fracción.
+ */
+struct LinkStats {
+  int16_t  rssiUltimo_dBm          = 0;
+  int16_t  rssiPromedio_dBm        = 0;
+  int8_t   snrUltimo_cuartos_dB    = 0;
+  int8_t   snrPromedio_cuartos_dB  = 0;
+  uint32_t aireTx_ms               = 0;   // tiempo en aire (o en el UART) de todo lo enviado
+  uint32_t enviados                = 0;   // TX confirmados (o aceptados, si el radio no tiene ACK)
+  uint32_t fallosTx                = 0;   // sin ACK, timeout o rechazados por el radio
+  uint32_t reintentos              = 0;   // retransmisiones del MAC/ARQ
+  uint32_t recibidos               = 0;
+  uint32_t errorCrc                = 0;   // paquetes recibidos con CRC/checksum malo
+  uint32_t descartesCola           = 0;   // no cupieron en una cola de TX o RX
+
+  void registrarRx(int16_t rssi_dBm, int8_t snr_cuartos_dB = 0) {
+    rssiUltimo_dBm       = rssi_dBm;
+    snrUltimo_cuartos_dB = snr_cuartos_dB;
+    if (recibidos++ == 0) {
+      _rssi8 = (int16_t)(rssi_dBm * 8);
+      _snr8  = (int16_t)(snr_cuartos_dB * 8);
+    } else {
+      _rssi8 = (int16_t)(_rssi8 + rssi_dBm - _rssi8 / 8);
+      _snr8  = (int16_t)(_snr8 + snr_cuartos_dB - _snr8 / 8);
+    }
+    rssiPromedio_dBm       = (int16_t)(_rssi8 / 8);
+    snrPromedio_cuartos_dB = (int8_t)(_snr8 / 8);
+  }
+
+  void registrarTx(bool ok, uint32_t aire_us, uint8_t retransmisiones = 0) {
+    if (ok) ++enviados; else ++fallosTx;
+    reintentos += retransmisiones;
+    sumarAire(aire_us);
+  }
+
+  // Acumula en ms sin perder los µs sueltos de cada paquete
+  void sumarAire(uint32_t aire_us) {
+    _restoAire_us += aire_us;
+    aireTx_ms     += _restoAire_us / 1000;
+    _restoAire_us %= 1000;
+  }
+
+  // Para radios sin ACK: fracción de TX aceptados (0..255)
+  uint8_t entrega() const {
+    uint32_t total = enviados + fallosTx;
+    return total ? (uint8_t)(enviados * 255UL / total) : 255;
+  }
+
+  void reiniciar() { *this = LinkStats(); }
+
+private:
+  int16_t  _rssi8 = 0, _snr8 = 0;
+  uint32_t _restoAire_us = 0;
+};
+
+#endif
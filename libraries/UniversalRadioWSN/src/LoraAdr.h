@@ -0,0 +1,250 @@
+#ifndef LORA_ADR_H
+#define LORA_ADR_H
+
+#include "LoraRadio.h"
+
+/**
+ * ADR (adaptive data rate) dirigido por el coordinador, al estilo LoRaWAN pero sin la pila:
+ *
+ *   subida   [nodo][sec alta][sec baja][perfil] + datos     (AdrNodo::enviar)
+ *   bajada   [0xAC][nodo]                  ACK              (AdrCoordinador::respuesta)
+ *            [0xAD][nodo][perfil]          ACK + nuevo SF/potencia
+ *
+ * El coordinador junta VENTANA subidas por nodo, toma el mejor SNR y calcula el margen
+ * sobre el SNR que exige el SF (-7.5 dB en SF7, 2.5 dB menos por SF) menos un margen de
+ * instalación. Cada 3 dB de sobra baja un SF (menos tiempo en aire) y, ya en sfMin,
+ * baja la potencia; si falta margen o la entrega (huecos en la secuencia) cae bajo el
+ * objetivo, sube la potencia y después el SF. El comando se repite en cada ACK hasta
+ * que el nodo reporta el perfil nuevo en su cabecera.
+ * El nodo aplica el perfil con LoraBackend::setPerfil() y, si pasan acksPerdidosMax
+ * subidas sin ninguna bajada, vuelve solo al perfil seguro (SF base, potencia máxima).
+ *
+ * Un coordinador SX127x solo demodula su propio SF: con él, sfMin = sfMax = ese SF y el
+ * ADR ajusta solo la potencia. Variar el SF requiere un concentrador multi-SF (SX130x).
+ */
+const uint8_t ADR_ACK         = 0xAC;
+const uint8_t ADR_COMANDO     = 0xAD;
+const uint8_t ADR_CABECERA    = 4;   // bytes que AdrNodo antepone a cada subida
+const uint8_t ADR_MAX_BAJADA  = 3;
+
+// SF (6..12) en los 3 bits altos, potencia (0..31 dBm) en los 5 bajos
+struct PerfilLora {
+  uint8_t sf;
+  int8_t  potencia_dBm;
+
+  uint8_t codificar() const { return (uint8_t)(((sf - 6) << 5) | (potencia_dBm & 0x1F)); }
+  static PerfilLora decodificar(uint8_t b) {
+    PerfilLora p = { (uint8_t)((b >> 5) + 6), (int8_t)(b & 0x1F) };
+    return p;
+  }
+  bool operator==(const PerfilLora& o) const { return sf == o.sf && potencia_dBm == o.potencia_dBm; }
+  bool operator!=(const PerfilLora& o) const { return !(*this == o); }
+};
+
+// SNR mínimo de demodulación del SX127x en cuartos de dB (SF7 = -7.5 dB ... SF12 = -20 dB)
+constexpr int16_t loraSnrRequerido_cuartos(uint8_t sf) {
+  return (int16_t)(-30 - 10 * ((int16_t)sf - 7));
+}
+
+// ================================== NODO ===================================
+
+class AdrNodo {
+public:
+  struct Cfg {
+    uint8_t nodo               = 1;
+    uint8_t sfSeguro           = 0;    // 0 = el SF del LoRaConfig (el que escucha el coordinador)
+    int8_t  potenciaSegura_dBm = 20;
+    uint8_t acksPerdidosMax    = 8;    // subidas seguidas sin bajada antes de volver al perfil seguro
+  };
+
+  explicit AdrNodo(LoraBackend& radio) : _radio(radio) {}
+
+  void begin(const Cfg& cfg) {
+    _cfg = cfg;
+    _seguro.sf           = cfg.sfSeguro ? cfg.sfSeguro : _radio.spreadingFactor();
+    _seguro.potencia_dBm = cfg.potenciaSegura_dBm;
+    _sinAck = 0;
+  }
+
+  /* Antepone la cabecera ADR y envía; antes aplica el perfil seguro si el enlace se perdió. */
+  bool enviar(const uint8_t* datos, size_t longitud) {
+    uint8_t cabecera[ADR_CABECERA];
+    prepararCabecera(cabecera);
+    return _radio.enviar(cabecera, sizeof(cabecera), datos, longitud);
+  }
+
+  /* Para quien arma la trama por su cuenta (LoraTxAsincrono, etc.): llena ADR_CABECERA bytes. */
+  void prepararCabecera(uint8_t* cabecera) {
+    if (_sinAck >= _cfg.acksPerdidosMax) {
+      if (perfil() != _seguro) {
+        _radio.setPerfil(_seguro.sf, _seguro.potencia_dBm);
+        ++_caidas;
+      }
+      _sinAck = 0;
+    }
+    ++_secuencia;
+    cabecera[0] = _cfg.nodo;
+    cabecera[1] = (uint8_t)(_secuencia >> 8);
+    cabecera[2] = (uint8_t)_secuencia;
+    cabecera[3] = perfil().codificar();
+    if (_sinAck < 0xFF) ++_sinAck;
+  }
+
+  /* Pasa aquí cada bajada; true si era un ACK/comando para este nodo (ya aplicado). */
+  bool procesar(const uint8_t* datos, size_t longitud) {
+    if (longitud < 2 || datos[1] != _cfg.nodo) return false;
+    if (datos[0] == ADR_COMANDO && longitud >= 3) {
+      PerfilLora p = PerfilLora::decodificar(datos[2]);
+      if (p != perfil()) _radio.setPerfil(p.sf, p.potencia_dBm);
+    } else if (datos[0] != ADR_ACK) {
+      return false;
+    }
+    _sinAck = 0;
+    return true;
+  }
+
+  PerfilLora perfil() const {
+    PerfilLora p = { _radio.spreadingFactor(), _radio.potencia_dBm() };
+    return p;
+  }
+  PerfilLora perfilSeguro() const { return _seguro; }
+  uint8_t    sinAck() const       { return _sinAck; }
+  uint16_t   caidas() const       { return _caidas; }   // veces que volvió al perfil seguro
+  uint16_t   secuencia() const    { return _secuencia; }
+
+private:
+  LoraBackend& _radio;
+  Cfg          _cfg;
+  PerfilLora   _seguro = { 7, 20 };
+  uint16_t     _secuencia = 0, _caidas = 0;
+  uint8_t      _sinAck = 0;
+};
+
+// =============================== COORDINADOR ===============================
+
+template <uint8_t MAX_NODOS = 16, uint8_t VENTANA = 20>
+class AdrCoordinador {
+public:
+  struct Cfg {
+    uint8_t margen_dB       = 10;    // margen de instalación sobre el SNR requerido
+    uint8_t sfMin           = 7;
+    uint8_t sfMax           = 12;
+    int8_t  potenciaMin_dBm = 2;
+    int8_t  potenciaMax_dBm = 20;
+    uint8_t pasoPotencia_dB = 3;
+    uint8_t entregaObjetivo = 230;   // 0..255 (230 ≈ 90 %): por debajo, el enlace se refuerza
+  };
+
+  struct Nodo {
+    uint8_t    id;
+    PerfilLora actual;        // el que reporta el nodo
+    PerfilLora objetivo;      // el que se le ordena
+    int16_t    snrMax_cuartos;
+    uint16_t   ultimaSecuencia;
+    uint8_t    paquetes;      // recibidos en la ventana
+    uint16_t   perdidos;      // huecos de secuencia en la ventana
+    uint8_t    entrega;       // de la última ventana cerrada (0..255)
+    bool       nuevo;         // aún no reporta su perfil
+  };
+
+  void begin(const Cfg& cfg) {
+    _cfg = cfg;
+    _nNodos = 0;
+  }
+
+  /**
+   * Registra una subida con cabecera ADR y el SNR con que llegó (BufferRx::meta).
+   * Devuelve el id del nodo, o -1 si la trama no trae cabecera o la tabla está llena.
+   */
+  int16_t registrar(const uint8_t* trama, size_t longitud, int8_t snr_cuartos_dB) {
+    if (longitud < ADR_CABECERA) return -1;
+    Nodo* n = buscar(trama[0]);
+    if (!n) return -1;
+    uint16_t secuencia = (uint16_t)((trama[1] << 8) | trama[2]);
+    PerfilLora reportado = PerfilLora::decodificar(trama[3]);
+
+    if (n->nuevo) {
+      n->actual = n->objetivo = reportado;
+      n->nuevo  = false;
+    } else if (reportado != n->actual) {
+      // aplicó un comando o volvió solo al perfil seguro: el SNR viejo ya no sirve
+      n->actual = reportado;
+      if (reportado != n->objetivo) n->objetivo = reportado;
+      reiniciarVentana(*n);
+    } else {
+      uint16_t salto = (uint16_t)(secuencia - n->ultimaSecuencia);
+      if (salto == 0) return n->id;                       // duplicado
+      if (salto < 256) n->perdidos = (uint16_t)(n->perdidos + salto - 1);   // mayor: el nodo se reinició
+    }
+    n->ultimaSecuencia = secuencia;
+    if (snr_cuartos_dB > n->snrMax_cuartos) n->snrMax_cuartos = snr_cuartos_dB;
+    if (++n->paquetes >= VENTANA) decidir(*n);
+    return n->id;
+  }
+
+  /* ACK para el nodo, con comando de perfil si hay uno pendiente; devuelve los bytes (2 o 3). */
+  size_t respuesta(uint8_t id, uint8_t* destino) {
+    Nodo* n = buscar(id);
+    destino[1] = id;
+    if (n && n->objetivo != n->actual) {
+      destino[0] = ADR_COMANDO;
+      destino[2] = n->objetivo.codificar();
+      return 3;
+    }
+    destino[0] = ADR_ACK;
+    return 2;
+  }
+
+  const Nodo* nodo(uint8_t id) const {
+    for (uint8_t i = 0; i < _nNodos; ++i)
+      if (_nodos[i].id == id) return &_nodos[i];
+    return nullptr;
+  }
+  uint8_t nodos() const { return _nNodos; }
+
+private:
+  static const int16_t SIN_SNR = -32768;
+
+  Cfg     _cfg;
+  Nodo    _nodos[MAX_NODOS];
+  uint8_t _nNodos = 0;
+
+  Nodo* buscar(uint8_t id) {
+    for (uint8_t i = 0; i < _nNodos; ++i)
+      if (_nodos[i].id == id) return &_nodos[i];
+    if (_nNodos >= MAX_NODOS) return nullptr;
+    Nodo& n = _nodos[_nNodos++];
+    n.id      = id;
+    n.entrega = 255;
+    n.nuevo   = true;
+    reiniciarVentana(n);
+    return &n;
+  }
+
+  static void reiniciarVentana(Nodo& n) {
+    n.snrMax_cuartos = SIN_SNR;
+    n.paquetes       = 0;
+    n.perdidos       = 0;
+  }
+
+  void decidir(Nodo& n) {
+    n.entrega = (uint8_t)((uint32_t)n.paquetes * 255UL / ((uint32_t)n.paquetes + n.perdidos));
+    int16_t margen = (int16_t)(n.snrMax_cuartos - loraSnrRequerido_cuartos(n.actual.sf) - _cfg.margen_dB * 4);
+    int8_t  pasos  = (int8_t)constrain(margen / 12, -8, 8);   // 12 cuartos = 3 dB por paso
+    if (n.entrega < _cfg.entregaObjetivo && pasos >= 0) pasos = -1;
+
+    PerfilLora p = n.actual;
+    p.sf = constrain(p.sf, _cfg.sfMin, _cfg.sfMax);
+    for (; pasos > 0 && p.sf > _cfg.sfMin; --pasos) --p.sf;
+    for (; pasos > 0 && p.potencia_dBm - _cfg.pasoPotencia_dB >= _cfg.potenciaMin_dBm; --pasos)
+      p.potencia_dBm = (int8_t)(p.potencia_dBm - _cfg.pasoPotencia_dB);
+    for (; pasos < 0 && p.potencia_dBm < _cfg.potenciaMax_dBm; ++pasos)
+      p.potencia_dBm = (int8_t)min(p.potencia_dBm + _cfg.pasoPotencia_dB, (int)_cfg.potenciaMax_dBm);
+    for (; pasos < 0 && p.sf < _cfg.sfMax; ++pasos) ++p.sf;
+
+    n.objetivo = p;
+    reiniciarVentana(n);
+  }
+};
+
+#endif
@@ -2,7 +2,9 @@
 #define LORA_RADIO_H
 
 #include <LoRa.h>
-#include "RadioInterface.h"
+#include "RadioBase.h"
+#include "RadioAdaptador.h"
+#include "LoraTiempoAire.h"
 
 // Estructura para pasar la configuración de forma ordenada
 struct LoRaConfig {
@@ -17,15 +19,109 @@ struct LoRaConfig {
   int irqPin;
 };
 
-class LoraRadio : public RadioInterface {
+// Tiempo en aire con la configuración del nodo; constexpr si config lo es:
+//   constexpr LoRaConfig cfg = {...};
+//   static_assert(loraTiempoEnAire_us(cfg, 20) < 400000UL, "20 bytes no caben en 400 ms");
+constexpr uint32_t loraTiempoEnAire_us(const LoRaConfig& config, size_t n) {
+  return loraTiempoEnAire_us(n, (uint8_t)config.spreadingFactor, (uint32_t)config.signalBandwidth,
+                             (uint8_t)config.codingRate);
+}
+
+// Qué hace enviar() cuando el ciclo de trabajo no alcanza
+enum PoliticaCiclo {
+  CICLO_RECHAZAR,   // devuelve false
+  CICLO_DIFERIR,    // guarda un paquete y lo manda atender() cuando haya fichas
+  CICLO_FUSIONAR    // junta los siguientes en un solo paquete: un preámbulo y cabecera para todos
+};
+
+#ifndef LORA_WSN_MAX_DIFERIDO
+  #define LORA_WSN_MAX_DIFERIDO 64   // bytes guardados mientras el ciclo de trabajo no alcanza
+#endif
+
+// Lectura en ráfaga del FIFO (registro 0x00) directo al destino: una sola transacción SPI.
+// El puntero del FIFO ya lo dejó parsePacket()/handleDio0Rise() al inicio del paquete.
+inline void loraLeerFifo(int csPin, uint8_t* destino, size_t n) {
+  memset(destino, 0, n);
+  LORA_DEFAULT_SPI.beginTransaction(SPISettings(LORA_DEFAULT_SPI_FREQUENCY, MSBFIRST, SPI_MODE0));
+  digitalWrite(csPin, LOW);
+  LORA_DEFAULT_SPI.transfer(0x00);
+  LORA_DEFAULT_SPI.transfer(destino, n);
+  digitalWrite(csPin, HIGH);
+  LORA_DEFAULT_SPI.endTransaction();
+}
+
+// Lectura de un registro del SX127x (bit 7 en 0 = lectura)
+inline uint8_t loraLeerRegistro(int csPin, uint8_t registro) {
+  LORA_DEFAULT_SPI.beginTransaction(SPISettings(LORA_DEFAULT_SPI_FREQUENCY, MSBFIRST, SPI_MODE0));
+  digitalWrite(csPin, LOW);
+  LORA_DEFAULT_SPI.transfer(registro & 0x7F);
+  uint8_t valor = LORA_DEFAULT_SPI.transfer(0x00);
+  digitalWrite(csPin, HIGH);
+  LORA_DEFAULT_SPI.endTransaction();
+  return valor;
+}
+
+const uint8_t LORA_REG_IRQ_FLAGS   = 0x12;
+const uint8_t LORA_REG_PKT_SNR     = 0x19;   // SNR del último paquete en cuartos de dB (con signo)
+const uint8_t LORA_IRQ_RX_DONE     = 0x40;
+const uint8_t LORA_IRQ_CRC_ERROR   = 0x20;
+
+// Implementación sin virtuales; la usan UniversalRadio<LoraRadio> y LoraRadio
+class LoraBackend : public RadioBase<LoraBackend> {
 private:
-  LoRaConfig _config;
+  LoRaConfig    _config;
+  int           _pendiente = 0;   // bytes del paquete que parsePacket() anunció y aún no se leen
+  CicloTrabajo  _ciclo;
+  PoliticaCiclo _politica = CICLO_DIFERIR;
+  uint8_t       _diferido[LORA_WSN_MAX_DIFERIDO];
+  uint8_t       _nDiferido = 0;
+  uint32_t    (*_reloj)() = relojMillis;
+
+  static uint32_t relojMillis() { return millis(); }
+
+  bool transmitir(const uint8_t* cabecera, size_t longCabecera, const uint8_t* datos, size_t longDatos) {
+    if (!LoRa.beginPacket()) {
+      _stats.registrarTx(false, 0);
+      return false;
+    }
+    if (longCabecera) LoRa.write(cabecera, longCabecera);
+    LoRa.write(datos, longDatos);
+    LoRa.endPacket();
+    uint32_t aire = tiempoEnAire_us(longCabecera + longDatos);
+    _ciclo.consumir(aire);
+    _stats.registrarTx(true, aire);
+    return true;
+  }
+
+  void atenderA(uint32_t ahora_ms) {
+    if (_nDiferido == 0 || !_ciclo.alcanza(tiempoEnAire_us(_nDiferido), ahora_ms)) return;
+    uint8_t n = _nDiferido;
+    _nDiferido = 0;
+    transmitir(nullptr, 0, _diferido, n);
+  }
+
+  bool diferir(const uint8_t* cabecera, size_t longCabecera, const uint8_t* datos, size_t longDatos) {
+    size_t n = longCabecera + longDatos;
+    bool cabe = (_politica == CICLO_DIFERIR)  ? (_nDiferido == 0 && n <= sizeof(_diferido))
+              : (_politica == CICLO_FUSIONAR) ? (_nDiferido + n <= sizeof(_diferido))
+              : false;
+    if (!cabe) {
+      ++_stats.descartesCola;
+      return false;
+    }
+    if (longCabecera) memcpy(_diferido + _nDiferido, cabecera, longCabecera);
+    memcpy(_diferido + _nDiferido + longCabecera, datos, longDatos);
+    _nDiferido = (uint8_t)(_nDiferido + n);
+    return true;
+  }
 
 public:
+  using RadioBase<LoraBackend>::enviar;
+
   // El constructor ahora recibe el objeto de configuración
-  LoraRadio(const LoRaConfig& config) : _config(config) {}
+  LoraBackend(const LoRaConfig& config) : _config(config) {}
 
-  bool iniciar() override {
+  bool iniciar() {
     LoRa.setPins(_config.csPin, _config.resetPin, _config.irqPin);
     if (!LoRa.begin(_config.frequency)) {
       return false;
@@ -38,41 +134,117 @@ public:
     return true;
   }
 
-  bool enviar(const uint8_t* buffer, size_t longitud) override {
-    if (LoRa.beginPacket()) {
-      LoRa.write(buffer, longitud);
-      LoRa.endPacket();
-      return true;
+  bool enviar(const uint8_t* buffer, size_t longitud) {
+    return enviar(nullptr, 0, buffer, longitud);
+  }
+
+  // Scatter-gather: los dos segmentos van al FIFO uno tras otro, sin buffer intermedio.
+  // Con ciclo de trabajo activo y sin fichas, aplica la política (true = aceptado/diferido).
+  bool enviar(const uint8_t* cabecera, size_t longCabecera, const uint8_t* datos, size_t longDatos) {
+    if (_ciclo.activo()) {
+      uint32_t ahora = _reloj();
+      atenderA(ahora);                        // lo diferido sale primero: se conserva el orden
+      if (_nDiferido > 0 || !_ciclo.alcanza(tiempoEnAire_us(longCabecera + longDatos), ahora))
+        return diferir(cabecera, longCabecera, datos, longDatos);
     }
-    return false;
+    return transmitir(cabecera, longCabecera, datos, longDatos);
+  }
+
+  // --- Tiempo en aire y ciclo de trabajo ---
+
+  /* µs en el aire de un paquete de n bytes con esta configuración (preámbulo 8, sin CRC). */
+  uint32_t tiempoEnAire_us(size_t n) const { return loraTiempoEnAire_us(_config, n); }
+
+  /* ppm del tiempo (1 % = 10000) sobre una ventana de ventana_s segundos; ppm = 0 lo apaga.
+   * La cubeta se rellena con 'reloj' (ms): en nodos que duermen en power-down millis() se
+   * detiene y la cubeta no se llenaría nunca; pasar uno que cuente lo dormido, p. ej.
+   * una función que devuelva sched.now() de SchedulerWSN. */
+  void setCicloTrabajo(uint32_t ppm, uint32_t ventana_s, PoliticaCiclo politica = CICLO_DIFERIR,
+                       uint32_t (*reloj)() = relojMillis) {
+    _politica = politica;
+    _reloj = reloj ? reloj : relojMillis;
+    if (ppm) _ciclo.configurar(ppm, ventana_s, _reloj());
+    else     _ciclo.desactivar();
+  }
+
+  /* Manda lo diferido en cuanto el ciclo lo permite; llamar desde loop(). */
+  void atender() { atenderA(_reloj()); }
+
+  /* ms hasta poder mandar n bytes sin que se difieran ni rechacen (CicloTrabajo::NUNCA si no caben). */
+  uint32_t proximoEnvio_ms(size_t n) {
+    uint32_t aire = tiempoEnAire_us(n) + (_nDiferido ? tiempoEnAire_us(_nDiferido) : 0);
+    return _ciclo.espera_ms(aire, _reloj());
   }
 
-  int hayDatosDisponibles() override {
-    return LoRa.parsePacket();
+  uint8_t             diferidos() const { return _nDiferido; }   // bytes esperando fichas
+  const CicloTrabajo& ciclo() const     { return _ciclo; }
+
+  // --- Perfil de enlace (ADR): SF y potencia en caliente, sin reiniciar el radio ---
+
+  /* Cambia SF (6..12) y potencia (2..20 dBm); tiempoEnAire_us() sigue al nuevo SF. */
+  void setPerfil(uint8_t sf, int8_t potencia_dBm) {
+    if (sf != _config.spreadingFactor) LoRa.setSpreadingFactor(sf);   // también ajusta LDRO
+    if (potencia_dBm != _config.txPower) LoRa.setTxPower(potencia_dBm);
+    _config.spreadingFactor = sf;
+    _config.txPower         = potencia_dBm;
   }
 
-  size_t leer(uint8_t* buffer, size_t maxLongitud) override {
-    size_t bytesLeidos = 0;
-    while (LoRa.available() && bytesLeidos < maxLongitud) {
-      buffer[bytesLeidos] = (uint8_t)LoRa.read();
-      bytesLeidos++;
+  uint8_t           spreadingFactor() const { return (uint8_t)_config.spreadingFactor; }
+  int8_t            potencia_dBm() const    { return (int8_t)_config.txPower; }
+  const LoRaConfig& config() const          { return _config; }
+
+  int hayDatosDisponibles() {
+    if (_pendiente <= 0) {
+      // parsePacket() limpia las banderas y descarta en silencio un paquete con CRC malo
+      // (solo si el emisor usa LoRa.enableCrc()): se cuenta antes de llamarla
+      uint8_t irq = loraLeerRegistro(_config.csPin, LORA_REG_IRQ_FLAGS);
+      if ((irq & (LORA_IRQ_RX_DONE | LORA_IRQ_CRC_ERROR)) == (LORA_IRQ_RX_DONE | LORA_IRQ_CRC_ERROR)) ++_stats.errorCrc;
+      _pendiente = LoRa.parsePacket();
     }
-    return bytesLeidos;
+    return _pendiente;
+  }
+
+  // Lee el paquete completo del FIFO; lo que no quepa en el buffer se descarta
+  size_t leer(uint8_t* buffer, size_t maxLongitud) {
+    if (hayDatosDisponibles() <= 0) return 0;
+    size_t n = min((size_t)_pendiente, maxLongitud);
+    loraLeerFifo(_config.csPin, buffer, n);
+    _pendiente = 0;
+    _stats.registrarRx((int16_t)LoRa.packetRssi(), (int8_t)loraLeerRegistro(_config.csPin, LORA_REG_PKT_SNR));
+    return n;
   }
 
-  int obtenerRSSI() override {
+  size_t recibirEn(BufferRx& buffer) {
+    buffer.longitud = 0;
+    int disponible = hayDatosDisponibles();
+    if (disponible <= 0) return 0;
+    buffer.meta.longitudOriginal = (size_t)disponible;
+    buffer.meta.llegada_ms       = millis();
+    buffer.longitud = leer(buffer.datos, buffer.capacidad);
+    buffer.meta.rssi_dBm         = _stats.rssiUltimo_dBm;        // leer() ya los tomó del SX127x
+    buffer.meta.snr_cuartos_dB   = _stats.snrUltimo_cuartos_dB;
+    return buffer.longitud;
+  }
+
+  int obtenerRSSI() {
     return LoRa.packetRssi();
   }
 
-  bool dormir() override {
+  bool dormir() {
     LoRa.sleep();
     return true;
   }
 
-  bool despertar() override {
+  bool despertar() {
     LoRa.idle();
     return true;
   }
 };
 
+// Versión polimórfica (RadioInterface) para gateways: radio = new LoraRadio(config)
+class LoraRadio : public RadioAdaptador<LoraBackend> {
+public:
+  LoraRadio(const LoRaConfig& config) : RadioAdaptador<LoraBackend>(config) {}
+};
+
 #endif
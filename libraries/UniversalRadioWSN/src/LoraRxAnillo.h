@@ -0,0 +1,122 @@
+#ifndef LORA_RX_ANILLO_H
+#define LORA_RX_ANILLO_H
+
+#include <LoRa.h>
+#include "BufferRx.h"
+#include "LoraRadio.h"
+
+/**
+ * Recepción LoRa por interrupción hacia un anillo de paquetes.
+ * El radio queda en RX continuo (LoRa.receive()); en cada RX-done la ISR de
+ * onReceive lee el FIFO en ráfaga a un slot fijo junto con RSSI, SNR y la marca
+ * de llegada. loop() saca paquetes completos con recibirEn() o, sin copiar,
+ * con frente()/soltar(). Si el anillo está lleno el paquete nuevo se descarta y
+ * se cuenta en descartados(): loop() puede tardar escribiendo en SD sin perder
+ * lo que llega mientras tanto, hasta N_SLOTS paquetes.
+ * Productor único (ISR) y consumidor único (loop).
+ * Mientras el anillo está activo no usar el enviar() bloqueante: con DIO0 mapeado
+ * la ISR limpia el flag de TX-done que endPacket() espera. Transmitir con
+ * LoraTxAsincrono(volverARecepcion=true), que además regresa el radio a RX continuo.
+ * estadisticasEnlace() se actualiza en loop() al soltar cada paquete (nada en la ISR);
+ * los errores de CRC no se ven: handleDio0Rise() los descarta antes de llamarnos.
+ */
+template <uint8_t N_SLOTS = 4, uint8_t MAX_BYTES = 32>
+class LoraRxAnillo {
+  static_assert((N_SLOTS & (N_SLOTS - 1)) == 0, "N_SLOTS debe ser potencia de 2 (índices de 8 bits)");
+
+public:
+  struct Paquete {
+    uint8_t  datos[MAX_BYTES];
+    uint8_t  longitud;          // bytes guardados en datos
+    uint8_t  longitudOriginal;  // bytes en el aire; > longitud si no cupo
+    int16_t  rssi_dBm;
+    int8_t   snr_cuartos_dB;
+    uint32_t llegada_ms;
+  };
+
+  /* csPin: el mismo de LoRaConfig. Llamar después de iniciar() el radio. */
+  void begin(int csPin) {
+    _csPin = csPin;
+    _cabeza = _cola = 0;
+    _descartados = 0;
+    _stats.reiniciar();
+    instancia() = this;
+    LoRa.onReceive(isrRecibido);
+    escuchar();
+  }
+
+  void escuchar() { LoRa.receive(); }
+
+  uint8_t disponibles() const { return (uint8_t)(_cabeza - _cola); }
+
+  /* Paquete más antiguo sin copiarlo; nullptr si no hay. Liberarlo con soltar(). */
+  const Paquete* frente() const {
+    return disponibles() ? &_slots[_cola % N_SLOTS] : nullptr;
+  }
+  void soltar() {
+    if (!disponibles()) return;
+    const Paquete& p = _slots[_cola % N_SLOTS];
+    _stats.registrarRx(p.rssi_dBm, p.snr_cuartos_dB);
+    ++_cola;
+  }
+
+  /* Copia el paquete más antiguo al buffer del llamador con sus metadatos */
+  size_t recibirEn(BufferRx& buffer) {
+    buffer.longitud = 0;
+    const Paquete* p = frente();
+    if (!p) return 0;
+    buffer.longitud = min((size_t)p->longitud, buffer.capacidad);
+    memcpy(buffer.datos, p->datos, buffer.longitud);
+    buffer.meta.rssi_dBm         = p->rssi_dBm;
+    buffer.meta.snr_cuartos_dB   = p->snr_cuartos_dB;
+    buffer.meta.llegada_ms       = p->llegada_ms;
+    buffer.meta.longitudOriginal = p->longitudOriginal;
+    soltar();
+    return buffer.longitud;
+  }
+
+  uint16_t descartados() const { return _descartados; }
+
+  const LinkStats& estadisticasEnlace() {
+    noInterrupts();              // 16 bits que la ISR escribe: copia atómica en AVR
+    _stats.descartesCola = _descartados;
+    interrupts();
+    return _stats;
+  }
+
+private:
+  Paquete           _slots[N_SLOTS];
+  volatile uint8_t  _cabeza = 0;   // solo la ISR lo avanza
+  volatile uint8_t  _cola   = 0;   // solo loop() lo avanza
+  volatile uint16_t _descartados = 0;
+  int               _csPin = -1;
+  LinkStats         _stats;
+
+  static LoraRxAnillo*& instancia() {
+    static LoraRxAnillo* ptr = nullptr;
+    return ptr;
+  }
+
+  static void isrRecibido(int longitud) {
+    LoraRxAnillo* self = instancia();
+    if (self) self->onPaquete(longitud);
+  }
+
+  // Contexto de interrupción: handleDio0Rise() ya dejó el puntero del FIFO al inicio
+  void onPaquete(int longitud) {
+    if ((uint8_t)(_cabeza - _cola) >= N_SLOTS) {
+      ++_descartados;
+      return;
+    }
+    Paquete& p = _slots[_cabeza % N_SLOTS];
+    p.longitudOriginal = (uint8_t)longitud;
+    p.longitud         = (uint8_t)min(longitud, (int)MAX_BYTES);
+    loraLeerFifo(_csPin, p.datos, p.longitud);
+    p.rssi_dBm       = LoRa.packetRssi();
+    p.snr_cuartos_dB = (int8_t)loraLeerRegistro(_csPin, LORA_REG_PKT_SNR);   // sin float en la ISR
+    p.llegada_ms     = millis();
+    ++_cabeza;      // publica el slot al final, ya completo
+  }
+};
+
+#endif
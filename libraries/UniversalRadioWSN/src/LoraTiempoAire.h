@@ -0,0 +1,102 @@
+#ifndef LORA_TIEMPO_AIRE_H
+#define LORA_TIEMPO_AIRE_H
+
+#include <Arduino.h>
+
+/**
+ * Tiempo en aire de un paquete LoRa (fórmula del SX127x, AN1200.13) en µs, en
+ * aritmética entera y constexpr: con una configuración constexpr se resuelve en
+ * compilación (static_assert de que un paquete cabe en el ciclo de trabajo, tablas).
+ *   sf 6..12, anchoBanda en Hz, codingRate 5..8 (4/5..4/8) como en LoRaConfig.
+ * Valores por defecto = los de arduino-LoRa: preámbulo 8, CRC apagado, cabecera
+ * explícita; LDRO automático con el mismo criterio que LoRa.setLdoFlag().
+ */
+constexpr uint32_t loraSimbolo_us(uint8_t sf, uint32_t anchoBanda_Hz) {
+  return (1000000UL << sf) / anchoBanda_Hz;   // cabe en 32 bits hasta SF12
+}
+
+// La misma expresión entera que LoRa.setLdoFlag(): ms de símbolo truncados, luego > 16.
+// No coincide con "símbolo > 16 ms" exacto (SF11 a 125 kHz da 16.384 ms y queda sin LDRO).
+constexpr bool loraLdro(uint8_t sf, uint32_t anchoBanda_Hz) {
+  return ((long)anchoBanda_Hz >> sf) > 0 && 1000L / ((long)anchoBanda_Hz / (1L << sf)) > 16;
+}
+
+constexpr int32_t loraNumeradorCarga(size_t n, uint8_t sf, bool crc, bool cabeceraImplicita) {
+  return 8L * (int32_t)n - 4L * sf + 28 + (crc ? 16 : 0) - (cabeceraImplicita ? 20 : 0);
+}
+
+constexpr uint32_t loraSimbolosCarga(int32_t numerador, int32_t divisor, uint8_t codingRate) {
+  return 8UL + (numerador > 0 ? (uint32_t)((numerador + divisor - 1) / divisor) * codingRate : 0UL);
+}
+
+constexpr uint32_t loraTiempoEnAire_us(size_t n, uint8_t sf, uint32_t anchoBanda_Hz, uint8_t codingRate,
+                                       uint16_t preambulo = 8, bool crc = false,
+                                       bool cabeceraImplicita = false) {
+  return loraSimbolo_us(sf, anchoBanda_Hz) * (4UL * preambulo + 17UL) / 4UL
+       + loraSimbolo_us(sf, anchoBanda_Hz)
+         * loraSimbolosCarga(loraNumeradorCarga(n, sf, crc, cabeceraImplicita),
+                             4L * (sf - (loraLdro(sf, anchoBanda_Hz) ? 2 : 0)), codingRate);
+}
+
+/**
+ * Limitador de ciclo de trabajo por cubeta de fichas, en µs de aire.
+ * Se llena a razón de ppm (1 % = 10000) y guarda como máximo ventana_s·ppm µs, así
+ * que en cualquier ventana nunca se transmite más de lo permitido más una ráfaga
+ * inicial de una ventana. Ej. EU868 1 %: configurar(10000, 3600).
+ */
+class CicloTrabajo {
+public:
+  static const uint32_t NUNCA = 0xFFFFFFFFUL;
+
+  void configurar(uint32_t ppm, uint32_t ventana_s, uint32_t ahora_ms = millis()) {
+    _ppm          = ppm;
+    _capacidad_us = ventana_s * ppm;
+    _fichas_us    = _capacidad_us;    // arranca lleno
+    _resto        = 0;
+    _ultimo_ms    = ahora_ms;
+  }
+
+  void desactivar()    { _ppm = 0; }
+  bool activo() const  { return _ppm != 0; }
+
+  bool alcanza(uint32_t aire_us, uint32_t ahora_ms = millis()) {
+    if (!activo()) return true;
+    rellenar(ahora_ms);
+    return _fichas_us >= aire_us;
+  }
+
+  void consumir(uint32_t aire_us) {
+    if (activo()) _fichas_us = aire_us > _fichas_us ? 0 : _fichas_us - aire_us;
+  }
+
+  /* ms hasta que haya fichas para aire_us (0 = ya; NUNCA si no cabe ni con la cubeta llena). */
+  uint32_t espera_ms(uint32_t aire_us, uint32_t ahora_ms = millis()) {
+    if (!activo()) return 0;
+    if (aire_us > _capacidad_us) return NUNCA;
+    rellenar(ahora_ms);
+    if (_fichas_us >= aire_us) return 0;
+    uint32_t falta = aire_us - _fichas_us;
+    return falta / _ppm * 1000UL + ((falta % _ppm) * 1000UL + _ppm - 1) / _ppm;
+  }
+
+  uint32_t fichas_us()    const { return _fichas_us; }
+  uint32_t capacidad_us() const { return _capacidad_us; }
+
+private:
+  uint32_t _ppm = 0, _capacidad_us = 0, _fichas_us = 0, _resto = 0, _ultimo_ms = 0;
+
+  // dt·ppm/1000 por partes para no desbordar; el resto (< 1 µs) se acumula entre llamadas
+  void rellenar(uint32_t ahora_ms) {
+    uint32_t dt = ahora_ms - _ultimo_ms;
+    _ultimo_ms = ahora_ms;
+    if (_fichas_us >= _capacidad_us) return;
+    uint32_t segundos = dt / 1000UL;
+    if (segundos >= _capacidad_us / _ppm + 1) { _fichas_us = _capacidad_us; return; }
+    _resto += (dt % 1000UL) * _ppm;
+    uint32_t ganado = segundos * _ppm + _resto / 1000UL;
+    _resto %= 1000UL;
+    _fichas_us = (ganado >= _capacidad_us - _fichas_us) ? _capacidad_us : _fichas_us + ganado;
+  }
+};
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef LORA_TX_ASINCRONO_H
+#define LORA_TX_ASINCRONO_H
+
+#include <LoRa.h>
+#include "LinkStats.h"
+#include "LoraRadio.h"
+
+/**
+ * Cola de transmisión LoRa no bloqueante.
+ * encolar() copia el paquete a un slot fijo y, si el radio está libre, lo carga al
+ * FIFO y arranca la TX con LoRa.endPacket(true): vuelve enseguida en lugar de
+ * esperar todo el tiempo en el aire. El fin de la TX llega por DIO0 (onTxDone), que
+ * además despierta al micro si estaba en power-down. atender() —desde loop() o tras
+ * despertar— entrega el resultado al callback del paquete y lanza el siguiente.
+ * Un paquete sin TX-done después de timeout_ms se da por fallido. El plazo se mide con
+ * un solo reloj, el que se pasa a begin(): si el micro duerme en power-down millis() se
+ * detiene, y el sketch debe dar uno que sume el tiempo dormido (millis() + dormido_ms).
+ * Requiere DIO0 conectado a un pin con interrupción (irqPin de LoRaConfig).
+ * Con volverARecepcion=true (junto con LoraRxAnillo), al vaciarse la cola el radio
+ * regresa a RX continuo en lugar de quedar en standby.
+ * estadisticasEnlace(): aire calculado con loraTiempoEnAire_us() para la configuración
+ * de begin() (como LoraBackend; micros() no sirve porque se detiene en power-down),
+ * fallos por timeout/rechazo y paquetes que no cupieron en la cola. Si el SF cambia en
+ * marcha (LoraAdr), llamar configurarAire() con la configuración nueva.
+ */
+template <uint8_t N_SLOTS = 4, uint8_t MAX_BYTES = 32>
+class LoraTxAsincrono {
+public:
+  // Se llama desde atender(), nunca desde la ISR
+  typedef void (*AlTerminar)(uint8_t id, bool ok, void* ctx);
+  // ms del reloj de la aplicación; por defecto millis()
+  typedef uint32_t (*Reloj)();
+
+  void begin(const LoRaConfig& config, uint16_t timeout_ms = 3000, bool volverARecepcion = false,
+             Reloj reloj = relojMillis) {
+    configurarAire(config);
+    _timeout_ms = timeout_ms;
+    _volverARecepcion = volverARecepcion;
+    _reloj = reloj ? reloj : relojMillis;
+    txHecho() = false;
+    LoRa.onTxDone(isrTxHecho);
+  }
+
+  /* Parámetros con los que se calcula el aire de cada paquete enviado */
+  void configurarAire(const LoRaConfig& config) {
+    _sf          = (uint8_t)config.spreadingFactor;
+    _anchoBanda  = (uint32_t)config.signalBandwidth;
+    _codingRate  = (uint8_t)config.codingRate;
+  }
+
+  /* Copia cabecera + datos a la cola. Devuelve el id del paquete o -1 si no cabe. */
+  int16_t encolar(const uint8_t* cabecera, size_t longCabecera,
+                  const uint8_t* datos, size_t longDatos,
+                  AlTerminar alTerminar = nullptr, void* ctx = nullptr) {
+    if (_cuenta >= N_SLOTS || longCabecera + longDatos > MAX_BYTES) {
+      ++_stats.descartesCola;
+      return -1;
+    }
+    Slot& s = _slots[(_cabeza + _cuenta) % N_SLOTS];
+    if (longCabecera) memcpy(s.datos, cabecera, longCabecera);
+    if (longDatos)    memcpy(s.datos + longCabecera, datos, longDatos);
+    s.longitud   = (uint8_t)(longCabecera + longDatos);
+    s.id         = _siguienteId++;
+    s.alTerminar = alTerminar;
+    s.ctx        = ctx;
+    ++_cuenta;
+    if (!_enVuelo) iniciarSiguiente();
+    return s.id;
+  }
+
+  int16_t encolar(const uint8_t* datos, size_t longitud,
+                  AlTerminar alTerminar = nullptr, void* ctx = nullptr) {
+    return encolar(nullptr, 0, datos, longitud, alTerminar, ctx);
+  }
+
+  /* Cierra la TX en curso (ok o timeout) y arranca la siguiente. Llamar seguido. */
+  void atender() {
+    if (_enVuelo) {
+      if (txHecho()) {
+        terminar(true);
+      } else if (_reloj() - _inicio_ms > _timeout_ms) {
+        LoRa.idle();             // aborta la TX colgada
+        terminar(false);
+      }
+    }
+    if (!_enVuelo) iniciarSiguiente();
+    if (_volverARecepcion && _recepcionPendiente && !_enVuelo) {
+      _recepcionPendiente = false;
+      LoRa.receive();          // DIO0 vuelve a RX-done
+    }
+  }
+
+  bool    enVuelo()    const { return _enVuelo; }     // hay una TX en el aire
+  bool    ocupado()    const { return _cuenta > 0; }  // en el aire o esperando turno
+  uint8_t pendientes() const { return _cuenta; }
+  uint8_t libres()     const { return N_SLOTS - _cuenta; }
+  uint32_t enviados()  const { return _stats.enviados; }
+  uint32_t fallidos()  const { return _stats.fallosTx; }
+  const LinkStats& estadisticasEnlace() const { return _stats; }
+
+private:
+  struct Slot {
+    uint8_t    datos[MAX_BYTES];
+    uint8_t    longitud;
+    uint8_t    id;
+    AlTerminar alTerminar;
+    void*      ctx;
+  };
+
+  Slot     _slots[N_SLOTS];
+  uint8_t  _cabeza = 0, _cuenta = 0, _siguienteId = 0;
+  bool     _enVuelo = false;
+  bool     _volverARecepcion = false, _recepcionPendiente = false;
+  uint32_t _inicio_ms = 0;
+  uint16_t _timeout_ms = 3000;
+  Reloj    _reloj = relojMillis;
+  uint8_t  _sf = 7, _codingRate = 5;
+  uint32_t _anchoBanda = 125000UL;
+  LinkStats _stats;
+
+  static uint32_t relojMillis() { return millis(); }
+
+  static volatile bool& txHecho() {
+    static volatile bool hecho = false;
+    return hecho;
+  }
+
+  static void isrTxHecho() {
+    txHecho() = true;
+  }
+
+  void iniciarSiguiente() {
+    while (_cuenta > 0 && !_enVuelo) {
+      Slot& s = _slots[_cabeza];
+      txHecho() = false;
+      if (LoRa.beginPacket()) {
+        LoRa.write(s.datos, s.longitud);
+        LoRa.endPacket(true);    // no bloquea: el fin llega por DIO0
+        _enVuelo   = true;
+        _inicio_ms = _reloj();
+        _recepcionPendiente = true;
+      } else {
+        terminar(false);         // el radio no aceptó el paquete
+      }
+    }
+  }
+
+  void terminar(bool ok) {
+    Slot& s = _slots[_cabeza];
+    AlTerminar alTerminar = s.alTerminar;
+    void*      ctx        = s.ctx;
+    uint8_t    id         = s.id;
+    uint32_t   aire_us    = ok ? loraTiempoEnAire_us(s.longitud, _sf, _anchoBanda, _codingRate) : 0;
+    _cabeza  = (_cabeza + 1) % N_SLOTS;
+    --_cuenta;
+    _enVuelo = false;
+    _stats.registrarTx(ok, aire_us);
+    if (alTerminar) alTerminar(id, ok, ctx);   // puede volver a encolar sin problema
+  }
+};
+
+#endif
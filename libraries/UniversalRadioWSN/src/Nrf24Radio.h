@@ -0,0 +1,177 @@
+#ifndef NRF24_RADIO_H
+#define NRF24_RADIO_H
+
+#include <SPI.h>
+#include <RF24.h>
+#include "RadioBase.h"
+#include "RadioAdaptador.h"
+
+/**
+ * nRF24L01(+) en estrella multiceiver: un coordinador escucha a hasta 6 nodos a la vez,
+ * uno por pipe. Todas las direcciones comparten los 4 bytes altos de direccionBase y
+ * difieren en el byte bajo (requisito de los pipes 1..5); el nodo k (0..5) transmite a
+ * la dirección k y el coordinador la escucha en el pipe k.
+ * Carga útil dinámica (1..32 bytes, sin relleno a 32) y auto-ack con reintentos por
+ * hardware: enviar() devuelve si el otro extremo confirmó.
+ * El coordinador responde por defecto al último nodo que le habló (setDestino() lo fija).
+ * El nRF24 no mide RSSI: obtenerRSSI() devuelve 0 y MetaRx::origen trae el pipe (0..5).
+ *
+ * Con cargaEnAck el coordinador precarga la bajada de cada nodo (cargarAck) y el chip la
+ * manda dentro del ACK de la siguiente subida de ese pipe: el nodo la lee con recibirEn()
+ * en cuanto enviar() vuelve, sin ventana de escucha. RF24 vacía esas cargas al pasar a
+ * TX, así que en ese modo el coordinador no usa enviar().
+ */
+struct Nrf24Config {
+  uint8_t        cePin;
+  uint8_t        csnPin;
+  uint8_t        canal           = 108;
+  rf24_datarate_e velocidad      = RF24_250KBPS;
+  rf24_pa_dbm_e  potencia        = RF24_PA_MIN;
+  uint8_t        direccionBase[5] = { 0x00, 'N', 'S', 'W', 0xC3 };  // byte 0 = pipe (LSB primero)
+  bool           esCoordinador   = false;
+  uint8_t        nodo            = 0;    // 0..5 en los nodos: pipe que usan en el coordinador
+  uint8_t        reintentos      = 15;   // reintentos automáticos (0..15)
+  uint8_t        retardoReintento = 5;   // (n+1)·250 µs entre reintentos
+  bool           cargaEnAck      = false; // bajadas dentro del ACK (ambos extremos)
+
+  Nrf24Config(uint8_t ce, uint8_t csn) : cePin(ce), csnPin(csn) {}
+};
+
+class Nrf24Backend : public RadioBase<Nrf24Backend> {
+public:
+  static const uint8_t MAX_PIPES  = 6;
+  static const uint8_t MAX_CARGA  = 32;
+
+  using RadioBase<Nrf24Backend>::enviar;
+
+  Nrf24Backend(const Nrf24Config& config)
+    : _config(config), _radio(config.cePin, config.csnPin) {}
+
+  bool iniciar() {
+    if (!_radio.begin()) return false;
+    _radio.setChannel(_config.canal);
+    _radio.setDataRate(_config.velocidad);
+    _radio.setPALevel(_config.potencia);
+    _radio.setAutoAck(true);
+    _radio.enableDynamicPayloads();
+    _radio.setRetries(_config.retardoReintento, _config.reintentos);
+    if (_config.cargaEnAck) _radio.enableAckPayload();
+
+    uint8_t direccion[5];
+    if (_config.esCoordinador) {
+      for (uint8_t p = 0; p < MAX_PIPES; ++p) {
+        direccionPipe(p, direccion);
+        _radio.openReadingPipe(p, direccion);
+      }
+      _destino = 0;
+    } else {
+      if (_config.nodo >= MAX_PIPES) return false;
+      direccionPipe(_config.nodo, direccion);
+      _radio.openWritingPipe(direccion);      // TX y pipe 0 para el ACK
+      _radio.openReadingPipe(1, direccion);   // el coordinador responde a la misma dirección
+      _destino = _config.nodo;
+    }
+    _radio.startListening();
+    return true;
+  }
+
+  /* Coordinador con cargaEnAck: bajada para la próxima subida del pipe (hasta 3 en cola, 32 B). */
+  bool cargarAck(uint8_t pipe, const uint8_t* datos, size_t longitud) {
+    if (!_config.cargaEnAck || pipe >= MAX_PIPES || longitud == 0 || longitud > MAX_CARGA) return false;
+    return _radio.writeAckPayload(pipe, datos, (uint8_t)longitud);
+  }
+
+  bool confirmaEntrega() const { return true; }   // auto-ack: enviar() ya esperó el ACK
+
+  /* Coordinador: pipe/nodo al que irán los siguientes enviar(). */
+  void setDestino(uint8_t pipe) { if (pipe < MAX_PIPES) _destino = pipe; }
+
+  bool enviar(const uint8_t* buffer, size_t longitud) {
+    if (longitud == 0 || longitud > MAX_CARGA) return false;
+    _radio.stopListening();
+    if (_config.esCoordinador) {
+      uint8_t direccion[5];
+      direccionPipe(_destino, direccion);
+      _radio.openWritingPipe(direccion);
+    }
+    bool ok = _radio.write(buffer, (uint8_t)longitud);
+    uint8_t arc = _radio.getARC();
+    _stats.registrarTx(ok, tiempoEnAire_us(longitud) * (arc + 1U), arc);
+    _radio.startListening();                  // restaura la dirección de lectura del pipe 0
+    return ok;
+  }
+
+  int hayDatosDisponibles() {
+    if (_pendiente > 0) return _pendiente;
+    uint8_t pipe;
+    if (!_radio.available(&pipe)) return 0;
+    uint8_t n = _radio.getDynamicPayloadSize();
+    if (n < 1 || n > MAX_CARGA) {             // longitud corrupta: el datasheet pide vaciar el FIFO
+      _radio.flush_rx();
+      return 0;
+    }
+    _pipe = pipe;
+    _pendiente = n;
+    return n;
+  }
+
+  size_t leer(uint8_t* buffer, size_t maxLongitud) {
+    if (hayDatosDisponibles() <= 0) return 0;
+    uint8_t n = (uint8_t)min((size_t)_pendiente, maxLongitud);
+    _radio.read(buffer, n);                   // el paquete sale del FIFO aunque n sea menor
+    _pendiente = 0;
+    _stats.registrarRx(0);                    // sin RSSI: solo cuenta
+    if (_config.esCoordinador) _destino = _pipe;   // responder a quien habló
+    return n;
+  }
+
+  size_t recibirEn(BufferRx& buffer) {
+    buffer.longitud = 0;
+    int disponible = hayDatosDisponibles();
+    if (disponible <= 0) return 0;
+    buffer.meta.longitudOriginal = (size_t)disponible;
+    buffer.meta.rssi_dBm         = 0;
+    buffer.meta.snr_cuartos_dB   = 0;
+    buffer.meta.llegada_ms       = millis();
+    buffer.meta.origen           = _pipe;
+    buffer.longitud = leer(buffer.datos, buffer.capacidad);
+    return buffer.longitud;
+  }
+
+  bool dormir()    { _radio.powerDown(); return true; }
+  bool despertar() { _radio.powerUp(); _radio.startListening(); return true; }
+
+  uint8_t  ultimoPipe() const { return _pipe; }
+  uint32_t entregados() const { return _stats.enviados; }
+  uint32_t fallidos()   const { return _stats.fallosTx; }
+  uint32_t reintentos() const { return _stats.reintentos; }   // retransmisiones acumuladas (ARC)
+  RF24&    rf24()             { return _radio; }
+
+private:
+  Nrf24Config _config;
+  RF24        _radio;
+  uint8_t     _destino = 0, _pipe = 0, _pendiente = 0;
+
+  // Un intento: preámbulo 1 + dirección 5 + PCF 9 bits + carga + CRC 2, a la tasa configurada
+  uint32_t tiempoEnAire_us(size_t longitud) const {
+    uint32_t bits = (1 + 5 + 2 + (uint32_t)longitud) * 8 + 9;
+    switch (_config.velocidad) {
+      case RF24_2MBPS:   return bits / 2;
+      case RF24_1MBPS:   return bits;
+      default:           return bits * 4;   // 250 kbps
+    }
+  }
+
+  void direccionPipe(uint8_t pipe, uint8_t* direccion) const {
+    memcpy(direccion, _config.direccionBase, 5);
+    direccion[0] = (uint8_t)(_config.direccionBase[0] + pipe);
+  }
+};
+
+// Versión polimórfica (RadioInterface) para gateways: radio = new Nrf24Radio(config)
+class Nrf24Radio : public RadioAdaptador<Nrf24Backend> {
+public:
+  Nrf24Radio(const Nrf24Config& config) : RadioAdaptador<Nrf24Backend>(config) {}
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef RADIO_ADAPTADOR_H
+#define RADIO_ADAPTADOR_H
+
+#include "RadioInterface.h"
+
+/**
+ * Envuelve un backend estático (RadioBase<...>) en la RadioInterface virtual.
+ * Es lo que usan los gateways que eligen el radio en tiempo de ejecución:
+ * LoraRadio y XBeeRadio son RadioAdaptador de su backend.
+ */
+template <class B>
+class RadioAdaptador : public RadioInterface {
+public:
+  typedef B Backend;
+
+  template <typename... Args>
+  explicit RadioAdaptador(Args&&... args) : _backend(static_cast<Args&&>(args)...) {}
+
+  bool   iniciar() override                                  { return _backend.iniciar(); }
+  bool   enviar(const uint8_t* buffer, size_t longitud) override { return _backend.enviar(buffer, longitud); }
+  int    hayDatosDisponibles() override                      { return _backend.hayDatosDisponibles(); }
+  size_t leer(uint8_t* buffer, size_t maxLongitud) override  { return _backend.leer(buffer, maxLongitud); }
+  int    obtenerRSSI() override                              { return _backend.obtenerRSSI(); }
+  bool   dormir() override                                   { return _backend.dormir(); }
+  bool   despertar() override                                { return _backend.despertar(); }
+  bool   confirmaEntrega() const override                    { return _backend.confirmaEntrega(); }
+  bool   enviar(const uint8_t* cabecera, size_t longCabecera,
+                const uint8_t* datos, size_t longDatos) override { return _backend.enviar(cabecera, longCabecera, datos, longDatos); }
+  size_t recibirEn(BufferRx& buffer) override                { return _backend.recibirEn(buffer); }
+  bool   enviar(const String& data) override                 { return _backend.enviar(data); }
+  String leerComoString() override                           { return _backend.leerComoString(); }
+  const LinkStats& estadisticasEnlace() const override       { return _backend.estadisticasEnlace(); }
+
+  Backend& backend() { return _backend; }
+
+protected:
+  Backend _backend;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef RADIO_BASE_H
+#define RADIO_BASE_H
+
+#include <Arduino.h>
+#include "BufferRx.h"
+#include "LinkStats.h"
+
+/**
+ * Base CRTP para los backends de radio sin funciones virtuales.
+ * Derived implementa iniciar(), enviar(buffer, longitud), hayDatosDisponibles()
+ * y leer(); lo demás tiene aquí una versión por defecto que Derived puede ocultar
+ * declarando un método con el mismo nombre. Todas las llamadas se resuelven en
+ * compilación y el compilador puede inlinearlas: ni vtable ni new en el nodo.
+ */
+template <class Derived>
+class RadioBase {
+public:
+  int  obtenerRSSI() { return 0; }
+  bool dormir()      { return true; }
+  bool despertar()   { return true; }
+  bool confirmaEntrega() const { return false; }   // true en los backends con ACK de enlace
+
+  const LinkStats& estadisticasEnlace() const { return _stats; }
+
+  // Mismas versiones por defecto que RadioInterface; los backends las ocultan con las suyas
+  bool enviar(const uint8_t* cabecera, size_t longCabecera, const uint8_t* datos, size_t longDatos) {
+    uint8_t unido[64];
+    if (longCabecera + longDatos > sizeof(unido)) return false;
+    memcpy(unido, cabecera, longCabecera);
+    memcpy(unido + longCabecera, datos, longDatos);
+    return self().enviar(unido, longCabecera + longDatos);
+  }
+
+  size_t recibirEn(BufferRx& buffer) {
+    buffer.longitud = 0;
+    if (self().hayDatosDisponibles() <= 0) return 0;
+    buffer.longitud = self().leer(buffer.datos, buffer.capacidad);
+    buffer.meta.rssi_dBm         = self().obtenerRSSI();
+    buffer.meta.snr_cuartos_dB   = 0;
+    buffer.meta.llegada_ms       = millis();
+    buffer.meta.longitudOriginal = buffer.longitud;
+    return buffer.longitud;
+  }
+
+  bool enviar(const String& data) {
+    return self().enviar(reinterpret_cast<const uint8_t*>(data.c_str()), data.length());
+  }
+
+  String leerComoString() {
+    uint8_t buffer[256];
+    size_t longitud = self().leer(buffer, 255);
+    buffer[longitud] = '\0';
+    return String(reinterpret_cast<char*>(buffer));
+  }
+
+protected:
+  LinkStats _stats;   // cada backend la llena con lo que su hardware reporta (RX: en leer())
+
+  Derived& self() { return *static_cast<Derived*>(this); }
+};
+
+#endif
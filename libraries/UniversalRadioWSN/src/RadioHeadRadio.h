@@ -0,0 +1,109 @@
+#ifndef RADIOHEAD_RADIO_H
+#define RADIOHEAD_RADIO_H
+
+#include <RHReliableDatagram.h>
+#include "RadioBase.h"
+#include "RadioAdaptador.h"
+
+/**
+ * Cualquier driver de RadioHead (RH_RF95, RH_NRF24, RH_Serial, ...) con RHReliableDatagram:
+ * cada enviar() espera el ACK del destino y reintenta solo; los duplicados que llegan
+ * cuando se pierde un ACK se confirman otra vez pero no se entregan dos veces.
+ * Direcciones de 8 bits: la propia va en el constructor, el destino con setDestino()
+ * (RH_BROADCAST_ADDRESS envía sin esperar ACK). MetaRx::origen trae quién lo mandó.
+ *
+ *   RH_RF95 driverLora(10, 2);
+ *   UniversalRadio<RadioHeadRadio> radio(driverLora, 1, 0);   // nodo 1 -> coordinador 0
+ */
+#ifndef RADIOHEAD_WSN_MAX_CARGA
+  #define RADIOHEAD_WSN_MAX_CARGA 64   // buffer de RX propio (el ACK obliga a leer el paquete entero)
+#endif
+
+class RadioHeadBackend : public RadioBase<RadioHeadBackend> {
+public:
+  static const uint8_t MAX_CARGA = RADIOHEAD_WSN_MAX_CARGA;
+
+  using RadioBase<RadioHeadBackend>::enviar;
+
+  RadioHeadBackend(RHGenericDriver& driver, uint8_t direccion, uint8_t destino = RH_BROADCAST_ADDRESS)
+    : _driver(driver), _manager(driver, direccion), _destino(destino) {}
+
+  bool iniciar() { return _manager.init(); }   // init() del manager inicia también el driver
+
+  void setDestino(uint8_t direccion) { _destino = direccion; }
+  void setReintentos(uint8_t reintentos) { _manager.setRetries(reintentos); }   // defecto RadioHead: 3
+  void setTimeoutAck(uint16_t ms) { _manager.setTimeout(ms); }                 // defecto RadioHead: 200 ms
+
+  // A difusión sendtoWait() no espera ACK: solo un destino concreto confirma
+  bool confirmaEntrega() const { return _destino != RH_BROADCAST_ADDRESS; }
+
+  bool enviar(const uint8_t* buffer, size_t longitud) {
+    if (longitud == 0 || longitud > _driver.maxMessageLength()) return false;
+    uint32_t antes = _manager.retransmissions();
+    // sendtoWait no modifica el buffer; su firma no es const por herencia de RadioHead
+    bool ok = _manager.sendtoWait(const_cast<uint8_t*>(buffer), (uint8_t)longitud, _destino);
+    _ultimosReintentos = (uint8_t)(_manager.retransmissions() - antes);
+    _stats.registrarTx(ok, 0, _ultimosReintentos);   // RadioHead no expone el tiempo en aire
+    return ok;
+  }
+
+  int hayDatosDisponibles() {
+    if (_pendiente > 0) return _pendiente;
+    _stats.errorCrc = _driver.rxBad();         // el driver ya los cuenta (CRC/cabecera malos)
+    if (!_manager.available()) return 0;
+    uint8_t n = sizeof(_rx);
+    // recvfromAck confirma al remitente y devuelve false con los duplicados ya entregados
+    if (!_manager.recvfromAck(_rx, &n, &_origen)) return 0;
+    _pendiente = n;
+    return n;
+  }
+
+  size_t leer(uint8_t* buffer, size_t maxLongitud) {
+    if (hayDatosDisponibles() <= 0) return 0;
+    size_t n = min((size_t)_pendiente, maxLongitud);
+    memcpy(buffer, _rx, n);
+    _pendiente = 0;
+    _stats.registrarRx((int16_t)_driver.lastRssi());
+    return n;
+  }
+
+  size_t recibirEn(BufferRx& buffer) {
+    buffer.longitud = 0;
+    int disponible = hayDatosDisponibles();
+    if (disponible <= 0) return 0;
+    buffer.meta.longitudOriginal = (size_t)disponible;
+    buffer.meta.rssi_dBm         = obtenerRSSI();
+    buffer.meta.snr_cuartos_dB   = 0;
+    buffer.meta.llegada_ms       = millis();
+    buffer.meta.origen           = _origen;
+    buffer.longitud = leer(buffer.datos, buffer.capacidad);
+    return buffer.longitud;
+  }
+
+  int  obtenerRSSI() { return _driver.lastRssi(); }
+  bool dormir()      { return _driver.sleep(); }
+  bool despertar()   { _driver.available(); return true; }   // available() devuelve el driver a RX
+
+  uint8_t  origen() const            { return _origen; }
+  uint8_t  ultimosReintentos() const { return _ultimosReintentos; }
+  uint32_t retransmisiones()         { return _manager.retransmissions(); }
+  uint32_t entregados() const        { return _stats.enviados; }
+  uint32_t fallidos() const          { return _stats.fallosTx; }
+  RHReliableDatagram& manager()      { return _manager; }
+
+private:
+  RHGenericDriver&   _driver;
+  RHReliableDatagram _manager;
+  uint8_t  _destino;
+  uint8_t  _rx[MAX_CARGA];
+  uint8_t  _pendiente = 0, _origen = 0, _ultimosReintentos = 0;
+};
+
+// Versión polimórfica (RadioInterface) para gateways: radio = new RadioHeadRadio(driver, 0)
+class RadioHeadRadio : public RadioAdaptador<RadioHeadBackend> {
+public:
+  RadioHeadRadio(RHGenericDriver& driver, uint8_t direccion, uint8_t destino = RH_BROADCAST_ADDRESS)
+    : RadioAdaptador<RadioHeadBackend>(driver, direccion, destino) {}
+};
+
+#endif
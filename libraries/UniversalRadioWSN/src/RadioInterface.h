@@ -2,6 +2,8 @@
 #define RADIO_INTERFACE_H
 
 #include <Arduino.h>
+#include "BufferRx.h"
+#include "LinkStats.h"
 
 class RadioInterface {
 public:
@@ -26,10 +28,58 @@ public:
   virtual int obtenerRSSI() { return 0; }
 
   virtual bool dormir() { return true; }
+
+  /**
+   * @brief Si enviar() == true significa que el otro extremo confirmó (ACK de enlace).
+   * @return false en radios sin ACK (LoRa, XBee AT): su true solo dice que salió al aire.
+   */
+  virtual bool confirmaEntrega() const { return false; }
   
   virtual bool despertar() { return true; }
 
-  // --- Sobrecargas para facilitar el uso ---
+  /**
+   * @brief Métricas del enlace: RSSI/SNR último y promedio, tiempo en aire, fallos,
+   * reintentos, errores de CRC y descartes de cola. Sin copia ni heap.
+   * @return Las del radio, o todo en 0 si el radio no las lleva.
+   */
+  virtual const LinkStats& estadisticasEnlace() const {
+    static const LinkStats vacio;
+    return vacio;
+  }
+
+  // --- API sin copias (buffers del llamador) ---
+
+  /**
+   * @brief Envía cabecera + datos como un solo paquete sin unirlos antes en RAM.
+   * La versión por defecto los une en la pila (hasta 64 bytes); los radios la
+   * reemplazan escribiendo los dos segmentos directo al FIFO/UART.
+   */
+  virtual bool enviar(const uint8_t* cabecera, size_t longCabecera,
+                      const uint8_t* datos, size_t longDatos) {
+    uint8_t unido[64];
+    if (longCabecera + longDatos > sizeof(unido)) return false;
+    memcpy(unido, cabecera, longCabecera);
+    memcpy(unido + longCabecera, datos, longDatos);
+    return enviar(unido, longCabecera + longDatos);
+  }
+
+  /**
+   * @brief Copia el siguiente paquete disponible al buffer del llamador.
+   * @return Bytes escritos en buffer.datos (0 si no había nada); buffer.meta trae RSSI/SNR/llegada.
+   */
+  virtual size_t recibirEn(BufferRx& buffer) {
+    buffer.longitud = 0;
+    int disponible = hayDatosDisponibles();
+    if (disponible <= 0) return 0;
+    buffer.longitud = leer(buffer.datos, buffer.capacidad);
+    buffer.meta.rssi_dBm         = obtenerRSSI();
+    buffer.meta.snr_cuartos_dB   = 0;
+    buffer.meta.llegada_ms       = millis();
+    buffer.meta.longitudOriginal = buffer.longitud;
+    return buffer.longitud;
+  }
+
+  // --- Sobrecargas para facilitar el uso (usan String: heap en cada llamada) ---
 
   virtual bool enviar(const String& data) {
     return enviar(reinterpret_cast<const uint8_t*>(data.c_str()), data.length());
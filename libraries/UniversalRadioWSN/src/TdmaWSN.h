@@ -0,0 +1,265 @@
+#ifndef TDMA_WSN_H
+#define TDMA_WSN_H
+
+#include <Arduino.h>
+
+/**
+ * TDMA sincronizado por baliza, independiente del radio (XBee, LoRa, nRF24...): estas
+ * clases solo arman/interpretan la baliza y calculan tiempos; el sketch envía y escucha.
+ *
+ *   baliza  [0xBE][ciclo][tiempo de red, 4 B][slot_ms, 2 B][nSlots][id del slot 0..nSlots-1]
+ *
+ * Un ciclo dura (nSlots + 1)·slot_ms: el primer slot es de la baliza y el slot i
+ * empieza (i + 1)·slot_ms después del inicio de la baliza. El nodo ubica ese inicio
+ * como la llegada menos Cfg::aireBaliza_ms.
+ * Id 0 en el mapa = slot libre: ahí transmiten los nodos que aún no tienen slot y el
+ * coordinador se los asigna en la siguiente baliza. Los ids de nodo van de 1 a 255.
+ *
+ * El nodo mide cuánto se desvía la llegada de cada baliza de su predicción (reloj del
+ * micro, WDT en power-down): el sesgo constante se corrige en las predicciones y el
+ * resto ajusta la guarda; despierta guarda_ms antes de la baliza y transmite guarda_ms
+ * después del inicio de su slot. Sin balizas la guarda crece con cada ciclo y tras
+ * ciclosSinBalizaMax el nodo se declara desincronizado (a escuchar hasta la próxima).
+ */
+const uint8_t TDMA_BALIZA       = 0xBE;
+const uint8_t TDMA_CABECERA     = 9;
+const uint8_t TDMA_SLOT_LIBRE   = 0;
+
+// ================================ COORDINADOR ================================
+
+template <uint8_t MAX_SLOTS = 16>
+class TdmaCoordinador {
+public:
+  static const uint8_t MAX_BALIZA = TDMA_CABECERA + MAX_SLOTS;
+
+  struct Cfg {
+    uint16_t slot_ms           = 250;   // aire de una subida + 2 guardas, con holgura
+    uint8_t  nSlots            = MAX_SLOTS;
+    uint8_t  ciclosInactivoMax = 16;    // sin oír al nodo tantos ciclos, su slot se libera
+  };
+
+  void begin(const Cfg& cfg, uint32_t ahora_ms = millis()) {
+    _cfg = cfg;
+    if (_cfg.nSlots > MAX_SLOTS) _cfg.nSlots = MAX_SLOTS;
+    for (uint8_t i = 0; i < MAX_SLOTS; ++i) { _mapa[i] = TDMA_SLOT_LIBRE; _oido[i] = 0; }
+    _ciclo       = 0;
+    _baliza_ms   = ahora_ms - ciclo_ms();   // la primera baliza sale ya
+  }
+
+  uint32_t ciclo_ms() const { return (uint32_t)_cfg.slot_ms * (_cfg.nSlots + 1); }
+
+  uint32_t msHastaBaliza(uint32_t ahora_ms = millis()) const {
+    int32_t resta = (int32_t)(_baliza_ms + ciclo_ms() - ahora_ms);
+    return resta > 0 ? (uint32_t)resta : 0;
+  }
+
+  /**
+   * Arma la baliza del ciclo que empieza ahora (destino de MAX_BALIZA bytes) y libera
+   * los slots inactivos. El sketch debe enviarla en cuanto msHastaBaliza() llegue a 0.
+   */
+  size_t baliza(uint8_t* destino, uint32_t ahora_ms = millis()) {
+    // Fase fija: si se llamó tarde se conserva la rejilla, salvo que se haya perdido un ciclo entero
+    _baliza_ms += ciclo_ms();
+    if ((int32_t)(ahora_ms - _baliza_ms) >= (int32_t)ciclo_ms()) _baliza_ms = ahora_ms;
+    ++_ciclo;
+    for (uint8_t i = 0; i < _cfg.nSlots; ++i) {
+      if (_mapa[i] != TDMA_SLOT_LIBRE && (uint8_t)(_ciclo - _oido[i]) > _cfg.ciclosInactivoMax)
+        _mapa[i] = TDMA_SLOT_LIBRE;
+    }
+
+    uint32_t tiempo = ahora_ms;
+    destino[0] = TDMA_BALIZA;
+    destino[1] = _ciclo;
+    destino[2] = (uint8_t)(tiempo >> 24);
+    destino[3] = (uint8_t)(tiempo >> 16);
+    destino[4] = (uint8_t)(tiempo >> 8);
+    destino[5] = (uint8_t)tiempo;
+    destino[6] = (uint8_t)(_cfg.slot_ms >> 8);
+    destino[7] = (uint8_t)_cfg.slot_ms;
+    destino[8] = _cfg.nSlots;
+    memcpy(destino + TDMA_CABECERA, _mapa, _cfg.nSlots);
+    return TDMA_CABECERA + _cfg.nSlots;
+  }
+
+  /* Anota que el nodo se oyó y le da slot si no tenía; devuelve el slot o -1 si no hay. */
+  int8_t registrar(uint8_t nodo) {
+    if (nodo == TDMA_SLOT_LIBRE) return -1;
+    int8_t slot = slotDe(nodo);
+    if (slot < 0) {
+      for (uint8_t i = 0; i < _cfg.nSlots && slot < 0; ++i)
+        if (_mapa[i] == TDMA_SLOT_LIBRE) { _mapa[i] = nodo; slot = (int8_t)i; }
+      if (slot < 0) return -1;
+    }
+    _oido[slot] = _ciclo;
+    return slot;
+  }
+
+  void liberar(uint8_t nodo) {
+    int8_t slot = slotDe(nodo);
+    if (slot >= 0) _mapa[slot] = TDMA_SLOT_LIBRE;
+  }
+
+  int8_t slotDe(uint8_t nodo) const {
+    for (uint8_t i = 0; i < _cfg.nSlots; ++i)
+      if (_mapa[i] == nodo) return (int8_t)i;
+    return -1;
+  }
+
+  /* Slot en curso según el reloj del coordinador (-1 = slot de baliza). Para diagnóstico:
+   * un nodo que llega fuera de su slot tiene la guarda corta o perdió la sincronía. */
+  int8_t slotEnCurso(uint32_t ahora_ms = millis()) const {
+    uint32_t dentro = (ahora_ms - _baliza_ms) % ciclo_ms();
+    return (int8_t)(dentro / _cfg.slot_ms) - 1;
+  }
+
+  uint8_t ciclo() const       { return _ciclo; }
+  uint8_t ocupados() const {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < _cfg.nSlots; ++i) if (_mapa[i] != TDMA_SLOT_LIBRE) ++n;
+    return n;
+  }
+
+private:
+  Cfg      _cfg;
+  uint8_t  _mapa[MAX_SLOTS];
+  uint8_t  _oido[MAX_SLOTS];   // ciclo en que se oyó por última vez a cada slot
+  uint8_t  _ciclo     = 0;
+  uint32_t _baliza_ms = 0;
+};
+
+// =================================== NODO ===================================
+
+class TdmaNodo {
+public:
+  struct Cfg {
+    uint8_t  nodo               = 1;
+    uint16_t aireBaliza_ms      = 0;    // la baliza se oye al terminar: se resta para ubicar los slots
+    uint16_t guardaMin_ms       = 4;    // piso: resolución de millis() + latencia del radio
+    uint8_t  ciclosSinBalizaMax = 4;
+  };
+
+  static const uint32_t NUNCA = 0xFFFFFFFFUL;
+
+  void begin(const Cfg& cfg) {
+    _cfg = cfg;
+    _sincronizado    = false;
+    _ciclosSinBaliza = 0;
+    _sesgo8 = _deriva8 = 0;
+  }
+
+  /**
+   * Pasa aquí lo recibido con su hora de llegada (BufferRx::meta.llegada_ms, o now() del
+   * SchedulerWSN si el nodo duerme). Devuelve true si era una baliza.
+   */
+  bool procesar(const uint8_t* datos, size_t longitud, uint32_t llegada_ms) {
+    if (longitud < TDMA_CABECERA || datos[0] != TDMA_BALIZA) return false;
+    uint8_t nSlots = datos[8];
+    if (longitud < (size_t)TDMA_CABECERA + nSlots) return false;
+
+    if (_sincronizado) {
+      // Error contra la predicción, por ciclo: el sesgo (reloj rápido/lento) se corrige en
+      // las predicciones y solo lo que queda (jitter) ensancha la guarda
+      uint8_t ciclos = (uint8_t)(datos[1] - _cicloRed);
+      if (ciclos == 0) ciclos = 1;
+      int32_t error    = (int32_t)(llegada_ms - (_baliza_ms + ciclos * cicloLocal_ms()));
+      int32_t porCiclo = error * 8 / ciclos;
+      _sesgo8  += porCiclo / 4;                                            // EWMA 1/4
+      _deriva8 += ((porCiclo < 0 ? -porCiclo : porCiclo) - _deriva8) / 4;  // 3 bits de fracción
+    }
+    _cicloRed  = datos[1];
+    _tiempoRed = ((uint32_t)datos[2] << 24) | ((uint32_t)datos[3] << 16) | ((uint32_t)datos[4] << 8) | datos[5];
+    _slot_ms   = (uint16_t)((datos[6] << 8) | datos[7]);
+    _nSlots    = nSlots;
+    _baliza_ms = llegada_ms;
+    _sincronizado    = true;
+    _ciclosSinBaliza = 0;
+
+    _slot = -1;
+    uint8_t libres = 0;
+    for (uint8_t i = 0; i < nSlots; ++i) {
+      if (datos[TDMA_CABECERA + i] == _cfg.nodo) _slot = (int8_t)i;
+      else if (datos[TDMA_CABECERA + i] == TDMA_SLOT_LIBRE) ++libres;
+    }
+    // Sin slot propio: uno libre al azar para pedirlo (menos choques entre recién llegados)
+    _slotContencion = -1;
+    if (_slot < 0 && libres > 0) {
+      uint8_t elegido = (uint8_t)random(libres);
+      for (uint8_t i = 0; i < nSlots; ++i)
+        if (datos[TDMA_CABECERA + i] == TDMA_SLOT_LIBRE && elegido-- == 0) { _slotContencion = (int8_t)i; break; }
+    }
+    return true;
+  }
+
+  /* Se cerró la ventana de escucha sin baliza: se sigue con la predicción un ciclo más. */
+  void balizaPerdida() {
+    if (_sincronizado && ++_ciclosSinBaliza > _cfg.ciclosSinBalizaMax) _sincronizado = false;
+  }
+
+  /* Guarda actual: 2× el jitter medido por cada ciclo a ciegas, con piso y sin pasar de 1/4 de slot. */
+  uint16_t guarda_ms() const {
+    uint32_t g = _cfg.guardaMin_ms + ((uint32_t)_deriva8 * 2UL * (_ciclosSinBaliza + 1) + 7) / 8;
+    uint16_t techo = (uint16_t)max((uint16_t)(_slot_ms / 4), _cfg.guardaMin_ms);
+    return (uint16_t)min(g, (uint32_t)techo);
+  }
+
+  /* ms hasta abrir la ventana de la próxima baliza: una guarda antes de que empiece su
+   * preámbulo. _baliza_ms es la llegada (fin del paquete), por eso se resta el aire; si
+   * no, el receptor abriría a mitad de la baliza y nunca la engancharía. */
+  uint32_t msHastaBaliza(uint32_t ahora_ms = millis()) const {
+    return restante(balizaPrevista() + cicloLocal_ms() - _cfg.aireBaliza_ms - guarda_ms(), ahora_ms);
+  }
+
+  /* Cuánto dejar abierta esa ventana: dos guardas más el aire de la baliza. */
+  uint32_t ventanaBaliza_ms() const { return 2UL * guarda_ms() + _cfg.aireBaliza_ms; }
+
+  /* ms hasta transmitir en el slot propio (o en el de contención); NUNCA sin sincronía ni slot. */
+  uint32_t msHastaSlot(uint32_t ahora_ms = millis()) const {
+    int8_t slot = _slot >= 0 ? _slot : _slotContencion;
+    if (!_sincronizado || slot < 0) return NUNCA;
+    uint32_t inicio = balizaPrevista() - _cfg.aireBaliza_ms
+                    + escalar((uint32_t)(slot + 1) * _slot_ms) + guarda_ms();
+    if ((int32_t)(inicio - ahora_ms) < 0) inicio += cicloLocal_ms();   // el de este ciclo ya pasó
+    return restante(inicio, ahora_ms);
+  }
+
+  /* ¿Cabe una subida de aire_ms en el slot con las guardas actuales? */
+  bool cabe(uint32_t aire_ms) const { return aire_ms + 2UL * guarda_ms() <= _slot_ms; }
+
+  /* Tiempo del coordinador estimado con el reloj local (marca de tiempo común a la red). */
+  uint32_t tiempoRed(uint32_t ahora_ms = millis()) const { return _tiempoRed + (ahora_ms - _baliza_ms); }
+
+  bool     sincronizado() const    { return _sincronizado; }
+  int8_t   slot() const            { return _slot; }             // -1 = sin slot (contención)
+  bool     enContencion() const    { return _slot < 0 && _slotContencion >= 0; }
+  uint32_t ciclo_ms() const        { return (uint32_t)_slot_ms * (_nSlots + 1); }
+  int16_t  sesgo_ms() const        { return (int16_t)(_sesgo8 / 8); }   // reloj local vs. red, por ciclo
+  uint16_t deriva_ms() const       { return (uint16_t)((_deriva8 + 4) / 8); }
+  uint8_t  ciclosSinBaliza() const { return _ciclosSinBaliza; }
+
+private:
+  Cfg      _cfg;
+  bool     _sincronizado = false;
+  int8_t   _slot = -1, _slotContencion = -1;
+  uint8_t  _nSlots = 0, _cicloRed = 0, _ciclosSinBaliza = 0;
+  uint16_t _slot_ms = 0;
+  uint32_t _baliza_ms = 0;     // llegada de la última baliza oída, reloj local
+  uint32_t _tiempoRed = 0;
+  int32_t  _sesgo8 = 0;        // ms por ciclo con 3 bits de fracción: > 0 = el reloj local adelanta
+  int32_t  _deriva8 = 0;       // |error| residual por ciclo, mismo formato
+
+  uint32_t cicloLocal_ms() const { return ciclo_ms() + _sesgo8 / 8; }
+
+  // Un intervalo de la red medido con el reloj local
+  uint32_t escalar(uint32_t ms) const {
+    return ciclo_ms() ? ms + (int32_t)((int64_t)ms * (_sesgo8 / 8) / (int32_t)ciclo_ms()) : ms;
+  }
+
+  uint32_t balizaPrevista() const { return _baliza_ms + (uint32_t)_ciclosSinBaliza * cicloLocal_ms(); }
+
+  static uint32_t restante(uint32_t instante, uint32_t ahora_ms) {
+    int32_t resta = (int32_t)(instante - ahora_ms);
+    return resta > 0 ? (uint32_t)resta : 0;
+  }
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef UNIVERSAL_RADIO_H
+#define UNIVERSAL_RADIO_H
+
+#include "RadioBase.h"
+
+/**
+ * Radio elegido en compilación: UniversalRadio<LoraRadio> o UniversalRadio<XBeeRadio>.
+ * Es directamente el backend del radio (sin RadioInterface), así que se declara como
+ * objeto global con los mismos argumentos que el constructor de R y cada llamada es
+ * directa. Para elegir el radio en tiempo de ejecución usar RadioInterface* + new R(...).
+ */
+template <class R>
+class UniversalRadio : public R::Backend {
+public:
+  typedef typename R::Backend Backend;
+
+  template <typename... Args>
+  explicit UniversalRadio(Args&&... args) : Backend(static_cast<Args&&>(args)...) {}
+};
+
+#endif
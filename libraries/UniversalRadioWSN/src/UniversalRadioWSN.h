@@ -3,7 +3,16 @@
 
 // Este archivo incluye todas las partes de la librería.
 #include "RadioInterface.h"
+#include "RadioBase.h"
+#include "RadioAdaptador.h"
+#include "UniversalRadio.h"
+#include "LoraTiempoAire.h"
 #include "LoraRadio.h"
+#include "LoraAdr.h"
+#include "LoraTxAsincrono.h"
+#include "LoraRxAnillo.h"
 #include "XbeeRadio.h"
+#include "BondedRadio.h"
+#include "TdmaWSN.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,176 @@
+#pragma once
+#include <XBee.h>
+#include "RadioBase.h"
+#include "RadioAdaptador.h"
+#include "XbeeRadio.h"
+
+/**
+ * XBee 802.15.4 (Serie 1) en modo API (AP=1) sobre la librería XBee-Arduino.
+ * A diferencia de XBeeRadio (modo AT), cada paquete es un frame con longitud propia:
+ * los datos binarios no necesitan '\n', se conoce la dirección y el RSSI de quien
+ * envió y el módulo confirma cada envío con un TX Status que llega después.
+ *  - enviar() arma un Tx16Request (o Tx64Request si se fijó destino de 64 bits) y
+ *    vuelve sin esperar: el estado llega al callback de onEstadoTx() desde hayDatosDisponibles().
+ *  - Los datos recibidos se leen del buffer interno de la librería, sin copia intermedia;
+ *    son válidos hasta la siguiente llamada a hayDatosDisponibles()/leer().
+ */
+class XBeeApiBackend : public RadioBase<XBeeApiBackend> {
+public:
+  // estado: SUCCESS (0), NO_ACK (1), CCA_FAILURE (2), PURGED (3)
+  typedef void (*AlEstadoTx)(uint8_t frameId, uint8_t estado, void* ctx);
+
+  using RadioBase<XBeeApiBackend>::enviar;
+
+  XBeeApiBackend(Stream& puerto, int8_t pinSleepRq = -1, int8_t pinOnSleep = -1)
+    : _puertoSerial(puerto), _pinSleepRq(pinSleepRq), _pinOnSleep(pinOnSleep) {}
+
+  bool iniciar() {
+    _xbee.setSerial(_puertoSerial);
+    if (_pinSleepRq >= 0) { pinMode(_pinSleepRq, OUTPUT); digitalWrite(_pinSleepRq, HIGH); }
+    if (_pinOnSleep >= 0)   pinMode(_pinOnSleep, INPUT);
+    return true;
+  }
+
+  bool dormir() {
+    if (_pinSleepRq >= 0) digitalWrite(_pinSleepRq, LOW);
+    return xbeeEsperarPin(_pinOnSleep, LOW, 200);
+  }
+
+  bool despertar() {
+    if (_pinSleepRq >= 0) digitalWrite(_pinSleepRq, HIGH);
+    return xbeeEsperarPin(_pinOnSleep, HIGH, 200);
+  }
+
+  // --- Direccionamiento ---
+  void setDestino(uint16_t direccion16) { _destino16 = direccion16; _destinoEs64 = false; }
+  void setDestino64(uint32_t msb, uint32_t lsb) { _destino64 = XBeeAddress64(msb, lsb); _destinoEs64 = true; }
+  void onEstadoTx(AlEstadoTx alEstado, void* ctx = nullptr) { _alEstado = alEstado; _ctxEstado = ctx; }
+
+  bool enviar(const uint8_t* buffer, size_t longitud) {
+    if (longitud > MAX_DATOS_TX) return false;
+    if (++_frameId == NO_RESPONSE_FRAME_ID) ++_frameId;    // 0 desactiva el TX Status
+    uint8_t* datos = const_cast<uint8_t*>(buffer);          // la librería no lo modifica
+    if (_destinoEs64) {
+      Tx64Request req(_destino64, ACK_OPTION, datos, (uint8_t)longitud, _frameId);
+      _xbee.send(req);
+    } else {
+      Tx16Request req(_destino16, ACK_OPTION, datos, (uint8_t)longitud, _frameId);
+      _xbee.send(req);
+    }
+    ++_enviados;
+    // 802.15.4 a 250 kbps = 32 µs/byte; PHY 6 + MAC 11 bytes (+12 con direcciones de 64 bits)
+    _stats.sumarAire((uint32_t)(longitud + 17 + (_destinoEs64 ? 12 : 0)) * 32UL);
+    return true;
+  }
+
+  int hayDatosDisponibles() {
+    if (_rxLongitud > 0) return _rxLongitud;
+    _xbee.readPacket();                        // no bloquea: consume lo que haya en el UART
+    XBeeResponse& resp = _xbee.getResponse();
+    if (resp.isError()) {                      // visible solo hasta el siguiente readPacket()
+      if (resp.getErrorCode() == CHECKSUM_FAILURE) ++_stats.errorCrc;
+      else if (resp.getErrorCode() == PACKET_EXCEEDS_BYTE_ARRAY_LENGTH) ++_stats.descartesCola;
+      return 0;
+    }
+    if (!resp.isAvailable()) return 0;
+
+    switch (resp.getApiId()) {
+      case RX_16_RESPONSE:
+        resp.getRx16Response(_rx16);
+        tomarRx(_rx16, _rx16.getRemoteAddress16());
+        _rxOrigenEs64 = false;
+        break;
+      case RX_64_RESPONSE:
+        resp.getRx64Response(_rx64);
+        tomarRx(_rx64, (uint16_t)_rx64.getRemoteAddress64().getLsb());
+        _rxOrigen64   = _rx64.getRemoteAddress64();
+        _rxOrigenEs64 = true;
+        break;
+      case TX_STATUS_RESPONSE: {
+        resp.getTxStatusResponse(_txStatus);
+        uint8_t estado = _txStatus.getStatus();
+        if (estado == SUCCESS) ++_entregados; else ++_fallidos;
+        _stats.registrarTx(estado == SUCCESS, 0);   // NO_ACK / CCA_FAILURE cuentan como fallo
+        if (_alEstado) _alEstado(_txStatus.getFrameId(), estado, _ctxEstado);
+        break;
+      }
+      default:
+        break;                                 // modem status, AT response, etc.
+    }
+    return _rxLongitud;
+  }
+
+  size_t leer(uint8_t* buffer, size_t maxLongitud) {
+    if (hayDatosDisponibles() <= 0) return 0;
+    size_t n = min((size_t)_rxLongitud, maxLongitud);
+    memcpy(buffer, _rxDatos, n);
+    _rxLongitud = 0;
+    _stats.registrarRx((int16_t)obtenerRSSI());
+    return n;
+  }
+
+  size_t recibirEn(BufferRx& buffer) {
+    buffer.longitud = 0;
+    int disponible = hayDatosDisponibles();
+    if (disponible <= 0) return 0;
+    buffer.meta.longitudOriginal = (size_t)disponible;
+    buffer.meta.rssi_dBm         = obtenerRSSI();
+    buffer.meta.snr_cuartos_dB   = 0;
+    buffer.meta.llegada_ms       = millis();
+    buffer.meta.origen           = _rxOrigen16;
+    buffer.longitud = leer(buffer.datos, buffer.capacidad);
+    return buffer.longitud;
+  }
+
+  int obtenerRSSI() { return -(int)_rxRssi; }   // el frame trae -dBm
+
+  // --- Datos del último paquete recibido ---
+  uint16_t origen16() const       { return _rxOrigen16; }   // MY del emisor (o LSB de su dirección de 64 bits)
+  bool     origenEs64() const     { return _rxOrigenEs64; }
+  XBeeAddress64& origen64()       { return _rxOrigen64; }
+
+  // --- Estadísticas de TX ---
+  uint8_t  ultimoFrameId() const  { return _frameId; }
+  uint16_t enviados() const       { return _enviados; }
+  uint16_t entregados() const     { return _entregados; }
+  uint16_t fallidos() const       { return _fallidos; }
+
+private:
+  static const uint8_t MAX_DATOS_TX = 100;   // límite de RF del 802.15.4
+
+  Stream&  _puertoSerial;
+  int8_t   _pinSleepRq, _pinOnSleep;
+  XBee     _xbee;
+
+  uint16_t      _destino16 = 0x0000;         // coordinador por defecto
+  XBeeAddress64 _destino64;
+  bool          _destinoEs64 = false;
+  uint8_t       _frameId = 0;
+  AlEstadoTx    _alEstado = nullptr;
+  void*         _ctxEstado = nullptr;
+  uint16_t      _enviados = 0, _entregados = 0, _fallidos = 0;
+
+  Rx16Response     _rx16;
+  Rx64Response     _rx64;
+  TxStatusResponse _txStatus;
+  const uint8_t*   _rxDatos = nullptr;       // apunta al buffer de la librería
+  uint8_t          _rxLongitud = 0;
+  uint8_t          _rxRssi = 0;
+  uint16_t         _rxOrigen16 = 0;
+  XBeeAddress64    _rxOrigen64;
+  bool             _rxOrigenEs64 = false;
+
+  void tomarRx(RxResponse& rx, uint16_t origen16) {
+    _rxDatos    = rx.getData();
+    _rxLongitud = rx.getDataLength();
+    _rxRssi     = rx.getRssi();
+    _rxOrigen16 = origen16;
+  }
+};
+
+// Versión polimórfica (RadioInterface) para gateways: radio = new XBeeApiRadio(Serial2)
+class XBeeApiRadio : public RadioAdaptador<XBeeApiBackend> {
+public:
+  XBeeApiRadio(Stream& puerto, int8_t pinSleepRq = -1, int8_t pinOnSleep = -1)
+    : RadioAdaptador<XBeeApiBackend>(puerto, pinSleepRq, pinOnSleep) {}
+};
@@ -1,64 +1,98 @@
 #pragma once
-#include "RadioInterface.h"
+#include "RadioBase.h"
+#include "RadioAdaptador.h"
 #include <Stream.h>
 
-class XBeeRadio : public RadioInterface {
+// Espera a que ON/SLEEP llegue al nivel pedido; sin pin conectado (-1) no hay nada que esperar
+inline bool xbeeEsperarPin(int8_t pin, uint8_t estadoDeseado, uint16_t timeout_ms) {
+  if (pin < 0) return true;
+  uint32_t tiempoInicio = millis();
+  while (millis() - tiempoInicio < timeout_ms) {
+    if (digitalRead(pin) == estadoDeseado) {
+      return true;
+    }
+    delay(1);
+  }
+  return false;
+}
+
+// Implementación sin virtuales; la usan UniversalRadio<XBeeRadio> y XBeeRadio
+class XBeeBackend : public RadioBase<XBeeBackend> {
 private:
   Stream& _puertoSerial;
   long _baudios;
   int8_t _pinSleepRq;
   int8_t _pinOnSleep;
 
-  bool _esperarEstadoPin(uint8_t pin, uint8_t estadoDeseado, uint16_t timeout_ms) {
-    uint32_t tiempoInicio = millis();
-    while (millis() - tiempoInicio < timeout_ms) {
-      if (digitalRead(pin) == estadoDeseado) {
-        return true;
-      }
-      delay(1);
-    }
-    return false;
+  bool _esperarEstadoPin(int8_t pin, uint8_t estadoDeseado, uint16_t timeout_ms) {
+    return xbeeEsperarPin(pin, estadoDeseado, timeout_ms);
+  }
+
+  // Modo AT sin ACK visible: "enviado" = aceptado por el UART; el aire es el UART a 8N1
+  void registrarTx(size_t escritos, size_t pedidos) {
+    uint32_t aire_us = _baudios > 0 ? (uint32_t)escritos * (10000000UL / (uint32_t)_baudios) : 0;
+    _stats.registrarTx(escritos == pedidos, aire_us);
   }
 
 public:
-  XBeeRadio(Stream& puerto, long baudios, int8_t pinSleepRq, int8_t pinOnSleep)
+  using RadioBase<XBeeBackend>::enviar;
+
+  XBeeBackend(Stream& puerto, long baudios, int8_t pinSleepRq, int8_t pinOnSleep)
     : _puertoSerial(puerto),
       _baudios(baudios),
       _pinSleepRq(pinSleepRq),
       _pinOnSleep(pinOnSleep) {}
 
-  bool iniciar() override {
+  bool iniciar() {
     pinMode(_pinSleepRq, OUTPUT);
     pinMode(_pinOnSleep, INPUT);
     digitalWrite(_pinSleepRq, HIGH);
     return true;
   }
 
-  bool dormir() override {
+  bool dormir() {
     digitalWrite(_pinSleepRq, LOW);
     return _esperarEstadoPin(_pinOnSleep, LOW, 200);
   }
 
-  bool despertar() override {
+  bool despertar() {
     digitalWrite(_pinSleepRq, HIGH);
     return _esperarEstadoPin(_pinOnSleep, HIGH, 200);
   }
 
-  bool enviar(const uint8_t* buffer, size_t longitud) override {
+  bool enviar(const uint8_t* buffer, size_t longitud) {
     _puertoSerial.flush();
     size_t bytesEscritos = _puertoSerial.write(buffer, longitud);
+    registrarTx(bytesEscritos, longitud);
     return bytesEscritos == longitud;
   }
 
-  int hayDatosDisponibles() override {
+  // En modo AT el paquete es el flujo de bytes: basta con escribir los dos segmentos seguidos
+  bool enviar(const uint8_t* cabecera, size_t longCabecera, const uint8_t* datos, size_t longDatos) {
+    _puertoSerial.flush();
+    size_t bytesEscritos = _puertoSerial.write(cabecera, longCabecera);
+    bytesEscritos += _puertoSerial.write(datos, longDatos);
+    registrarTx(bytesEscritos, longCabecera + longDatos);
+    return bytesEscritos == longCabecera + longDatos;
+  }
+
+  int hayDatosDisponibles() {
     return _puertoSerial.available();
   }
 
-  size_t leer(uint8_t* buffer, size_t maxLongitud) override {
+  size_t leer(uint8_t* buffer, size_t maxLongitud) {
     size_t bytesLeidos = _puertoSerial.readBytesUntil('\n', buffer, maxLongitud - 1);
     buffer[bytesLeidos] = '\0';
+    if (bytesLeidos > 0) _stats.registrarRx(0);   // en modo AT no hay RSSI por paquete
     return bytesLeidos;
   }
 
   // El método leerComoString() se ha eliminado para usar la versión de la clase base.
+};
+
+// Versión polimórfica (RadioInterface) para gateways: radio = new XBeeRadio(puerto, ...)
+class XBeeRadio : public RadioAdaptador<XBeeBackend> {
+public:
+  XBeeRadio(Stream& puerto, long baudios, int8_t pinSleepRq, int8_t pinOnSleep)
+    : RadioAdaptador<XBeeBackend>(puerto, baudios, pinSleepRq, pinOnSleep) {}
 };
\ No newline at end of file